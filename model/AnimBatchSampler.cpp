@@ -0,0 +1,198 @@
+#include "AnimBatchSampler.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ANIM_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ANIM_SIMD_SSE2
+#endif
+
+namespace {
+  /* scalar versions, also used for the remaining elements */
+  void lerpScalar(const float* a, const float* b, float t, float* result,
+                  size_t start, size_t count) {
+    for (size_t i = start; i < count; ++i) {
+      result[i] = a[i] * (1.0f - t) + b[i] * t;
+    }
+  }
+
+  void nlerpScalar(const float* a, const float* b, size_t stride, float t,
+                   float* result, size_t start, size_t count) {
+    for (size_t i = start; i < count; ++i) {
+      float bx = b[i];
+      float by = b[stride + i];
+      float bz = b[2 * stride + i];
+      float bw = b[3 * stride + i];
+
+      /* take the shortest path */
+      float cosTheta = a[i] * bx + a[stride + i] * by +
+                       a[2 * stride + i] * bz + a[3 * stride + i] * bw;
+      if (cosTheta < 0.0f) {
+        bx = -bx;
+        by = -by;
+        bz = -bz;
+        bw = -bw;
+      }
+
+      float x = a[i] * (1.0f - t) + bx * t;
+      float y = a[stride + i] * (1.0f - t) + by * t;
+      float z = a[2 * stride + i] * (1.0f - t) + bz * t;
+      float w = a[3 * stride + i] * (1.0f - t) + bw * t;
+
+      float length = std::sqrt(x * x + y * y + z * z + w * w);
+      float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+
+      result[i] = x * invLength;
+      result[stride + i] = y * invLength;
+      result[2 * stride + i] = z * invLength;
+      result[3 * stride + i] = w * invLength;
+    }
+  }
+}
+
+void AnimBatchSampler::lerp(const float* a, const float* b, float t,
+                            float* result, size_t count) {
+  size_t i = 0;
+
+#if defined(ANIM_SIMD_AVX2)
+  const __m256 t1 = _mm256_set1_ps(t);
+  const __m256 t0 = _mm256_set1_ps(1.0f - t);
+  for (; i + 8 <= count; i += 8) {
+    __m256 va = _mm256_loadu_ps(a + i);
+    __m256 vb = _mm256_loadu_ps(b + i);
+    _mm256_storeu_ps(result + i,
+                     _mm256_add_ps(_mm256_mul_ps(va, t0), _mm256_mul_ps(vb, t1)));
+  }
+#elif defined(ANIM_SIMD_SSE2)
+  const __m128 t1 = _mm_set1_ps(t);
+  const __m128 t0 = _mm_set1_ps(1.0f - t);
+  for (; i + 4 <= count; i += 4) {
+    __m128 va = _mm_loadu_ps(a + i);
+    __m128 vb = _mm_loadu_ps(b + i);
+    _mm_storeu_ps(result + i,
+                  _mm_add_ps(_mm_mul_ps(va, t0), _mm_mul_ps(vb, t1)));
+  }
+#endif
+
+  lerpScalar(a, b, t, result, i, count);
+}
+
+void AnimBatchSampler::nlerp(const float* a, const float* b, size_t stride,
+                             float t, float* result, size_t count) {
+  size_t i = 0;
+
+#if defined(ANIM_SIMD_AVX2)
+  const __m256 t1 = _mm256_set1_ps(t);
+  const __m256 t0 = _mm256_set1_ps(1.0f - t);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  for (; i + 8 <= count; i += 8) {
+    __m256 ax = _mm256_loadu_ps(a + i);
+    __m256 ay = _mm256_loadu_ps(a + stride + i);
+    __m256 az = _mm256_loadu_ps(a + 2 * stride + i);
+    __m256 aw = _mm256_loadu_ps(a + 3 * stride + i);
+    __m256 bx = _mm256_loadu_ps(b + i);
+    __m256 by = _mm256_loadu_ps(b + stride + i);
+    __m256 bz = _mm256_loadu_ps(b + 2 * stride + i);
+    __m256 bw = _mm256_loadu_ps(b + 3 * stride + i);
+
+    /* flip the second quaternion where the dot product is negative */
+    __m256 cosTheta = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)),
+        _mm256_add_ps(_mm256_mul_ps(az, bz), _mm256_mul_ps(aw, bw)));
+    __m256 flip =
+        _mm256_and_ps(_mm256_cmp_ps(cosTheta, zero, _CMP_LT_OQ), signMask);
+    bx = _mm256_xor_ps(bx, flip);
+    by = _mm256_xor_ps(by, flip);
+    bz = _mm256_xor_ps(bz, flip);
+    bw = _mm256_xor_ps(bw, flip);
+
+    __m256 x = _mm256_add_ps(_mm256_mul_ps(ax, t0), _mm256_mul_ps(bx, t1));
+    __m256 y = _mm256_add_ps(_mm256_mul_ps(ay, t0), _mm256_mul_ps(by, t1));
+    __m256 z = _mm256_add_ps(_mm256_mul_ps(az, t0), _mm256_mul_ps(bz, t1));
+    __m256 w = _mm256_add_ps(_mm256_mul_ps(aw, t0), _mm256_mul_ps(bw, t1));
+
+    /* full precision sqrt and division, rsqrt is not accurate enough here */
+    __m256 length = _mm256_sqrt_ps(_mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+        _mm256_add_ps(_mm256_mul_ps(z, z), _mm256_mul_ps(w, w))));
+    __m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+    __m256 invLength = _mm256_and_ps(
+        _mm256_div_ps(_mm256_set1_ps(1.0f), length), valid);
+
+    _mm256_storeu_ps(result + i, _mm256_mul_ps(x, invLength));
+    _mm256_storeu_ps(result + stride + i, _mm256_mul_ps(y, invLength));
+    _mm256_storeu_ps(result + 2 * stride + i, _mm256_mul_ps(z, invLength));
+    _mm256_storeu_ps(result + 3 * stride + i, _mm256_mul_ps(w, invLength));
+  }
+#elif defined(ANIM_SIMD_SSE2)
+  const __m128 t1 = _mm_set1_ps(t);
+  const __m128 t0 = _mm_set1_ps(1.0f - t);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  for (; i + 4 <= count; i += 4) {
+    __m128 ax = _mm_loadu_ps(a + i);
+    __m128 ay = _mm_loadu_ps(a + stride + i);
+    __m128 az = _mm_loadu_ps(a + 2 * stride + i);
+    __m128 aw = _mm_loadu_ps(a + 3 * stride + i);
+    __m128 bx = _mm_loadu_ps(b + i);
+    __m128 by = _mm_loadu_ps(b + stride + i);
+    __m128 bz = _mm_loadu_ps(b + 2 * stride + i);
+    __m128 bw = _mm_loadu_ps(b + 3 * stride + i);
+
+    /* flip the second quaternion where the dot product is negative */
+    __m128 cosTheta =
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                   _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    __m128 flip = _mm_and_ps(_mm_cmplt_ps(cosTheta, zero), signMask);
+    bx = _mm_xor_ps(bx, flip);
+    by = _mm_xor_ps(by, flip);
+    bz = _mm_xor_ps(bz, flip);
+    bw = _mm_xor_ps(bw, flip);
+
+    __m128 x = _mm_add_ps(_mm_mul_ps(ax, t0), _mm_mul_ps(bx, t1));
+    __m128 y = _mm_add_ps(_mm_mul_ps(ay, t0), _mm_mul_ps(by, t1));
+    __m128 z = _mm_add_ps(_mm_mul_ps(az, t0), _mm_mul_ps(bz, t1));
+    __m128 w = _mm_add_ps(_mm_mul_ps(aw, t0), _mm_mul_ps(bw, t1));
+
+    /* full precision sqrt and division, rsqrt is not accurate enough here */
+    __m128 length = _mm_sqrt_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                   _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+    __m128 valid = _mm_cmpgt_ps(length, zero);
+    __m128 invLength =
+        _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), length), valid);
+
+    _mm_storeu_ps(result + i, _mm_mul_ps(x, invLength));
+    _mm_storeu_ps(result + stride + i, _mm_mul_ps(y, invLength));
+    _mm_storeu_ps(result + 2 * stride + i, _mm_mul_ps(z, invLength));
+    _mm_storeu_ps(result + 3 * stride + i, _mm_mul_ps(w, invLength));
+  }
+#endif
+
+  nlerpScalar(a, b, stride, t, result, i, count);
+}
+
+unsigned int AnimBatchSampler::getLaneCount() {
+#if defined(ANIM_SIMD_AVX2)
+  return 8;
+#elif defined(ANIM_SIMD_SSE2)
+  return 4;
+#else
+  return 1;
+#endif
+}
+
+const char* AnimBatchSampler::getInstructionSetName() {
+#if defined(ANIM_SIMD_AVX2)
+  return "AVX2";
+#elif defined(ANIM_SIMD_SSE2)
+  return "SSE2";
+#else
+  return "Scalar";
+#endif
+}
@@ -0,0 +1,19 @@
+/* SIMD kernels for the batch pose sampling of packed clips */
+#pragma once
+
+#include <cstddef>
+
+class AnimBatchSampler {
+  public:
+    /* result[i] = a[i] * (1 - t) + b[i] * t */
+    static void lerp(const float* a, const float* b, float t, float* result,
+                     size_t count);
+    /* shortest path normalized lerp of quaternions stored as four streams
+     * (x, y, z, w) with 'stride' floats between the streams */
+    static void nlerp(const float* a, const float* b, size_t stride, float t,
+                      float* result, size_t count);
+
+    /* number of floats processed per instruction */
+    static unsigned int getLaneCount();
+    static const char* getInstructionSetName();
+};
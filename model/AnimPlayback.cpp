@@ -0,0 +1,36 @@
+#include "AnimPlayback.h"
+
+#include <cmath>
+
+void AnimPlayback::updateTime(AssimpAnimClip& animClip,
+                              InstanceSettings& settings,
+                              AnimPlaybackData& playback, float deltaTime) {
+  settings.animPlayTimePos += deltaTime * animClip.getClipTicksPerSecond() *
+                              settings.animSpeedFactor;
+  settings.animPlayTimePos =
+      std::fmod(settings.animPlayTimePos, animClip.getClipDuration());
+
+  if (playback.cursorClipNr != settings.animClipNr) {
+    playback.cursor = AnimClipCursor{};
+    playback.cursorClipNr = settings.animClipNr;
+    playback.poseOutdated = true;
+  }
+}
+
+bool AnimPlayback::shouldSamplePose(const AnimPlaybackData& playback) {
+  return playback.visible && (playback.poseUpdateDue || playback.poseOutdated);
+}
+
+void AnimPlayback::update(AssimpAnimClip& animClip, InstanceSettings& settings,
+                          AnimPlaybackData& playback,
+                          std::vector<NodeTransformData>& nodeTransforms,
+                          float deltaTime) {
+  updateTime(animClip, settings, playback, deltaTime);
+
+  /* animate clip via channels */
+  if (shouldSamplePose(playback)) {
+    animClip.samplePose(settings.animPlayTimePos, playback.cursor,
+                        nodeTransforms);
+    playback.poseOutdated = false;
+  }
+}
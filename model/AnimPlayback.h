@@ -0,0 +1,35 @@
+/* per frame animation step of one instance, kept apart from AssimpInstance
+ * so it runs without a loaded model */
+#pragma once
+
+#include <vector>
+
+#include "AssimpAnimClip.h"
+#include "InstanceSettings.h"
+#include "NodeTransformData.h"
+
+struct AnimPlaybackData {
+  /* keyframe cursor of the current clip */
+  AnimClipCursor cursor{};
+  unsigned int cursorClipNr = 0;
+
+  bool visible = true;
+  bool poseUpdateDue = true;
+  /* set after culling or a clip change, forces a new pose regardless of LOD */
+  bool poseOutdated = false;
+};
+
+class AnimPlayback {
+ public:
+  /* advances the play time, a changed clip starts with a fresh cursor */
+  static void updateTime(AssimpAnimClip& animClip, InstanceSettings& settings,
+                         AnimPlaybackData& playback, float deltaTime);
+  /* culled instances and instances waiting for their LOD step keep the pose */
+  static bool shouldSamplePose(const AnimPlaybackData& playback);
+
+  /* time step plus the CPU pose of the clip in settings.animClipNr */
+  static void update(AssimpAnimClip& animClip, InstanceSettings& settings,
+                     AnimPlaybackData& playback,
+                     std::vector<NodeTransformData>& nodeTransforms,
+                     float deltaTime);
+};
@@ -42,26 +42,71 @@ void AssimpAnimChannel::loadChannelData(aiNodeAnim* nodeAnim) {
                                      nodeAnim->mScalingKeys[i].mValue.z));
   }
 
+  calculateInverseTimeDiffs();
+
+  mPreState = preState;
+  mPostState = postState;
+}
+
+void AssimpAnimChannel::calculateInverseTimeDiffs() {
   /* precalcuate the inverse offset to avoid divisions when scaling the section
    */
-  for (unsigned int i = 0; i < mTranslationTiminngs.size() - 1; ++i) {
+  mInverseTranslationTimeDiffs.clear();
+  mInverseRotationTimeDiffs.clear();
+  mInverseScaleTimeDiffs.clear();
+
+  for (size_t i = 0; i + 1 < mTranslationTiminngs.size(); ++i) {
     mInverseTranslationTimeDiffs.emplace_back(
         1.0f / (mTranslationTiminngs.at(i + 1) - mTranslationTiminngs.at(i)));
   }
-  for (unsigned int i = 0; i < mRotationTiminigs.size() - 1; ++i) {
+  for (size_t i = 0; i + 1 < mRotationTiminigs.size(); ++i) {
     mInverseRotationTimeDiffs.emplace_back(
         1.0f / (mRotationTiminigs.at(i + 1) - mRotationTiminigs.at(i)));
   }
-  for (unsigned int i = 0; i < mScaleTimings.size() - 1; ++i) {
+  for (size_t i = 0; i + 1 < mScaleTimings.size(); ++i) {
     mInverseScaleTimeDiffs.emplace_back(
         1.0f / (mScaleTimings.at(i + 1) - mScaleTimings.at(i)));
   }
+}
 
-  mPreState = preState;
-  mPostState = postState;
+void AssimpAnimChannel::saveToCache(ModelCacheWriter& writer) {
+  writer.writeString(mNodeName);
+  writer.write(mPreState);
+  writer.write(mPostState);
+  writer.write(mBoneId);
+
+  writer.writeVector(mTranslationTiminngs);
+  writer.writeVector(mTranslations);
+  writer.writeVector(mRotationTiminigs);
+  writer.writeVector(mRotations);
+  writer.writeVector(mScaleTimings);
+  writer.writeVector(mScalings);
+}
+
+bool AssimpAnimChannel::loadFromCache(ModelCacheReader& reader) {
+  if (!reader.readString(mNodeName) || !reader.read(mPreState) ||
+      !reader.read(mPostState) || !reader.read(mBoneId) ||
+      !reader.readVector(mTranslationTiminngs) ||
+      !reader.readVector(mTranslations) ||
+      !reader.readVector(mRotationTiminigs) ||
+      !reader.readVector(mRotations) || !reader.readVector(mScaleTimings) ||
+      !reader.readVector(mScalings)) {
+    return false;
+  }
+
+  if (mTranslationTiminngs.size() != mTranslations.size() ||
+      mRotationTiminigs.size() != mRotations.size() ||
+      mScaleTimings.size() != mScalings.size()) {
+    return false;
+  }
+
+  calculateInverseTimeDiffs();
+  return true;
 }
 
-std::string AssimpAnimChannel::getTargetNodeName() { return mNodeName; }
+const std::string& AssimpAnimChannel::getTargetNodeName() {
+  return mNodeName;
+}
 
 float AssimpAnimChannel::getMaxTime() {
   float maxTranslationTime =
@@ -72,13 +117,48 @@ float AssimpAnimChannel::getMaxTime() {
   return std::max(std::max(maxRotationTime, maxTranslationTime), maxScaleTime);
 }
 
+/* returns the index of the key at or before the given time, the cursor is
+ * moved forward from the last position and only reset by a binary search if
+ * the time jumped backwards (wrap-around, seek) or too far ahead */
+unsigned int AssimpAnimChannel::findKeyIndex(const std::vector<float>& timings,
+                                             float time,
+                                             unsigned int* cursorIndex) {
+  if (cursorIndex && timings.size() > 1) {
+    unsigned int timeIndex = *cursorIndex;
+    unsigned int lastIndex = static_cast<unsigned int>(timings.size()) - 2;
+
+    /* same rules as the search below: time must be in (key, nextKey] */
+    if (timeIndex <= lastIndex &&
+        (timeIndex == 0 || timings[timeIndex] < time)) {
+      for (unsigned int i = 0; i < kMaxCursorSteps && timeIndex <= lastIndex;
+           ++i, ++timeIndex) {
+        if (time <= timings[timeIndex + 1]) {
+          *cursorIndex = timeIndex;
+          return timeIndex;
+        }
+      }
+    }
+  }
+
+  auto timeIndexPos = std::lower_bound(timings.begin(), timings.end(), time);
+  /* catch rare cases where time is exaclty zero */
+  unsigned int timeIndex = static_cast<unsigned int>(std::max(
+      static_cast<int>(std::distance(timings.begin(), timeIndexPos)) - 1, 0));
+
+  if (cursorIndex) {
+    *cursorIndex = timeIndex;
+  }
+  return timeIndex;
+}
+
 /* precalculate TRS matrix */
 // glm::mat4 AssimpAnimChannel::getTRSMatrix(float time) {
 //   return glm::translate(glm::mat4_cast(getRotation(time)) *
 //   glm::scale(glm::mat4(1.0f), getScaling(time)), getTranslation(time));
 // }
 
-glm::vec4 AssimpAnimChannel::getTranslation(float time) {
+glm::vec4 AssimpAnimChannel::getTranslation(float time,
+                                            AnimChannelCursor* cursor) {
   if (mTranslations.empty()) {
     return glm::vec4(0.0f);
   }
@@ -120,13 +200,8 @@ glm::vec4 AssimpAnimChannel::getTranslation(float time) {
       break;
   }
 
-  auto timeIndexPos = std::lower_bound(mTranslationTiminngs.begin(),
-                                       mTranslationTiminngs.end(), time);
-  /* catch rare cases where time is exaclty zero */
-  int timeIndex = std::max(static_cast<int>(std::distance(
-                               mTranslationTiminngs.begin(), timeIndexPos)) -
-                               1,
-                           0);
+  unsigned int timeIndex = findKeyIndex(
+      mTranslationTiminngs, time, cursor ? &cursor->translationIndex : nullptr);
 
   float interpolatedTime = (time - mTranslationTiminngs.at(timeIndex)) *
                            mInverseTranslationTimeDiffs.at(timeIndex);
@@ -136,7 +211,8 @@ glm::vec4 AssimpAnimChannel::getTranslation(float time) {
                    1.f);
 }
 
-glm::vec4 AssimpAnimChannel::getScaling(float time) {
+glm::vec4 AssimpAnimChannel::getScaling(float time,
+                                        AnimChannelCursor* cursor) {
   if (mScalings.empty()) {
     return glm::vec4(1.0f);
   }
@@ -178,11 +254,8 @@ glm::vec4 AssimpAnimChannel::getScaling(float time) {
       break;
   }
 
-  auto timeIndexPos =
-      std::lower_bound(mScaleTimings.begin(), mScaleTimings.end(), time);
-  int timeIndex = std::max(
-      static_cast<int>(std::distance(mScaleTimings.begin(), timeIndexPos)) - 1,
-      0);
+  unsigned int timeIndex = findKeyIndex(
+      mScaleTimings, time, cursor ? &cursor->scaleIndex : nullptr);
 
   float interpolatedTime = (time - mScaleTimings.at(timeIndex)) *
                            mInverseScaleTimeDiffs.at(timeIndex);
@@ -191,7 +264,8 @@ glm::vec4 AssimpAnimChannel::getScaling(float time) {
                            interpolatedTime), 1.f);
 }
 
-glm::vec4 AssimpAnimChannel::getRotation(float time) {
+glm::vec4 AssimpAnimChannel::getRotation(float time,
+                                         AnimChannelCursor* cursor) {
   if (mRotations.empty()) {
     return glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
   }
@@ -235,12 +309,8 @@ glm::vec4 AssimpAnimChannel::getRotation(float time) {
       break;
   }
 
-  auto timeIndexPos = std::lower_bound(mRotationTiminigs.begin(),
-                                       mRotationTiminigs.end(), time);
-  int timeIndex = std::max(
-      static_cast<int>(std::distance(mRotationTiminigs.begin(), timeIndexPos)) -
-          1,
-      0);
+  unsigned int timeIndex = findKeyIndex(
+      mRotationTiminigs, time, cursor ? &cursor->rotationIndex : nullptr);
 
   float interpolatedTime = (time - mRotationTiminigs.at(timeIndex)) *
                            mInverseRotationTimeDiffs.at(timeIndex);
@@ -257,3 +327,31 @@ glm::vec4 AssimpAnimChannel::getRotation(float time) {
 int AssimpAnimChannel::getBoneId() { return mBoneId; }
 
 void AssimpAnimChannel::setBoneId(unsigned int id) { mBoneId = id; }
+
+unsigned int AssimpAnimChannel::getPreState() const { return mPreState; }
+
+unsigned int AssimpAnimChannel::getPostState() const { return mPostState; }
+
+const std::vector<float>& AssimpAnimChannel::getTranslationTimings() const {
+  return mTranslationTiminngs;
+}
+
+const std::vector<float>& AssimpAnimChannel::getRotationTimings() const {
+  return mRotationTiminigs;
+}
+
+const std::vector<float>& AssimpAnimChannel::getScaleTimings() const {
+  return mScaleTimings;
+}
+
+const std::vector<glm::vec3>& AssimpAnimChannel::getTranslations() const {
+  return mTranslations;
+}
+
+const std::vector<glm::vec3>& AssimpAnimChannel::getScalings() const {
+  return mScalings;
+}
+
+const std::vector<glm::quat>& AssimpAnimChannel::getRotations() const {
+  return mRotations;
+}
@@ -8,22 +8,54 @@
 #include <string>
 #include <vector>
 
+#include "ModelCache.h"
+
+/* per-instance playback cursor, remembers the last key index of every key type */
+struct AnimChannelCursor {
+  unsigned int translationIndex = 0;
+  unsigned int rotationIndex = 0;
+  unsigned int scaleIndex = 0;
+};
+
 class AssimpAnimChannel {
  public:
   void loadChannelData(aiNodeAnim* nodeAnim);
-  std::string getTargetNodeName();
+  void saveToCache(ModelCacheWriter& writer);
+  bool loadFromCache(ModelCacheReader& reader);
+  const std::string& getTargetNodeName();
   float getMaxTime();
 
   // glm::mat4 getTRSMatrix(float time);
 
-  glm::vec4 getTranslation(float time);
-  glm::vec4 getScaling(float time);
-  glm::vec4 getRotation(float time);
+  /* an optional cursor avoids the binary search for steadily increasing times */
+  glm::vec4 getTranslation(float time, AnimChannelCursor* cursor = nullptr);
+  glm::vec4 getScaling(float time, AnimChannelCursor* cursor = nullptr);
+  glm::vec4 getRotation(float time, AnimChannelCursor* cursor = nullptr);
 
   int getBoneId();
   void setBoneId(unsigned int id);
 
+  /* assimp behaviour before the first and after the last key */
+  unsigned int getPreState() const;
+  unsigned int getPostState() const;
+
+  /* raw key data, used to build the packed clip layout */
+  const std::vector<float>& getTranslationTimings() const;
+  const std::vector<float>& getRotationTimings() const;
+  const std::vector<float>& getScaleTimings() const;
+  const std::vector<glm::vec3>& getTranslations() const;
+  const std::vector<glm::vec3>& getScalings() const;
+  const std::vector<glm::quat>& getRotations() const;
+
+  static unsigned int findKeyIndex(const std::vector<float>& timings,
+                                   float time, unsigned int* cursorIndex);
+
  private:
+  /* number of keys the cursor may advance before falling back to a search */
+  static constexpr unsigned int kMaxCursorSteps = 4;
+
+  void calculateInverseTimeDiffs();
+
   std::string mNodeName;
 
   /* use separate timinigs vectors, just in case not all keys have the same time
@@ -1,4 +1,5 @@
 #include "AssimpAnimClip.h"
+#include "AnimBatchSampler.h"
 #include "Logger.h"
 
 void AssimpAnimClip::addChannels(
@@ -21,10 +22,10 @@ void AssimpAnimClip::addChannels(
     channel->loadChannelData(animation->mChannels[i]);
 
 		/* find the corresponding bone and its index id */
-    std::string targetNodeName = channel->getTargetNodeName();
+    const std::string& targetNodeName = channel->getTargetNodeName();
     const auto bonePos =
         std::find_if(boneList.begin(), boneList.end(),
-                     [targetNodeName](const std::shared_ptr<AssimpBone>& bone) {
+                     [&targetNodeName](const std::shared_ptr<AssimpBone>& bone) {
                        return bone->getBoneName() == targetNodeName;
                      });
 
@@ -34,9 +35,311 @@ void AssimpAnimClip::addChannels(
 
     mAnimChannels.emplace_back(channel);
   }
+
+  buildPackedKeys();
+}
+
+void AssimpAnimClip::saveToCache(ModelCacheWriter& writer) {
+  writer.writeString(mClipName);
+  writer.write(mClipDuration);
+  writer.write(mClipTicksPerSecond);
+
+  writer.write(static_cast<uint32_t>(mAnimChannels.size()));
+  for (const auto& channel : mAnimChannels) {
+    channel->saveToCache(writer);
+  }
+}
+
+bool AssimpAnimClip::loadFromCache(ModelCacheReader& reader) {
+  uint32_t numChannels = 0;
+  if (!reader.readString(mClipName) || !reader.read(mClipDuration) ||
+      !reader.read(mClipTicksPerSecond) || !reader.read(numChannels)) {
+    return false;
+  }
+
+  mAnimChannels.clear();
+  for (uint32_t i = 0; i < numChannels; ++i) {
+    std::shared_ptr<AssimpAnimChannel> channel =
+        std::make_shared<AssimpAnimChannel>();
+    if (!channel->loadFromCache(reader)) {
+      return false;
+    }
+    mAnimChannels.emplace_back(channel);
+  }
+
+  buildPackedKeys();
+  return true;
+}
+
+/* most exporters write all keys of all channels at the same times, store them
+ * as one shared time axis and a single contiguous block per clip */
+void AssimpAnimClip::buildPackedKeys() {
+  mHasPackedKeys = false;
+  mPackedTimings.clear();
+  mPackedInverseTimeDiffs.clear();
+  mPackedBoneIds.clear();
+  mPackedKeys.clear();
+  mPackedMaxBoneId = -1;
+
+  std::vector<std::shared_ptr<AssimpAnimChannel>> packedChannels;
+  for (const auto& channel : mAnimChannels) {
+    /* channels without a bone do not contribute to the pose */
+    if (channel->getBoneId() < 0) {
+      continue;
+    }
+
+    const std::vector<float>& timings = channel->getTranslationTimings();
+    if (timings.size() < 2 || channel->getRotationTimings() != timings ||
+        channel->getScaleTimings() != timings) {
+      Logger::log(1, "%s: clip '%s' has channels with different key times, using per-channel sampling\n",
+                  __FUNCTION__, mClipName.c_str());
+      mPackedTimings.clear();
+      mPackedBoneIds.clear();
+      return;
+    }
+
+    if (mPackedTimings.empty()) {
+      mPackedTimings = timings;
+    } else if (mPackedTimings != timings) {
+      Logger::log(1, "%s: clip '%s' has channels with different key times, using per-channel sampling\n",
+                  __FUNCTION__, mClipName.c_str());
+      mPackedTimings.clear();
+      mPackedBoneIds.clear();
+      return;
+    }
+
+    packedChannels.emplace_back(channel);
+    mPackedBoneIds.emplace_back(channel->getBoneId());
+    mPackedMaxBoneId = std::max(mPackedMaxBoneId, channel->getBoneId());
+  }
+
+  if (packedChannels.empty()) {
+    mPackedTimings.clear();
+    mPackedBoneIds.clear();
+    return;
+  }
+
+  for (size_t i = 0; i < mPackedTimings.size() - 1; ++i) {
+    mPackedInverseTimeDiffs.emplace_back(
+        1.0f / (mPackedTimings.at(i + 1) - mPackedTimings.at(i)));
+  }
+
+  /* round every stream up to full cache lines */
+  const unsigned int floatsPerLine = kCacheLineSize / sizeof(float);
+  mPackedChannelStride =
+      (static_cast<unsigned int>(packedChannels.size()) + floatsPerLine - 1) /
+      floatsPerLine * floatsPerLine;
+  mPackedKeyStride = mPackedChannelStride * kPackedStreams;
+
+  mPackedKeys.resize(mPackedTimings.size() * mPackedKeyStride, 0.0f);
+
+  const unsigned int stride = mPackedChannelStride;
+  for (size_t key = 0; key < mPackedTimings.size(); ++key) {
+    float* keyData = mPackedKeys.data() + key * mPackedKeyStride;
+    for (size_t i = 0; i < packedChannels.size(); ++i) {
+      const glm::vec3& translation = packedChannels.at(i)->getTranslations().at(key);
+      const glm::vec3& scale = packedChannels.at(i)->getScalings().at(key);
+      const glm::quat& rotation = packedChannels.at(i)->getRotations().at(key);
+
+      keyData[i] = translation.x;
+      keyData[stride + i] = translation.y;
+      keyData[2 * stride + i] = translation.z;
+      keyData[3 * stride + i] = scale.x;
+      keyData[4 * stride + i] = scale.y;
+      keyData[5 * stride + i] = scale.z;
+      keyData[6 * stride + i] = rotation.x;
+      keyData[7 * stride + i] = rotation.y;
+      keyData[8 * stride + i] = rotation.z;
+      keyData[9 * stride + i] = rotation.w;
+    }
+  }
+
+  mHasPackedKeys = true;
+  Logger::log(1, "%s: clip '%s' packed, %i keys for %i channels (%i bytes)\n",
+              __FUNCTION__, mClipName.c_str(), mPackedTimings.size(),
+              packedChannels.size(), mPackedKeys.size() * sizeof(float));
+}
+
+bool AssimpAnimClip::hasPackedKeys() {
+  return mHasPackedKeys;
+}
+
+void AssimpAnimClip::appendGpuKeys(size_t numBones,
+    std::vector<AnimChannelGpuData>& channels, std::vector<float>& keyTimes,
+    std::vector<glm::vec4>& keyValues) {
+  size_t firstChannel = channels.size();
+  channels.resize(firstChannel + numBones);
+
+  for (const auto& channel : mAnimChannels) {
+    int boneId = channel->getBoneId();
+    if (boneId < 0 || static_cast<size_t>(boneId) >= numBones) {
+      continue;
+    }
+
+    AnimChannelGpuData& gpuChannel = channels.at(firstChannel + boneId);
+    gpuChannel.preState = channel->getPreState();
+    gpuChannel.postState = channel->getPostState();
+
+    gpuChannel.translationOffset = static_cast<uint32_t>(keyTimes.size());
+    gpuChannel.translationCount =
+        static_cast<uint32_t>(channel->getTranslations().size());
+    keyTimes.insert(keyTimes.end(), channel->getTranslationTimings().begin(),
+                    channel->getTranslationTimings().end());
+    for (const auto& translation : channel->getTranslations()) {
+      keyValues.emplace_back(translation, 1.0f);
+    }
+
+    /* quaternions in the order of the node transform data */
+    gpuChannel.rotationOffset = static_cast<uint32_t>(keyTimes.size());
+    gpuChannel.rotationCount =
+        static_cast<uint32_t>(channel->getRotations().size());
+    keyTimes.insert(keyTimes.end(), channel->getRotationTimings().begin(),
+                    channel->getRotationTimings().end());
+    for (const auto& rotation : channel->getRotations()) {
+      keyValues.emplace_back(rotation.x, rotation.y, rotation.z, rotation.w);
+    }
+
+    gpuChannel.scaleOffset = static_cast<uint32_t>(keyTimes.size());
+    gpuChannel.scaleCount =
+        static_cast<uint32_t>(channel->getScalings().size());
+    keyTimes.insert(keyTimes.end(), channel->getScaleTimings().begin(),
+                    channel->getScaleTimings().end());
+    for (const auto& scale : channel->getScalings()) {
+      keyValues.emplace_back(scale, 1.0f);
+    }
+  }
+}
+
+void AssimpAnimClip::samplePose(float time, AnimClipCursor& cursor,
+    std::vector<NodeTransformData>& nodeTransforms) {
+  std::fill(nodeTransforms.begin(), nodeTransforms.end(), NodeTransformData{});
+
+  /* pre and post states are only handled by the channels */
+  if (mHasPackedKeys && mPackedMaxBoneId < static_cast<int>(nodeTransforms.size()) &&
+      time >= mPackedTimings.front() && time < mPackedTimings.back()) {
+    samplePackedPose(time, cursor, nodeTransforms);
+  } else {
+    sampleChannelPose(time, cursor, nodeTransforms);
+  }
+}
+
+void AssimpAnimClip::samplePoses(const std::vector<float>& times,
+    const std::vector<AnimClipCursor*>& cursors,
+    const std::vector<std::vector<NodeTransformData>*>& nodeTransforms) {
+  if (!mHasPackedKeys) {
+    for (size_t i = 0; i < times.size(); ++i) {
+      samplePose(times.at(i), *cursors.at(i), *nodeTransforms.at(i));
+    }
+    return;
+  }
+
+  /* SoA result of a single pose, kept between the calls of a thread */
+  thread_local std::vector<float, AlignedAllocator<float, kCacheLineSize>> poseStreams;
+  if (poseStreams.size() < mPackedKeyStride) {
+    poseStreams.resize(mPackedKeyStride);
+  }
+
+  const unsigned int stride = mPackedChannelStride;
+  for (size_t i = 0; i < times.size(); ++i) {
+    float time = times.at(i);
+    std::vector<NodeTransformData>& pose = *nodeTransforms.at(i);
+
+    if (mPackedMaxBoneId >= static_cast<int>(pose.size()) ||
+        time < mPackedTimings.front() || time >= mPackedTimings.back()) {
+      samplePose(time, *cursors.at(i), pose);
+      continue;
+    }
+
+    unsigned int timeIndex = AssimpAnimChannel::findKeyIndex(mPackedTimings,
+        time, &cursors.at(i)->keyIndex);
+    float interpolatedTime = (time - mPackedTimings[timeIndex]) *
+                             mPackedInverseTimeDiffs[timeIndex];
+
+    const float* key = mPackedKeys.data() + timeIndex * mPackedKeyStride;
+    const float* nextKey = key + mPackedKeyStride;
+
+    /* translation and scale streams are adjacent, do them in one go */
+    AnimBatchSampler::lerp(key, nextKey, interpolatedTime, poseStreams.data(),
+                           6 * stride);
+    AnimBatchSampler::nlerp(key + 6 * stride, nextKey + 6 * stride, stride,
+                            interpolatedTime, poseStreams.data() + 6 * stride,
+                            stride);
+
+    std::fill(pose.begin(), pose.end(), NodeTransformData{});
+
+    const float* streams = poseStreams.data();
+    for (size_t c = 0; c < mPackedBoneIds.size(); ++c) {
+      NodeTransformData& nodeTransform = pose[mPackedBoneIds[c]];
+      nodeTransform.translation = glm::vec4(streams[c], streams[stride + c],
+                                            streams[2 * stride + c], 1.f);
+      nodeTransform.scale = glm::vec4(streams[3 * stride + c],
+          streams[4 * stride + c], streams[5 * stride + c], 1.f);
+      nodeTransform.rotation = glm::vec4(streams[6 * stride + c],
+          streams[7 * stride + c], streams[8 * stride + c],
+          streams[9 * stride + c]);
+    }
+  }
+}
+
+/* one key lookup for the whole clip, then a linear pass over the streams */
+void AssimpAnimClip::samplePackedPose(float time, AnimClipCursor& cursor,
+    std::vector<NodeTransformData>& nodeTransforms) {
+  unsigned int timeIndex = AssimpAnimChannel::findKeyIndex(mPackedTimings, time,
+      &cursor.keyIndex);
+
+  float interpolatedTime = (time - mPackedTimings[timeIndex]) *
+                           mPackedInverseTimeDiffs[timeIndex];
+
+  const unsigned int stride = mPackedChannelStride;
+  const float* key = mPackedKeys.data() + timeIndex * mPackedKeyStride;
+  const float* nextKey = key + mPackedKeyStride;
+
+  for (size_t i = 0; i < mPackedBoneIds.size(); ++i) {
+    NodeTransformData& nodeTransform = nodeTransforms[mPackedBoneIds[i]];
+
+    nodeTransform.translation = glm::vec4(
+        glm::mix(glm::vec3(key[i], key[stride + i], key[2 * stride + i]),
+                 glm::vec3(nextKey[i], nextKey[stride + i], nextKey[2 * stride + i]),
+                 interpolatedTime), 1.f);
+
+    nodeTransform.scale = glm::vec4(
+        glm::mix(glm::vec3(key[3 * stride + i], key[4 * stride + i], key[5 * stride + i]),
+                 glm::vec3(nextKey[3 * stride + i], nextKey[4 * stride + i], nextKey[5 * stride + i]),
+                 interpolatedTime), 1.f);
+
+    /* same SLERP as the channel, keeps the results identical */
+    glm::quat rotation = glm::normalize(glm::slerp(
+        glm::quat(key[9 * stride + i], key[6 * stride + i], key[7 * stride + i], key[8 * stride + i]),
+        glm::quat(nextKey[9 * stride + i], nextKey[6 * stride + i], nextKey[7 * stride + i], nextKey[8 * stride + i]),
+        interpolatedTime));
+    nodeTransform.rotation = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+  }
+}
+
+void AssimpAnimClip::sampleChannelPose(float time, AnimClipCursor& cursor,
+    std::vector<NodeTransformData>& nodeTransforms) {
+  if (cursor.channelCursors.size() != mAnimChannels.size()) {
+    cursor.channelCursors.assign(mAnimChannels.size(), AnimChannelCursor{});
+  }
+
+  /* animate clip via channels */
+  for (size_t i = 0; i < mAnimChannels.size(); ++i) {
+    const auto& channel = mAnimChannels.at(i);
+    AnimChannelCursor* channelCursor = &cursor.channelCursors.at(i);
+
+    NodeTransformData nodeTransform;
+    nodeTransform.translation = channel->getTranslation(time, channelCursor);
+    nodeTransform.rotation = channel->getRotation(time, channelCursor);
+    nodeTransform.scale = channel->getScaling(time, channelCursor);
+
+    int boneId = channel->getBoneId();
+    if (boneId >= 0) {
+      nodeTransforms.at(boneId) = nodeTransform;
+    }
+  }
 }
 
-std::string AssimpAnimClip::getClipName() {
+const std::string& AssimpAnimClip::getClipName() {
   return mClipName;
 }
 
@@ -44,7 +347,7 @@ void AssimpAnimClip::setClipName(std::string name) {
   mClipName = name;
 }
 
-std::vector<std::shared_ptr<AssimpAnimChannel>> AssimpAnimClip::getChannels() {
+const std::vector<std::shared_ptr<AssimpAnimChannel>>& AssimpAnimClip::getChannels() {
   return mAnimChannels;
 }
 
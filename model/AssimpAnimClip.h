@@ -1,30 +1,92 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 
 #include <assimp/anim.h>
 
+#include "AlignedAllocator.h"
 #include "AssimpAnimChannel.h"
 #include "AssimpBone.h"
+#include "NodeTransformData.h"
+
+/* key ranges of one bone, layout matches the keyframe sampling shader.
+ * bones without a channel have no keys and get the default transform */
+struct AnimChannelGpuData {
+  uint32_t translationOffset = 0;
+  uint32_t translationCount = 0;
+  uint32_t rotationOffset = 0;
+  uint32_t rotationCount = 0;
+  uint32_t scaleOffset = 0;
+  uint32_t scaleCount = 0;
+  uint32_t preState = 0;
+  uint32_t postState = 0;
+};
+
+/* per-instance playback cursor for a whole clip */
+struct AnimClipCursor {
+  unsigned int keyIndex = 0;
+  std::vector<AnimChannelCursor> channelCursors{};
+};
 
 class AssimpAnimClip {
   public:
   void addChannels(aiAnimation* animation,
                    const std::vector<std::shared_ptr<AssimpBone>>& boneList);
-    std::vector<std::shared_ptr<AssimpAnimChannel>> getChannels();
+    /* channels keep their bone ids, the packed keys are rebuilt on load */
+    void saveToCache(ModelCacheWriter& writer);
+    bool loadFromCache(ModelCacheReader& reader);
+    const std::vector<std::shared_ptr<AssimpAnimChannel>>& getChannels();
 
-    std::string getClipName();
+    const std::string& getClipName();
     float getClipDuration();
     float getClipTicksPerSecond();
 
     void setClipName(std::string name);
 
+    /* samples all channels into the bone-indexed node transforms */
+    void samplePose(float time, AnimClipCursor& cursor,
+                    std::vector<NodeTransformData>& nodeTransforms);
+    /* SIMD version for many play positions of this clip, i.e. a crowd */
+    void samplePoses(const std::vector<float>& times,
+                     const std::vector<AnimClipCursor*>& cursors,
+                     const std::vector<std::vector<NodeTransformData>*>& nodeTransforms);
+    bool hasPackedKeys();
+
+    /* appends one entry per bone and the keys of all channels, times and
+     * values share the same index */
+    void appendGpuKeys(size_t numBones,
+                       std::vector<AnimChannelGpuData>& channels,
+                       std::vector<float>& keyTimes,
+                       std::vector<glm::vec4>& keyValues);
+
   private:
+    void buildPackedKeys();
+    void samplePackedPose(float time, AnimClipCursor& cursor,
+                          std::vector<NodeTransformData>& nodeTransforms);
+    void sampleChannelPose(float time, AnimClipCursor& cursor,
+                           std::vector<NodeTransformData>& nodeTransforms);
+
     std::string mClipName;
     double mClipDuration = 0.0f;
     double mClipTicksPerSecond = 0.0f;
 
     std::vector<std::shared_ptr<AssimpAnimChannel>> mAnimChannels{};
+
+    /* packed layout, only built if all channels share the same key times.
+     * every key holds ten float streams (translation xyz, scale xyz,
+     * rotation xyzw), each stream padded to full cache lines */
+    static constexpr size_t kCacheLineSize = 64;
+    static constexpr unsigned int kPackedStreams = 10;
+
+    bool mHasPackedKeys = false;
+    unsigned int mPackedChannelStride = 0;
+    unsigned int mPackedKeyStride = 0;
+    int mPackedMaxBoneId = -1;
+    std::vector<float> mPackedTimings{};
+    std::vector<float> mPackedInverseTimeDiffs{};
+    std::vector<int> mPackedBoneIds{};
+    std::vector<float, AlignedAllocator<float, kCacheLineSize>> mPackedKeys{};
 };
@@ -6,7 +6,7 @@ AssimpBone::AssimpBone(unsigned int id, std::string name, glm::mat4 matrix) : mB
       Logger::log(1, "%s: --- added bone %i for node name '%s'\n", __FUNCTION__, mBoneId, mNodeName.c_str());
 }
 
-std::string AssimpBone::getBoneName() {
+const std::string& AssimpBone::getBoneName() {
   return mNodeName;
 }
 
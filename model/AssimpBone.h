@@ -11,7 +11,7 @@ class AssimpBone {
     AssimpBone(unsigned int id, std::string name, glm::mat4 matrix);
 
     unsigned int getBoneId();
-    std::string getBoneName();
+    const std::string& getBoneName();
     glm::mat4 getOffsetMatrix();
 
   private:
@@ -1,5 +1,6 @@
 #include "AssimpInstance.h"
 
+#include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
@@ -55,31 +56,60 @@ void AssimpInstance::updateModelRootMatrix() {
 	mInstanceRootMatrix = mLocalTransformMatrix * mModelRootMatrix;
 }
 
-void AssimpInstance::updateAnimation(float deltaTime) {
-  mInstanceSettings.animPlayTimePos += deltaTime * mAssimpModel->getAnimClips().at(mInstanceSettings.animClipNr)->getClipTicksPerSecond() * mInstanceSettings.animSpeedFactor;
-  mInstanceSettings.animPlayTimePos = std::fmod(mInstanceSettings.animPlayTimePos, mAssimpModel->getAnimClips().at(mInstanceSettings.animClipNr)->getClipDuration());
-
-  std::vector<std::shared_ptr<AssimpAnimChannel>> animChannels = mAssimpModel->getAnimClips().at(mInstanceSettings.animClipNr)->getChannels();
-
-	std::fill(mNodeTransformData.begin(), mNodeTransformData.end(),
-            NodeTransformData{});
-
-  /* animate clip via channels */
-  for (const auto& channel : animChannels) {
-    NodeTransformData nodeTransform;
-    nodeTransform.translation =
-        channel->getTranslation(mInstanceSettings.animPlayTimePos);
-    nodeTransform.rotation =
-        channel->getRotation(mInstanceSettings.animPlayTimePos);
-    nodeTransform.scale =
-        channel->getScaling(mInstanceSettings.animPlayTimePos);
-
-    int boneId = channel->getBoneId();
-    if (boneId >= 0) {
-      mNodeTransformData.at(boneId) = nodeTransform;
+void AssimpInstance::updateAnimations(
+    std::span<const std::shared_ptr<AssimpInstance>> instances,
+    float deltaTime) {
+  if (instances.empty()) {
+    return;
+  }
+
+  /* per-thread scratch lists, avoids new allocations every frame */
+  thread_local std::vector<float> playTimes;
+  thread_local std::vector<AnimClipCursor*> cursors;
+  thread_local std::vector<std::vector<NodeTransformData>*> nodeTransforms;
+
+  const auto& animClips = instances.front()->mAssimpModel->getAnimClips();
+  for (const auto& instance : instances) {
+    AnimPlayback::updateTime(
+        *animClips.at(instance->mInstanceSettings.animClipNr),
+        instance->mInstanceSettings, instance->mAnimPlayback, deltaTime);
+  }
+
+  /* collect all instances playing the same clip */
+  for (unsigned int clipNr = 0; clipNr < animClips.size(); ++clipNr) {
+    playTimes.clear();
+    cursors.clear();
+    nodeTransforms.clear();
+
+    for (const auto& instance : instances) {
+      if (instance->mInstanceSettings.animClipNr != clipNr ||
+          !AnimPlayback::shouldSamplePose(instance->mAnimPlayback)) {
+        continue;
+      }
+      instance->mAnimPlayback.poseOutdated = false;
+      playTimes.emplace_back(instance->mInstanceSettings.animPlayTimePos);
+      cursors.emplace_back(&instance->mAnimPlayback.cursor);
+      nodeTransforms.emplace_back(&instance->mNodeTransformData);
+    }
+
+    if (!playTimes.empty()) {
+      animClips.at(clipNr)->samplePoses(playTimes, cursors, nodeTransforms);
     }
   }
 
+  for (const auto& instance : instances) {
+    instance->updateModelRootMatrix();
+  }
+}
+
+void AssimpInstance::updateAnimation(float deltaTime) {
+  /* look up the clip only once, no shared_ptr copies in the hot path */
+  AssimpAnimClip& animClip =
+      *mAssimpModel->getAnimClips().at(mInstanceSettings.animClipNr);
+
+  AnimPlayback::update(animClip, mInstanceSettings, mAnimPlayback,
+                       mNodeTransformData, deltaTime);
+
   ///* set root node transform matrix, enabling instance movement */
   //mAssimpModel->getRootNode()->setRootTransformMatrix(mLocalTransformMatrix * mAssimpModel->getRootTranformationMatrix());
 
@@ -98,10 +128,56 @@ void AssimpInstance::updateAnimation(float deltaTime) {
   updateModelRootMatrix();
 }
 
+void AssimpInstance::updatePlayTime(float deltaTime) {
+  AnimPlayback::updateTime(
+      *mAssimpModel->getAnimClips().at(mInstanceSettings.animClipNr),
+      mInstanceSettings, mAnimPlayback, deltaTime);
+
+  /* the CPU pose is stale when switching back to CPU sampling */
+  mAnimPlayback.poseOutdated = true;
+
+  updateModelRootMatrix();
+}
+
 std::shared_ptr<AssimpModel> AssimpInstance::getModel() {
   return mAssimpModel;
 }
 
+glm::vec4 AssimpInstance::getBoundingSphere() {
+  if (mAssimpModel->hasAnimations() && !mAssimpModel->getBoneList().empty()) {
+    return mAssimpModel->getAnimClipBoundingSphere(
+        mInstanceSettings.animClipNr);
+  }
+  return mAssimpModel->getBoundingSphere();
+}
+
+glm::vec4 AssimpInstance::getWorldBoundingSphere() {
+  glm::vec4 sphere = getBoundingSphere();
+  glm::vec3 center =
+      glm::vec3(mInstanceRootMatrix * glm::vec4(glm::vec3(sphere), 1.0f));
+  float scale =
+      std::max(glm::length(glm::vec3(mInstanceRootMatrix[0])),
+               std::max(glm::length(glm::vec3(mInstanceRootMatrix[1])),
+                        glm::length(glm::vec3(mInstanceRootMatrix[2]))));
+  return glm::vec4(center, sphere.w * scale);
+}
+
+void AssimpInstance::setVisible(bool visible) {
+  /* the last pose is stale once the instance comes back */
+  if (!visible) {
+    mAnimPlayback.poseOutdated = true;
+  }
+  mAnimPlayback.visible = visible;
+}
+
+bool AssimpInstance::isVisible() {
+  return mAnimPlayback.visible;
+}
+
+void AssimpInstance::setPoseUpdateDue(bool due) {
+  mAnimPlayback.poseUpdateDue = due;
+}
+
 glm::vec3 AssimpInstance::getWorldPosition() {
   return mInstanceSettings.worldPosition;
 }
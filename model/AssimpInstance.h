@@ -3,9 +3,11 @@
 #include <glm/glm.hpp>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "AnimPlayback.h"
 #include "AssimpBone.h"
 #include "AssimpModel.h"
 #include "AssimpNode.h"
@@ -39,6 +41,26 @@ class AssimpInstance {
 
   void updateModelRootMatrix();
   void updateAnimation(float deltaTime);
+  /* only advances the play time, the pose is sampled on the GPU */
+  void updatePlayTime(float deltaTime);
+
+  /* bounds of the current clip in model space, xyz center, w radius */
+  glm::vec4 getBoundingSphere();
+  /* same bounds moved to world space, the radius uses the largest scale */
+  glm::vec4 getWorldBoundingSphere();
+
+  /* instances outside the view frustum keep the time but skip the sampling */
+  void setVisible(bool visible);
+  bool isVisible();
+
+  /* animation LOD, far instances keep their last pose for some frames */
+  void setPoseUpdateDue(bool due);
+
+  /* batch version for instances of the same model, samples every clip with
+   * the SIMD pose sampler */
+  static void updateAnimations(
+      std::span<const std::shared_ptr<AssimpInstance>> instances,
+      float deltaTime);
 
  private:
   std::shared_ptr<AssimpModel> mAssimpModel = nullptr;
@@ -58,4 +80,7 @@ class AssimpInstance {
   glm::mat4 mInstanceRootMatrix{1.f};
   glm::mat4 mModelRootMatrix{1.f};
   std::vector<NodeTransformData> mNodeTransformData{};
+
+  /* cursor, visibility and LOD state of the animation */
+  AnimPlaybackData mAnimPlayback{};
 };
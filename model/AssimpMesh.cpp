@@ -1,10 +1,33 @@
 #include "AssimpMesh.h"
 
+#include <cmath>
+#include <limits>
+#include <glm/gtc/packing.hpp>
+
 #include "Logger.h"
+#include "MeshOptimizer.h"
 #include "Tools.h"
 
-bool AssimpMesh::processMesh(VkRenderData &renderData, aiMesh* mesh, const aiScene* scene, std::string assetDirectory,
-    std::unordered_map<std::string, VkTextureData> &textures) {
+namespace {
+  /* octahedral mapping, the lower half is folded over the diagonals */
+  glm::vec2 encodeOctNormal(glm::vec3 normal) {
+    float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length == 0.0f) {
+      return glm::vec2(0.0f);
+    }
+    normal /= length;
+
+    if (normal.z >= 0.0f) {
+      return glm::vec2(normal.x, normal.y);
+    }
+    glm::vec2 folded = 1.0f - glm::abs(glm::vec2(normal.y, normal.x));
+    return glm::vec2(normal.x >= 0.0f ? folded.x : -folded.x,
+      normal.y >= 0.0f ? folded.y : -folded.y);
+  }
+}
+
+bool AssimpMesh::processMesh(aiMesh* mesh, const aiScene* scene, std::string assetDirectory,
+    std::unordered_map<std::string, VkTextureImage> &textures) {
   mMeshName = mesh->mName.C_Str();
 
   mTriangleCount = mesh->mNumFaces;
@@ -53,15 +76,14 @@ bool AssimpMesh::processMesh(VkRenderData &renderData, aiMesh* mesh, const aiSce
 
             // do not try to load internal textures
             if (!texName.empty() && texName.find("*") != 0) {
-              VkTextureData newTex{};
+              VkTextureImage newImage{};
               std::string texNameWithPath = assetDirectory + '/' + texName;
-              if (!Texture::loadTexture(renderData, &newTex, texNameWithPath)) {
+              if (!Texture::decodeTexture(&newImage, texNameWithPath)) {
                 Logger::log(1, "%s error: could not load texture file '%s', skipping\n", __FUNCTION__, texNameWithPath.c_str());
-                Texture::cleanup(renderData, &newTex);
                 continue;
               }
 
-              textures.insert({texName, newTex});
+              textures.insert({texName, std::move(newImage)});
             }
           }
         }
@@ -155,18 +177,123 @@ bool AssimpMesh::processMesh(VkRenderData &renderData, aiMesh* mesh, const aiSce
     }
   }
 
+  optimizeMesh();
+  packVertices(mesh->HasVertexColors(0));
+
   return true;
 }
 
-std::vector<uint32_t> AssimpMesh::getIndices() {
+void AssimpMesh::optimizeMesh() {
+  if (mMesh.indices.empty()) {
+    return;
+  }
+
+  size_t importedVertexCount = mMesh.vertices.size();
+  float acmrBefore = MeshOptimizer::calculateACMR(mMesh.indices, importedVertexCount);
+
+  /* bone weights are part of the vertex, so welding happens after them */
+  std::vector<uint32_t> remap;
+  size_t weldedVertexCount = MeshOptimizer::weldVertices(mMesh.vertices.data(), mMesh.vertices.size(), sizeof(VkVertex), remap);
+  remapVertices(remap, weldedVertexCount);
+
+  MeshOptimizer::optimizeVertexCache(mMesh.indices, mMesh.vertices.size());
+
+  size_t usedVertexCount = MeshOptimizer::optimizeVertexFetch(mMesh.indices, mMesh.vertices.size(), remap);
+  remapVertices(remap, usedVertexCount);
+
+  mVertexCount = static_cast<unsigned int>(mMesh.vertices.size());
+  Logger::log(1, "%s: -- mesh '%s': %i of %i vertices left, ACMR %f before and %f after optimization\n", __FUNCTION__,
+    mMeshName.c_str(), mVertexCount, importedVertexCount, acmrBefore,
+    MeshOptimizer::calculateACMR(mMesh.indices, mMesh.vertices.size()));
+}
+
+void AssimpMesh::remapVertices(const std::vector<uint32_t>& remap, size_t newVertexCount) {
+  std::vector<VkVertex> vertices(newVertexCount);
+  for (size_t i = 0; i < remap.size(); ++i) {
+    if (remap[i] != MeshOptimizer::kUnusedVertex) {
+      vertices[remap[i]] = mMesh.vertices[i];
+    }
+  }
+  mMesh.vertices = std::move(vertices);
+
+  for (auto& index : mMesh.indices) {
+    index = remap[index];
+  }
+}
+
+void AssimpMesh::packVertices(bool hasVertexColors) {
+  mMesh.packedVertices.clear();
+
+  /* no per-vertex color and 8 bit bone indices in the packed format */
+  if (hasVertexColors || mBoneList.size() > 256 || mMesh.vertices.empty()) {
+    Logger::log(1, "%s: -- mesh '%s' keeps the full vertex format\n", __FUNCTION__, mMeshName.c_str());
+    return;
+  }
+
+  glm::vec3 minPos = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 maxPos = glm::vec3(std::numeric_limits<float>::lowest());
+  for (const auto& vertex : mMesh.vertices) {
+    minPos = glm::min(minPos, glm::vec3(vertex.position));
+    maxPos = glm::max(maxPos, glm::vec3(vertex.position));
+  }
+
+  /* the positions use the full snorm range inside the mesh bounds */
+  glm::vec3 center = (minPos + maxPos) * 0.5f;
+  glm::vec3 halfExtent = glm::max((maxPos - minPos) * 0.5f, glm::vec3(1e-6f));
+  mMesh.packedPositionScale = glm::vec4(halfExtent, 1.0f);
+  mMesh.packedPositionOffset = glm::vec4(center, 0.0f);
+  mMesh.packedColor = mMesh.usesPBRColors ? mBaseColor : glm::vec4(1.0f);
+
+  mMesh.packedVertices.reserve(mMesh.vertices.size());
+  for (const auto& vertex : mMesh.vertices) {
+    VkPackedVertex packed;
+
+    glm::vec3 position = (glm::vec3(vertex.position) - center) / halfExtent;
+    for (int i = 0; i < 3; ++i) {
+      packed.position[i] = static_cast<int16_t>(glm::packSnorm1x16(position[i]));
+    }
+    packed.position[3] = static_cast<int16_t>(glm::packSnorm1x16(1.0f));
+
+    glm::vec2 octNormal = encodeOctNormal(glm::vec3(vertex.normal));
+    packed.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(octNormal.x));
+    packed.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(octNormal.y));
+
+    packed.texCoord[0] = glm::packHalf1x16(vertex.position.w);
+    packed.texCoord[1] = glm::packHalf1x16(vertex.normal.w);
+
+    /* the rounding error goes to the largest weight, the sum stays at 255 */
+    float weightSum = vertex.boneWeights.x + vertex.boneWeights.y + vertex.boneWeights.z + vertex.boneWeights.w;
+    if (weightSum > 0.0f) {
+      int quantizedSum = 0;
+      int largestWeight = 0;
+      for (int i = 0; i < 4; ++i) {
+        packed.boneNum[i] = static_cast<uint8_t>(vertex.boneNum[i]);
+        packed.boneWeights[i] = static_cast<uint8_t>(std::round(vertex.boneWeights[i] / weightSum * 255.0f));
+        quantizedSum += packed.boneWeights[i];
+        if (vertex.boneWeights[i] > vertex.boneWeights[largestWeight]) {
+          largestWeight = i;
+        }
+      }
+      packed.boneWeights[largestWeight] = static_cast<uint8_t>(packed.boneWeights[largestWeight] + 255 - quantizedSum);
+    }
+
+    mMesh.packedVertices.emplace_back(packed);
+  }
+
+  Logger::log(1, "%s: -- packed %i vertices of mesh '%s' into %i bytes (full format: %i bytes)\n", __FUNCTION__,
+    mMesh.packedVertices.size(), mMeshName.c_str(), mMesh.packedVertices.size() * sizeof(VkPackedVertex),
+    mMesh.vertices.size() * sizeof(VkVertex));
+}
+
+const std::vector<uint32_t>& AssimpMesh::getIndices() {
   return mMesh.indices;
 }
 
-VkMesh AssimpMesh::getMesh() {
+const VkMesh& AssimpMesh::getMesh() {
   return mMesh;
 }
 
-std::string AssimpMesh::getMeshName() {
+const std::string& AssimpMesh::getMeshName() {
   return mMeshName;
 }
 
@@ -178,6 +305,6 @@ unsigned int AssimpMesh::getVertexCount() {
   return mVertexCount;
 }
 
-std::vector<std::shared_ptr<AssimpBone>> AssimpMesh::getBoneList() {
+const std::vector<std::shared_ptr<AssimpBone>>& AssimpMesh::getBoneList() {
   return mBoneList;
 }
@@ -14,18 +14,27 @@
 
 class AssimpMesh {
   public:
-    bool processMesh(VkRenderData &renderData, aiMesh* mesh, const aiScene* scene, std::string assetDirectory,
-      std::unordered_map<std::string, VkTextureData> &textures);
+    /* CPU only, textures are decoded but not uploaded */
+    bool processMesh(aiMesh* mesh, const aiScene* scene, std::string assetDirectory,
+      std::unordered_map<std::string, VkTextureImage> &textures);
 
-    std::string getMeshName();
+    const std::string& getMeshName();
     unsigned int getTriangleCount();
     unsigned int getVertexCount();
 
-    VkMesh getMesh();
-    std::vector<uint32_t> getIndices();
-    std::vector<std::shared_ptr<AssimpBone>> getBoneList();
+    const VkMesh& getMesh();
+    const std::vector<uint32_t>& getIndices();
+    const std::vector<std::shared_ptr<AssimpBone>>& getBoneList();
 
   private:
+    /* welds the vertices, then reorders triangles and vertices for the
+     * post-transform cache and the vertex fetch */
+    void optimizeMesh();
+    void remapVertices(const std::vector<uint32_t>& remap, size_t newVertexCount);
+
+    /* fills the packed vertices if the mesh fits into the compact format */
+    void packVertices(bool hasVertexColors);
+
     std::string mMeshName;
     unsigned int mTriangleCount = 0;
     unsigned int mVertexCount = 0;
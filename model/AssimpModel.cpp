@@ -4,26 +4,330 @@
 #include <assimp/scene.h>
 
 #include <algorithm>
+#include <array>
 #include <assimp/Importer.hpp>
+#include <assimp/ProgressHandler.hpp>
+#include <cmath>
 #include <filesystem>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <limits>
 
+#include "GeometryArena.h"
 #include "ShaderStorageBuffer.h"
+#include "UploadManager.h"
 
 #include "Logger.h"
+#include "MappedFile.h"
+#include "ModelCache.h"
+#include "Timer.h"
 #include "Tools.h"
 
+namespace {
+/* the Assimp import is the first half of the CPU work, mesh processing and
+ * texture decoding the second one */
+constexpr float kImportProgressShare = 0.5f;
+constexpr float kMeshProgressShare = 0.9f;
+
+class ImportProgressHandler : public Assimp::ProgressHandler {
+ public:
+  ImportProgressHandler(std::atomic<float>& progress,
+                        const std::atomic<bool>& cancel)
+      : mProgress(progress), mCancel(cancel) {}
+
+  /* returning false stops the import */
+  bool Update(float percentage) override {
+    if (percentage >= 0.0f) {
+      mProgress.store(std::min(percentage, 1.0f) * kImportProgressShare);
+    }
+    return !mCancel.load();
+  }
+
+ private:
+  std::atomic<float>& mProgress;
+  const std::atomic<bool>& mCancel;
+};
+}  // namespace
+
 bool AssimpModel::loadModel(VkRenderData& renderData,
                             const std::string& modelFilename,
                             unsigned int extraImportFlags) {
+  if (!loadModelData(modelFilename, extraImportFlags)) {
+    return false;
+  }
+  if (!uploadModelData(renderData)) {
+    return false;
+  }
+  return UploadManager::flush(renderData);
+}
+
+bool AssimpModel::loadModelData(const std::string& modelFilename,
+                                unsigned int extraImportFlags) {
   Logger::log(1, "%s: loading model from file '%s'\n", __FUNCTION__,
               modelFilename.c_str());
 
-  Assimp::Importer importer;
+  Timer loadTimer;
+  loadTimer.start();
+  mLoadProgress.store(0.0f);
+
   /* we need to flip texture coordinates for Vulkan */
-  const aiScene* scene = importer.ReadFile(
-      modelFilename, aiProcess_Triangulate | aiProcess_GenNormals |
-                         aiProcess_ValidateDataStructure | aiProcess_FlipUVs |
-                         extraImportFlags);
+  unsigned int importFlags = aiProcess_Triangulate | aiProcess_GenNormals |
+                             aiProcess_ValidateDataStructure |
+                             aiProcess_FlipUVs | extraImportFlags;
+
+  /* the textures are stored directly or relative to the model file */
+  std::string assetDirectory =
+      modelFilename.substr(0, modelFilename.find_last_of('/'));
+
+  /* the cache is only valid for the same source file and import flags */
+  ModelSourceInfo sourceInfo{};
+  if (!ModelCache::getSourceInfo(modelFilename, sourceInfo)) {
+    Logger::log(1, "%s error: could not read model file '%s'\n", __FUNCTION__,
+                modelFilename.c_str());
+    return false;
+  }
+
+  std::string cacheFilename = ModelCache::getCacheFileName(modelFilename);
+  bool loadedFromCache = loadModelCache(cacheFilename, modelFilename,
+                                        sourceInfo, importFlags,
+                                        assetDirectory);
+  if (!loadedFromCache) {
+    /* the new cache needs the hash, unless the cache check already made it */
+    if (!sourceInfo.hashed) {
+      if (!ModelCache::hashFile(modelFilename, sourceInfo.hash)) {
+        Logger::log(1, "%s error: could not read model file '%s'\n",
+                    __FUNCTION__, modelFilename.c_str());
+        return false;
+      }
+      sourceInfo.hashed = true;
+    }
+    if (!importModel(modelFilename, importFlags, assetDirectory, cacheFilename,
+                     sourceInfo)) {
+      return false;
+    }
+  }
+  mLoadProgress.store(kMeshProgressShare);
+
+  calculateBounds();
+  calculateAnimClipBounds();
+  calculateBoneLevels();
+  collectAnimClipKeys();
+
+  if (!decodeDefaultTextures()) {
+    return false;
+  }
+
+  mModelFilenamePath = modelFilename;
+  mModelFilename =
+      std::filesystem::path(modelFilename).filename().generic_string();
+
+  Logger::log(1, "%s: - model has a total of %i texture%s\n", __FUNCTION__,
+              mTextureImages.size(), mTextureImages.size() == 1 ? "" : "s");
+  Logger::log(1, "%s: - model has a total of %i bone%s\n", __FUNCTION__,
+              mBoneList.size(), mBoneList.size() == 1 ? "" : "s");
+  Logger::log(1, "%s: - model has a total of %i animation%s\n", __FUNCTION__,
+              mAnimClips.size(), mAnimClips.size() == 1 ? "" : "s");
+
+  Logger::log(1, "%s: model data for '%s' (%s) loaded in %f ms%s\n",
+              __FUNCTION__, modelFilename.c_str(), mModelFilename.c_str(),
+              loadTimer.stop(), loadedFromCache ? " from cache" : "");
+  return true;
+}
+
+bool AssimpModel::loadBoxModelData(const std::string& modelName) {
+  /* uv corners of every side, counter-clockwise seen from outside */
+  const std::array<glm::vec2, 4> corners = {
+      glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f),
+      glm::vec2(0.0f, 1.0f)};
+  const std::array<glm::vec3, 6> sideNormals = {
+      glm::vec3(1.0f, 0.0f, 0.0f),  glm::vec3(-1.0f, 0.0f, 0.0f),
+      glm::vec3(0.0f, 1.0f, 0.0f),  glm::vec3(0.0f, -1.0f, 0.0f),
+      glm::vec3(0.0f, 0.0f, 1.0f),  glm::vec3(0.0f, 0.0f, -1.0f)};
+  const glm::vec3 boxCenter = glm::vec3(0.0f, 0.5f, 0.0f);
+
+  /* own vertices per side for flat normals, the white texture shows the
+   * mesh color */
+  VkMesh mesh{};
+  mesh.usesPBRColors = true;
+  for (const auto& normal : sideNormals) {
+    glm::vec3 tangent = std::abs(normal.y) > 0.5f ? glm::vec3(1.0f, 0.0f, 0.0f)
+                                                  : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+
+    uint32_t firstVertex = static_cast<uint32_t>(mesh.vertices.size());
+    for (const auto& corner : corners) {
+      glm::vec3 position = boxCenter + normal * 0.5f +
+                           tangent * (corner.x - 0.5f) +
+                           bitangent * (corner.y - 0.5f);
+      VkVertex vertex{};
+      vertex.position = glm::vec4(position, corner.x);
+      vertex.normal = glm::vec4(normal, corner.y);
+      vertex.color = glm::vec4(0.6f, 0.6f, 0.6f, 1.0f);
+      mesh.vertices.emplace_back(vertex);
+    }
+    for (uint32_t index : {0u, 1u, 2u, 0u, 2u, 3u}) {
+      mesh.indices.emplace_back(firstVertex + index);
+    }
+  }
+
+  mVertexCount = static_cast<unsigned int>(mesh.vertices.size());
+  mTriangleCount = static_cast<unsigned int>(mesh.indices.size() / 3);
+  mModelMeshes.emplace_back(mesh);
+  mRootNode = AssimpNode::createNode(modelName);
+
+  calculateBounds();
+  calculateAnimClipBounds();
+  calculateBoneLevels();
+  collectAnimClipKeys();
+
+  if (!decodeDefaultTextures()) {
+    return false;
+  }
+
+  mModelFilenamePath = modelName;
+  mModelFilename = modelName;
+  return true;
+}
+
+bool AssimpModel::uploadModelData(VkRenderData& renderData) {
+  Timer uploadTimer;
+  uploadTimer.start();
+
+  for (const auto& [texName, image] : mTextureImages) {
+    VkTextureData newTex{};
+    if (!Texture::loadTexture(renderData, &newTex, image)) {
+      return false;
+    }
+    mTextures.insert({texName, newTex});
+  }
+
+  if (!Texture::loadTexture(renderData, &mWhiteTexture, mWhiteTextureImage) ||
+      !Texture::loadTexture(renderData, &mPlaceholderTexture,
+                            mPlaceholderTextureImage)) {
+    return false;
+  }
+
+  /* resolve the diffuse texture and the mesh data once, the draws only copy
+   * the records */
+  mMeshDrawRecords.clear();
+  for (const auto& mesh : mModelMeshes) {
+    VkMeshDrawRecord record{};
+    record.command.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    record.drawData.positionScale = mesh.packedPositionScale;
+    record.drawData.positionOffset = mesh.packedPositionOffset;
+    record.drawData.meshColor = mesh.packedColor;
+
+    record.drawData.textureIndex = mesh.usesPBRColors
+                                       ? mWhiteTexture.tableIndex
+                                       : mPlaceholderTexture.tableIndex;
+    auto diffuseTexName = mesh.textures.find(aiTextureType_DIFFUSE);
+    if (diffuseTexName != mesh.textures.end()) {
+      auto diffuseTexture = mTextures.find(diffuseTexName->second);
+      if (diffuseTexture != mTextures.end()) {
+        record.drawData.textureIndex = diffuseTexture->second.tableIndex;
+      }
+    }
+    mMeshDrawRecords.emplace_back(record);
+  }
+
+  /* the pixels are in GPU memory now */
+  mTextureImages.clear();
+  mWhiteTextureImage = VkTextureImage{};
+  mPlaceholderTextureImage = VkTextureImage{};
+
+  std::vector<glm::mat4> boneOffsetMatricesList{};
+  for (const auto& bone : mBoneList) {
+    boneOffsetMatricesList.emplace_back(bone->getOffsetMatrix());
+  }
+
+  Logger::log(1, "%s: -- bone parents --\n", __FUNCTION__);
+  for (unsigned int i = 0; i < mBoneList.size(); ++i) {
+    Logger::log(
+        1, "%s: bone %i (%s) has parent %i (%s)\n", __FUNCTION__, i,
+        mBoneList.at(i)->getBoneName().c_str(), mBoneParentIndexList.at(i),
+        mBoneParentIndexList.at(i) < 0
+            ? "invalid"
+            : mBoneList.at(mBoneParentIndexList.at(i))->getBoneName().c_str());
+  }
+  Logger::log(1, "%s: -- bone parents --\n", __FUNCTION__);
+
+  /* a model uses one pipeline, so every mesh must have packed vertices */
+  mPackedVertices =
+      renderData.rdUsePackedVertices &&
+      std::all_of(mModelMeshes.begin(), mModelMeshes.end(),
+                  [](const VkMesh& mesh) {
+                    return mesh.packedVertices.size() == mesh.vertices.size();
+                  });
+
+  /* copy the meshes into the shared geometry arena */
+  mVertexBufferSize = 0;
+  for (const auto& mesh : mModelMeshes) {
+    VkMeshRanges meshRanges{};
+    if (!GeometryArena::uploadMesh(renderData, mesh, mPackedVertices,
+                                   &meshRanges)) {
+      GeometryArena::freeMesh(renderData, &meshRanges);
+      return false;
+    }
+    mMeshRanges.emplace_back(meshRanges);
+
+    mVertexBufferSize +=
+        mPackedVertices ? mesh.packedVertices.size() * sizeof(VkPackedVertex)
+                        : mesh.vertices.size() * sizeof(VkVertex);
+  }
+  updateDrawRecordOffsets(renderData);
+
+	/* init all SSBOs */
+  ShaderStorageBuffer::init(renderData, &mShaderBoneMatrixOffsetBuffer);
+  ShaderStorageBuffer::init(renderData, &mShaderBoneParentBuffer);
+  ShaderStorageBuffer::init(renderData, &mShaderBoneLevelBuffer);
+  ShaderStorageBuffer::init(renderData, &mShaderAnimChannelBuffer);
+  ShaderStorageBuffer::init(renderData, &mShaderAnimKeyTimeBuffer);
+  ShaderStorageBuffer::init(renderData, &mShaderAnimKeyValueBuffer);
+
+  ShaderStorageBuffer::uploadSSBOData(
+      renderData, &mShaderBoneMatrixOffsetBuffer, boneOffsetMatricesList);
+  ShaderStorageBuffer::uploadSSBOData(
+      renderData, &mShaderBoneParentBuffer, (char*)mBoneParentIndexList.data(),
+      mBoneParentIndexList.size() * sizeof(int32_t));
+  ShaderStorageBuffer::uploadSSBOData(
+      renderData, &mShaderBoneLevelBuffer, (char*)mBoneLevelData.data(),
+      mBoneLevelData.size() * sizeof(uint32_t));
+  ShaderStorageBuffer::uploadSSBOData(
+      renderData, &mShaderAnimChannelBuffer,
+      (char*)mAnimChannelGpuData.data(),
+      mAnimChannelGpuData.size() * sizeof(AnimChannelGpuData));
+  ShaderStorageBuffer::uploadSSBOData(
+      renderData, &mShaderAnimKeyTimeBuffer, (char*)mAnimKeyTimes.data(),
+      mAnimKeyTimes.size() * sizeof(float));
+  ShaderStorageBuffer::uploadSSBOData(
+      renderData, &mShaderAnimKeyValueBuffer, (char*)mAnimKeyValues.data(),
+      mAnimKeyValues.size() * sizeof(glm::vec4));
+
+  /* create descriptor set for per-model data */
+  createDescriptorSet(renderData);
+
+  mLoadProgress.store(1.0f);
+
+  Logger::log(1, "%s: successfully loaded model '%s' (%s), upload took %f ms\n",
+              __FUNCTION__, mModelFilenamePath.c_str(), mModelFilename.c_str(),
+              uploadTimer.stop());
+  return true;
+}
+
+float AssimpModel::getLoadProgress() { return mLoadProgress.load(); }
+
+void AssimpModel::cancelLoading() { mCancelLoad.store(true); }
+
+bool AssimpModel::importModel(const std::string& modelFilename,
+                              unsigned int importFlags,
+                              const std::string& assetDirectory,
+                              const std::string& cacheFilename,
+                              const ModelSourceInfo& sourceInfo) {
+  Assimp::Importer importer;
+  /* the importer owns the handler */
+  importer.SetProgressHandler(
+      new ImportProgressHandler(mLoadProgress, mCancelLoad));
+  const aiScene* scene = importer.ReadFile(modelFilename, importFlags);
 
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
       !scene->mRootNode) {
@@ -59,43 +363,21 @@ bool AssimpModel::loadModel(VkRenderData& renderData,
       unsigned int width = scene->mTextures[i]->mWidth;
       aiTexel* data = scene->mTextures[i]->pcData;
 
-      VkTextureData newTex{};
-      if (!Texture::loadTexture(renderData, &newTex, texName, data, width,
-                                height)) {
+      VkTextureImage newImage{};
+      if (!Texture::decodeTexture(&newImage, texName, data, width, height)) {
         return false;
       }
 
       std::string internalTexName = "*" + std::to_string(i);
       Logger::log(1, "%s: - added internal texture '%s'\n", __FUNCTION__,
                   internalTexName.c_str());
-      mTextures.insert({internalTexName, newTex});
+      mTextureImages.insert({internalTexName, std::move(newImage)});
     }
 
     Logger::log(1, "%s: scene has %i embedded textures\n", __FUNCTION__,
                 numTextures);
   }
 
-  /* add a white texture in case there is no diffuse tex but colors */
-  std::string whiteTexName = "textures/white.png";
-  if (!Texture::loadTexture(renderData, &mWhiteTexture, whiteTexName)) {
-    Logger::log(1, "%s error: could not load white default texture '%s'\n",
-                __FUNCTION__, whiteTexName.c_str());
-    return false;
-  }
-
-  /* add a placeholder texture in case there is no diffuse tex */
-  std::string placeholderTexName = "textures/missing_tex.png";
-  if (!Texture::loadTexture(renderData, &mPlaceholderTexture,
-                            placeholderTexName)) {
-    Logger::log(1, "%s error: could not load placeholder texture '%s'\n",
-                __FUNCTION__, placeholderTexName.c_str());
-    return false;
-  }
-
-  /* the textures are stored directly or relative to the model file */
-  std::string assetDirectory =
-      modelFilename.substr(0, modelFilename.find_last_of('/'));
-
   /* nodes */
   Logger::log(1, "%s: ... processing nodes...\n", __FUNCTION__);
 
@@ -105,12 +387,14 @@ bool AssimpModel::loadModel(VkRenderData& renderData,
   Logger::log(1, "%s: root node name: '%s'\n", __FUNCTION__,
               rootNodeName.c_str());
 
-  processNode(renderData, mRootNode, rootNode, scene, assetDirectory);
+  mLoadProgress.store(kImportProgressShare);
+  processNode(mRootNode, rootNode, scene, assetDirectory);
 
   Logger::log(1, "%s: ... processing nodes finished...\n", __FUNCTION__);
 
   for (const auto& entry : mNodeList) {
-    std::vector<std::shared_ptr<AssimpNode>> childNodes = entry->getChilds();
+    const std::vector<std::shared_ptr<AssimpNode>>& childNodes =
+        entry->getChilds();
 
     std::string parentName = entry->getParentNodeName();
     Logger::log(1,
@@ -125,12 +409,7 @@ bool AssimpModel::loadModel(VkRenderData& renderData,
     }
   }
 
-	std::vector<glm::mat4> boneOffsetMatricesList{};
-  std::vector<int32_t> boneParentIndexList{};
-
   for (const auto& bone : mBoneList) {
-    boneOffsetMatricesList.emplace_back(bone->getOffsetMatrix());
-
     std::string parentNodeName =
         mNodeMap.at(bone->getBoneName())->getParentNodeName();
     const auto boneIter =
@@ -139,52 +418,13 @@ bool AssimpModel::loadModel(VkRenderData& renderData,
                        return bone->getBoneName() == parentNodeName;
                      });
     if (boneIter == mBoneList.end()) {
-      boneParentIndexList.emplace_back(-1);  // root node gets a -1 to identify
+      mBoneParentIndexList.emplace_back(-1);  // root node gets a -1 to identify
     } else {
-      boneParentIndexList.emplace_back(
+      mBoneParentIndexList.emplace_back(
           std::distance(mBoneList.begin(), boneIter));
     }
   }
 
-  Logger::log(1, "%s: -- bone parents --\n", __FUNCTION__);
-  for (unsigned int i = 0; i < mBoneList.size(); ++i) {
-    Logger::log(
-        1, "%s: bone %i (%s) has parent %i (%s)\n", __FUNCTION__, i,
-        mBoneList.at(i)->getBoneName().c_str(), boneParentIndexList.at(i),
-        boneParentIndexList.at(i) < 0
-            ? "invalid"
-            : mBoneList.at(boneParentIndexList.at(i))->getBoneName().c_str());
-  }
-  Logger::log(1, "%s: -- bone parents --\n", __FUNCTION__);
-
-  /* create vertex buffers for the meshes */
-  for (const auto& mesh : mModelMeshes) {
-    VkVertexBufferData vertexBuffer;
-    VertexBuffer::init(renderData, &vertexBuffer,
-                       mesh.vertices.size() * sizeof(VkVertex));
-    VertexBuffer::uploadData(renderData, &vertexBuffer, mesh);
-    mVertexBuffers.emplace_back(vertexBuffer);
-
-    VkIndexBufferData indexBuffer;
-    IndexBuffer::init(renderData, &indexBuffer,
-                      mesh.indices.size() * sizeof(uint32_t));
-    IndexBuffer::uploadData(renderData, &indexBuffer, mesh);
-    mIndexBuffers.emplace_back(indexBuffer);
-  }
-
-	/* init all SSBOs */
-  ShaderStorageBuffer::init(renderData, &mShaderBoneMatrixOffsetBuffer);
-  ShaderStorageBuffer::init(renderData, &mShaderBoneParentBuffer);
-
-  ShaderStorageBuffer::uploadSSBOData(
-      renderData, &mShaderBoneMatrixOffsetBuffer, boneOffsetMatricesList);
-  ShaderStorageBuffer::uploadSSBOData(
-      renderData, &mShaderBoneParentBuffer, (char*)boneParentIndexList.data(),
-      boneParentIndexList.size() * sizeof(int32_t));
-
-  /* create descriptor set for per-model data */
-  createDescriptorSet(renderData);
-
   /* animations */
   unsigned int numAnims = scene->mNumAnimations;
   for (unsigned int i = 0; i < numAnims; ++i) {
@@ -205,27 +445,371 @@ bool AssimpModel::loadModel(VkRenderData& renderData,
     mAnimClips.emplace_back(animClip);
   }
 
-  mModelFilenamePath = modelFilename;
-  mModelFilename =
-      std::filesystem::path(modelFilename).filename().generic_string();
-
   /* get root transformation matrix from model's root node */
   mRootTransformMatrix = Tools::convertAiToGLM(rootNode->mTransformation);
 
-  Logger::log(1, "%s: - model has a total of %i texture%s\n", __FUNCTION__,
-              mTextures.size(), mTextures.size() == 1 ? "" : "s");
-  Logger::log(1, "%s: - model has a total of %i bone%s\n", __FUNCTION__,
-              mBoneList.size(), mBoneList.size() == 1 ? "" : "s");
-  Logger::log(1, "%s: - model has a total of %i animation%s\n", __FUNCTION__,
-              numAnims, numAnims == 1 ? "" : "s");
+  /* a missing cache is not an error, the next start just imports again */
+  if (saveModelCache(cacheFilename, sourceInfo, importFlags, scene)) {
+    Logger::log(1, "%s: wrote model cache '%s'\n", __FUNCTION__,
+                cacheFilename.c_str());
+  } else {
+    Logger::log(1, "%s warning: could not write model cache '%s'\n",
+                __FUNCTION__, cacheFilename.c_str());
+  }
+
+  return true;
+}
+
+bool AssimpModel::saveModelCache(const std::string& cacheFilename,
+                                 const ModelSourceInfo& sourceInfo,
+                                 unsigned int importFlags,
+                                 const aiScene* scene) {
+  ModelCacheWriter writer;
+  writer.write(ModelCache::kMagic);
+  writer.write(ModelCache::kVersion);
+  writer.write(sourceInfo.size);
+  writer.write(sourceInfo.modifiedTime);
+  writer.write(sourceInfo.hash);
+  writer.write(static_cast<uint32_t>(importFlags));
+  writer.write(static_cast<uint32_t>(sizeof(VkVertex)));
+
+  writer.write(static_cast<uint32_t>(mVertexCount));
+  writer.write(static_cast<uint32_t>(mTriangleCount));
+
+  /* embedded textures are stored in their compressed form */
+  writer.write(static_cast<uint32_t>(scene->mNumTextures));
+  for (unsigned int i = 0; i < scene->mNumTextures; ++i) {
+    const aiTexture* texture = scene->mTextures[i];
+    uint64_t dataSize = texture->mHeight == 0
+                            ? texture->mWidth
+                            : static_cast<uint64_t>(texture->mWidth) *
+                                  texture->mHeight * sizeof(aiTexel);
+    writer.writeString(texture->mFilename.C_Str());
+    writer.write(static_cast<uint32_t>(texture->mWidth));
+    writer.write(static_cast<uint32_t>(texture->mHeight));
+    writer.writeBlock(texture->pcData, dataSize);
+  }
+
+  writer.write(static_cast<uint32_t>(mModelMeshes.size()));
+  for (const auto& mesh : mModelMeshes) {
+    writer.writeVector(mesh.vertices);
+    writer.writeVector(mesh.indices);
+    writer.write(static_cast<uint8_t>(mesh.usesPBRColors));
+    writer.writeVector(mesh.packedVertices);
+    writer.write(mesh.packedPositionScale);
+    writer.write(mesh.packedPositionOffset);
+    writer.write(mesh.packedColor);
+    writer.write(static_cast<uint32_t>(mesh.textures.size()));
+    for (const auto& [texType, texName] : mesh.textures) {
+      writer.write(static_cast<uint32_t>(texType));
+      writer.writeString(texName);
+    }
+  }
+
+  /* nodes are stored in insertion order, parents always come first */
+  std::unordered_map<AssimpNode*, int32_t> nodeIndices{};
+  writer.write(static_cast<uint32_t>(mNodeList.size()));
+  for (const auto& node : mNodeList) {
+    int32_t parentIndex = -1;
+    std::shared_ptr<AssimpNode> parentNode = node->getParentNode();
+    if (parentNode) {
+      parentIndex = nodeIndices.at(parentNode.get());
+    }
+    nodeIndices.insert(
+        {node.get(), static_cast<int32_t>(nodeIndices.size())});
+
+    writer.writeString(node->getNodeName());
+    writer.write(parentIndex);
+  }
+
+  writer.write(static_cast<uint32_t>(mBoneList.size()));
+  for (const auto& bone : mBoneList) {
+    writer.write(static_cast<uint32_t>(bone->getBoneId()));
+    writer.writeString(bone->getBoneName());
+    writer.write(bone->getOffsetMatrix());
+  }
+  writer.writeVector(mBoneParentIndexList);
+
+  writer.write(mRootTransformMatrix);
+
+  writer.write(static_cast<uint32_t>(mAnimClips.size()));
+  for (const auto& clip : mAnimClips) {
+    clip->saveToCache(writer);
+  }
+
+  return writer.saveToFile(cacheFilename);
+}
+
+bool AssimpModel::loadModelCache(const std::string& cacheFilename,
+                                 const std::string& modelFilename,
+                                 ModelSourceInfo& sourceInfo,
+                                 unsigned int importFlags,
+                                 const std::string& assetDirectory) {
+  MappedFile cacheFile;
+  if (!cacheFile.open(cacheFilename)) {
+    return false;
+  }
+
+  ModelCacheReader reader(cacheFile.getData(), cacheFile.getSize());
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t cachedSourceSize = 0;
+  int64_t cachedSourceTime = 0;
+  uint64_t cachedSourceHash = 0;
+  uint32_t cachedImportFlags = 0;
+  uint32_t vertexSize = 0;
+  if (!reader.read(magic) || !reader.read(version) ||
+      !reader.read(cachedSourceSize) || !reader.read(cachedSourceTime) ||
+      !reader.read(cachedSourceHash) || !reader.read(cachedImportFlags) ||
+      !reader.read(vertexSize)) {
+    Logger::log(1, "%s: cache file '%s' is truncated, ignoring\n", __FUNCTION__,
+                cacheFilename.c_str());
+    return false;
+  }
+
+  if (magic != ModelCache::kMagic || version != ModelCache::kVersion ||
+      vertexSize != sizeof(VkVertex)) {
+    Logger::log(1, "%s: cache file '%s' has an unknown format, ignoring\n",
+                __FUNCTION__, cacheFilename.c_str());
+    return false;
+  }
+
+  if (cachedImportFlags != importFlags) {
+    Logger::log(1, "%s: cache file '%s' is outdated, ignoring\n", __FUNCTION__,
+                cacheFilename.c_str());
+    return false;
+  }
 
-  Logger::log(1, "%s: successfully loaded model '%s' (%s)\n", __FUNCTION__,
-              modelFilename.c_str(), mModelFilename.c_str());
+  /* same size and time, the source is taken as unchanged without reading
+   * it. a touched or copied file is hashed to be sure */
+  if (cachedSourceSize != sourceInfo.size ||
+      cachedSourceTime != sourceInfo.modifiedTime) {
+    if (!ModelCache::hashFile(modelFilename, sourceInfo.hash)) {
+      return false;
+    }
+    sourceInfo.hashed = true;
+    if (cachedSourceHash != sourceInfo.hash) {
+      Logger::log(1, "%s: cache file '%s' is outdated, ignoring\n",
+                  __FUNCTION__, cacheFilename.c_str());
+      return false;
+    }
+  }
+
+  /* parse everything before creating any Vulkan objects */
+  struct EmbeddedTexture {
+    std::string name;
+    uint32_t width;
+    uint32_t height;
+    const char* data;
+  };
+  std::vector<EmbeddedTexture> embeddedTextures{};
+
+  auto parseCache = [&]() {
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+    if (!reader.read(vertexCount) || !reader.read(triangleCount)) {
+      return false;
+    }
+    mVertexCount = vertexCount;
+    mTriangleCount = triangleCount;
+
+    uint32_t numTextures = 0;
+    if (!reader.read(numTextures)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < numTextures; ++i) {
+      EmbeddedTexture texture{};
+      uint64_t dataSize = 0;
+      if (!reader.readString(texture.name) || !reader.read(texture.width) ||
+          !reader.read(texture.height) ||
+          !reader.readBlock(texture.data, dataSize)) {
+        return false;
+      }
+      embeddedTextures.emplace_back(texture);
+    }
+
+    uint32_t numMeshes = 0;
+    if (!reader.read(numMeshes)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < numMeshes; ++i) {
+      VkMesh mesh{};
+      uint8_t usesPBRColors = 0;
+      uint32_t numMeshTextures = 0;
+      if (!reader.readVector(mesh.vertices) ||
+          !reader.readVector(mesh.indices) || !reader.read(usesPBRColors) ||
+          !reader.readVector(mesh.packedVertices) ||
+          !reader.read(mesh.packedPositionScale) ||
+          !reader.read(mesh.packedPositionOffset) ||
+          !reader.read(mesh.packedColor) || !reader.read(numMeshTextures)) {
+        return false;
+      }
+      mesh.usesPBRColors = usesPBRColors != 0;
+
+      for (uint32_t tex = 0; tex < numMeshTextures; ++tex) {
+        uint32_t texType = 0;
+        std::string texName;
+        if (!reader.read(texType) || !reader.readString(texName)) {
+          return false;
+        }
+        mesh.textures.insert({static_cast<aiTextureType>(texType), texName});
+      }
+      mModelMeshes.emplace_back(std::move(mesh));
+    }
+
+    uint32_t numNodes = 0;
+    if (!reader.read(numNodes)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < numNodes; ++i) {
+      std::string nodeName;
+      int32_t parentIndex = -1;
+      if (!reader.readString(nodeName) || !reader.read(parentIndex)) {
+        return false;
+      }
+
+      std::shared_ptr<AssimpNode> node;
+      if (parentIndex < 0) {
+        if (mRootNode) {
+          return false;
+        }
+        node = AssimpNode::createNode(nodeName);
+        mRootNode = node;
+      } else {
+        if (parentIndex >= static_cast<int32_t>(mNodeList.size())) {
+          return false;
+        }
+        node = mNodeList.at(parentIndex)->addChild(nodeName);
+      }
+      mNodeMap.insert({nodeName, node});
+      mNodeList.emplace_back(node);
+    }
+
+    uint32_t numBones = 0;
+    if (!reader.read(numBones)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < numBones; ++i) {
+      uint32_t boneId = 0;
+      std::string boneName;
+      glm::mat4 offsetMatrix;
+      if (!reader.read(boneId) || !reader.readString(boneName) ||
+          !reader.read(offsetMatrix)) {
+        return false;
+      }
+      mBoneList.emplace_back(
+          std::make_shared<AssimpBone>(boneId, boneName, offsetMatrix));
+    }
+    if (!reader.readVector(mBoneParentIndexList) ||
+        mBoneParentIndexList.size() != mBoneList.size()) {
+      return false;
+    }
+
+    if (!reader.read(mRootTransformMatrix)) {
+      return false;
+    }
+
+    uint32_t numClips = 0;
+    if (!reader.read(numClips)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < numClips; ++i) {
+      std::shared_ptr<AssimpAnimClip> animClip =
+          std::make_shared<AssimpAnimClip>();
+      if (!animClip->loadFromCache(reader)) {
+        return false;
+      }
+      mAnimClips.emplace_back(animClip);
+    }
+
+    return true;
+  };
+
+  if (!parseCache()) {
+    Logger::log(1, "%s: cache file '%s' is damaged, ignoring\n", __FUNCTION__,
+                cacheFilename.c_str());
+    clearModelData();
+    return false;
+  }
+
+  /* decode now, the mapping is closed when we return */
+  for (size_t i = 0; i < embeddedTextures.size(); ++i) {
+    const EmbeddedTexture& texture = embeddedTextures.at(i);
+    VkTextureImage newImage{};
+    if (!Texture::decodeTexture(
+            &newImage, texture.name,
+            reinterpret_cast<const aiTexel*>(texture.data), texture.width,
+            texture.height)) {
+      clearModelData();
+      return false;
+    }
+    mTextureImages.insert({"*" + std::to_string(i), std::move(newImage)});
+  }
+
+  /* external textures are still loaded from their own files */
+  for (const auto& mesh : mModelMeshes) {
+    for (const auto& [_, texName] : mesh.textures) {
+      if (texName.empty() || texName.find("*") == 0 ||
+          mTextureImages.count(texName) > 0) {
+        continue;
+      }
+
+      VkTextureImage newImage{};
+      std::string texNameWithPath = assetDirectory + '/' + texName;
+      if (!Texture::decodeTexture(&newImage, texNameWithPath)) {
+        Logger::log(1, "%s error: could not load texture file '%s', skipping\n",
+                    __FUNCTION__, texNameWithPath.c_str());
+        continue;
+      }
+      mTextureImages.insert({texName, std::move(newImage)});
+    }
+  }
+
+  Logger::log(1,
+              "%s: loaded cache '%s', %i meshes, %i vertices, %i faces, %i "
+              "bones, %i clips\n",
+              __FUNCTION__, cacheFilename.c_str(), mModelMeshes.size(),
+              mVertexCount, mTriangleCount, mBoneList.size(),
+              mAnimClips.size());
+  return true;
+}
+
+/* drops everything a failed cache load may have left behind */
+void AssimpModel::clearModelData() {
+  mTextureImages.clear();
+  mVertexCount = 0;
+  mTriangleCount = 0;
+  mModelMeshes.clear();
+  mRootNode.reset();
+  mNodeMap.clear();
+  mNodeList.clear();
+  mBoneList.clear();
+  mBoneParentIndexList.clear();
+  mAnimClips.clear();
+  mRootTransformMatrix = glm::mat4(1.0f);
+}
+
+bool AssimpModel::decodeDefaultTextures() {
+  /* add a white texture in case there is no diffuse tex but colors */
+  std::string whiteTexName = "textures/white.png";
+  if (!Texture::decodeTexture(&mWhiteTextureImage, whiteTexName)) {
+    Logger::log(1, "%s error: could not load white default texture '%s'\n",
+                __FUNCTION__, whiteTexName.c_str());
+    return false;
+  }
+
+  /* add a placeholder texture in case there is no diffuse tex */
+  std::string placeholderTexName = "textures/missing_tex.png";
+  if (!Texture::decodeTexture(&mPlaceholderTextureImage, placeholderTexName)) {
+    Logger::log(1, "%s error: could not load placeholder texture '%s'\n",
+                __FUNCTION__, placeholderTexName.c_str());
+    return false;
+  }
   return true;
 }
 
-void AssimpModel::processNode(VkRenderData& renderData,
-                              std::shared_ptr<AssimpNode> node, aiNode* aNode,
+void AssimpModel::processNode(std::shared_ptr<AssimpNode> node, aiNode* aNode,
                               const aiScene* scene,
                               const std::string& assetDirectory) {
   std::string nodeName = aNode->mName.C_Str();
@@ -238,13 +822,20 @@ void AssimpModel::processNode(VkRenderData& renderData,
       aiMesh* modelMesh = scene->mMeshes[aNode->mMeshes[i]];
 
       AssimpMesh mesh;
-      mesh.processMesh(renderData, modelMesh, scene, assetDirectory, mTextures);
+      mesh.processMesh(modelMesh, scene, assetDirectory, mTextureImages);
 
       mModelMeshes.emplace_back(mesh.getMesh());
+      mLoadProgress.store(
+          kImportProgressShare +
+          (kMeshProgressShare - kImportProgressShare) *
+              std::min(static_cast<float>(mModelMeshes.size()) /
+                           static_cast<float>(scene->mNumMeshes),
+                       1.0f));
 
       /* avoid inserting duplicate bone Ids - meshes can reference the same
        * bones */
-      std::vector<std::shared_ptr<AssimpBone>> flatBones = mesh.getBoneList();
+      const std::vector<std::shared_ptr<AssimpBone>>& flatBones =
+          mesh.getBoneList();
       for (const auto& bone : flatBones) {
         const auto iter =
             std::find_if(mBoneList.begin(), mBoneList.end(),
@@ -270,8 +861,7 @@ void AssimpModel::processNode(VkRenderData& renderData,
                 childName.c_str());
 
     std::shared_ptr<AssimpNode> childNode = node->addChild(childName);
-    processNode(renderData, childNode, aNode->mChildren[i], scene,
-                assetDirectory);
+    processNode(childNode, aNode->mChildren[i], scene, assetDirectory);
   }
 }
 
@@ -332,8 +922,68 @@ bool AssimpModel::createDescriptorSet(const VkRenderData& renderData) {
   boneOffsetWriteDescriptorSet.descriptorCount = 1;
   boneOffsetWriteDescriptorSet.pBufferInfo = &boneOffsetInfo;
 
+  VkDescriptorBufferInfo boneLevelInfo{};
+  boneLevelInfo.buffer = mShaderBoneLevelBuffer.buffer;
+  boneLevelInfo.offset = 0;
+  boneLevelInfo.range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet boneLevelWriteDescriptorSet{};
+  boneLevelWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  boneLevelWriteDescriptorSet.descriptorType =
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  boneLevelWriteDescriptorSet.dstSet = mMatrixMultPerModelDescriptorSet;
+  boneLevelWriteDescriptorSet.dstBinding = 2;
+  boneLevelWriteDescriptorSet.descriptorCount = 1;
+  boneLevelWriteDescriptorSet.pBufferInfo = &boneLevelInfo;
+
+  /* keyframe sampling */
+  VkDescriptorBufferInfo animChannelInfo{};
+  animChannelInfo.buffer = mShaderAnimChannelBuffer.buffer;
+  animChannelInfo.offset = 0;
+  animChannelInfo.range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet animChannelWriteDescriptorSet{};
+  animChannelWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  animChannelWriteDescriptorSet.descriptorType =
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  animChannelWriteDescriptorSet.dstSet = mMatrixMultPerModelDescriptorSet;
+  animChannelWriteDescriptorSet.dstBinding = 3;
+  animChannelWriteDescriptorSet.descriptorCount = 1;
+  animChannelWriteDescriptorSet.pBufferInfo = &animChannelInfo;
+
+  VkDescriptorBufferInfo animKeyTimeInfo{};
+  animKeyTimeInfo.buffer = mShaderAnimKeyTimeBuffer.buffer;
+  animKeyTimeInfo.offset = 0;
+  animKeyTimeInfo.range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet animKeyTimeWriteDescriptorSet{};
+  animKeyTimeWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  animKeyTimeWriteDescriptorSet.descriptorType =
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  animKeyTimeWriteDescriptorSet.dstSet = mMatrixMultPerModelDescriptorSet;
+  animKeyTimeWriteDescriptorSet.dstBinding = 4;
+  animKeyTimeWriteDescriptorSet.descriptorCount = 1;
+  animKeyTimeWriteDescriptorSet.pBufferInfo = &animKeyTimeInfo;
+
+  VkDescriptorBufferInfo animKeyValueInfo{};
+  animKeyValueInfo.buffer = mShaderAnimKeyValueBuffer.buffer;
+  animKeyValueInfo.offset = 0;
+  animKeyValueInfo.range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet animKeyValueWriteDescriptorSet{};
+  animKeyValueWriteDescriptorSet.sType =
+      VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  animKeyValueWriteDescriptorSet.descriptorType =
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  animKeyValueWriteDescriptorSet.dstSet = mMatrixMultPerModelDescriptorSet;
+  animKeyValueWriteDescriptorSet.dstBinding = 5;
+  animKeyValueWriteDescriptorSet.descriptorCount = 1;
+  animKeyValueWriteDescriptorSet.pBufferInfo = &animKeyValueInfo;
+
   std::vector<VkWriteDescriptorSet> matrixMultWriteDescriptorSets = {
-      parentNodeWriteDescriptorSet, boneOffsetWriteDescriptorSet};
+      parentNodeWriteDescriptorSet, boneOffsetWriteDescriptorSet,
+      boneLevelWriteDescriptorSet, animChannelWriteDescriptorSet,
+      animKeyTimeWriteDescriptorSet, animKeyValueWriteDescriptorSet};
 
   vkUpdateDescriptorSets(
       renderData.rdVkbDevice.device,
@@ -343,124 +993,425 @@ bool AssimpModel::createDescriptorSet(const VkRenderData& renderData) {
   return true;
 }
 
+bool AssimpModel::createBakedAnimDescriptorSet(const VkRenderData& renderData) {
+  /* baked bone matrices for the skinning shader */
+  VkDescriptorSetAllocateInfo bakedAnimDescriptorAllocateInfo{};
+  bakedAnimDescriptorAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  bakedAnimDescriptorAllocateInfo.descriptorPool = renderData.rdDescriptorPool;
+  bakedAnimDescriptorAllocateInfo.descriptorSetCount = 1;
+  bakedAnimDescriptorAllocateInfo.pSetLayouts =
+      &renderData.rdAssimpSkinningBakedPerModelDescriptorLayout;
+
+  VkResult result = vkAllocateDescriptorSets(renderData.rdVkbDevice.device,
+                                             &bakedAnimDescriptorAllocateInfo,
+                                             &mBakedAnimPerModelDescriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate Assimp baked animation "
+                "per-model descriptor set (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  VkDescriptorBufferInfo bakedMatrixInfo{};
+  bakedMatrixInfo.buffer = mShaderBakedBoneMatrixBuffer.buffer;
+  bakedMatrixInfo.offset = 0;
+  bakedMatrixInfo.range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet bakedMatrixWriteDescriptorSet{};
+  bakedMatrixWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  bakedMatrixWriteDescriptorSet.descriptorType =
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bakedMatrixWriteDescriptorSet.dstSet = mBakedAnimPerModelDescriptorSet;
+  bakedMatrixWriteDescriptorSet.dstBinding = 0;
+  bakedMatrixWriteDescriptorSet.descriptorCount = 1;
+  bakedMatrixWriteDescriptorSet.pBufferInfo = &bakedMatrixInfo;
+
+  vkUpdateDescriptorSets(renderData.rdVkbDevice.device, 1,
+                         &bakedMatrixWriteDescriptorSet, 0, nullptr);
+
+  return true;
+}
+
 glm::mat4 AssimpModel::getRootTranformationMatrix() {
   return mRootTransformMatrix;
 }
 
-void AssimpModel::draw(VkRenderData& renderData) {
-  for (unsigned int i = 0; i < mModelMeshes.size(); ++i) {
-    VkMesh& mesh = mModelMeshes.at(i);
+bool AssimpModel::usesPackedVertices() { return mPackedVertices; }
 
-    // find diffuse texture by name
-    VkTextureData diffuseTex{};
-    auto diffuseTexName = mesh.textures.find(aiTextureType_DIFFUSE);
-    if (diffuseTexName != mesh.textures.end()) {
-      auto diffuseTexture = mTextures.find(diffuseTexName->second);
-      if (diffuseTexture != mTextures.end()) {
-        diffuseTex = diffuseTexture->second;
-      }
+size_t AssimpModel::getVertexBufferSize() { return mVertexBufferSize; }
+
+const std::vector<VkMeshDrawRecord>& AssimpModel::getDrawRecords(
+    const VkRenderData& renderData) {
+  if (mDrawRecordGeneration != GeometryArena::getGeneration(renderData)) {
+    updateDrawRecordOffsets(renderData);
+  }
+  return mMeshDrawRecords;
+}
+
+void AssimpModel::updateDrawRecordOffsets(const VkRenderData& renderData) {
+  for (unsigned int i = 0; i < mMeshDrawRecords.size(); ++i) {
+    VkDrawIndexedIndirectCommand& command = mMeshDrawRecords.at(i).command;
+    command.firstIndex =
+        GeometryArena::getFirstIndex(renderData, mMeshRanges.at(i));
+    command.vertexOffset =
+        GeometryArena::getVertexOffset(renderData, mMeshRanges.at(i));
+  }
+  mDrawRecordGeneration = GeometryArena::getGeneration(renderData);
+}
+
+uint32_t AssimpModel::getMeshCount() {
+  return static_cast<uint32_t>(mModelMeshes.size());
+}
+
+unsigned int AssimpModel::getTriangleCount() { return mTriangleCount; }
+
+glm::vec4 AssimpModel::getBoundingSphere() { return mBoundingSphere; }
+
+glm::vec4 AssimpModel::getAnimClipBoundingSphere(unsigned int clipNr) {
+  if (clipNr >= mAnimClipBoundingSpheres.size()) {
+    return mBoundingSphere;
+  }
+  return mAnimClipBoundingSpheres.at(clipNr);
+}
+
+void AssimpModel::calculateBounds() {
+  glm::vec3 minPos = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 maxPos = glm::vec3(std::numeric_limits<float>::lowest());
+  bool hasVertices = false;
+  for (const auto& mesh : mModelMeshes) {
+    for (const auto& vertex : mesh.vertices) {
+      minPos = glm::min(minPos, glm::vec3(vertex.position));
+      maxPos = glm::max(maxPos, glm::vec3(vertex.position));
+      hasVertices = true;
     }
+  }
 
-    /* switch between animated and non-animated pipeline layout */
-    VkPipelineLayout renderLayout;
-    if (hasAnimations()) {
-      renderLayout = renderData.rdAssimpSkinningPipelineLayout;
-    } else {
-      renderLayout = renderData.rdAssimpPipelineLayout;
+  if (!hasVertices) {
+    mBoundingSphere = glm::vec4(0.0f);
+    return;
+  }
+
+  glm::vec3 center = (minPos + maxPos) * 0.5f;
+  float radius = 0.0f;
+  for (const auto& mesh : mModelMeshes) {
+    for (const auto& vertex : mesh.vertices) {
+      radius =
+          std::max(radius, glm::length(glm::vec3(vertex.position) - center));
     }
+  }
 
-    if (diffuseTex.image != VK_NULL_HANDLE) {
-      vkCmdBindDescriptorSets(renderData.rdCommandBuffer,
-                              VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout, 0,
-                              1, &diffuseTex.descSet, 0, nullptr);
-    } else {
-      if (mesh.usesPBRColors) {
-        vkCmdBindDescriptorSets(renderData.rdCommandBuffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout,
-                                0, 1, &mWhiteTexture.descSet, 0, nullptr);
-      } else {
-        vkCmdBindDescriptorSets(renderData.rdCommandBuffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout,
-                                0, 1, &mPlaceholderTexture.descSet, 0, nullptr);
+  mBoundingSphere = glm::vec4(center, radius);
+  Logger::log(1,
+              "%s: bounding box %f/%f/%f to %f/%f/%f, sphere at %f/%f/%f with "
+              "radius %f\n",
+              __FUNCTION__, minPos.x, minPos.y, minPos.z, maxPos.x, maxPos.y,
+              maxPos.z, center.x, center.y, center.z, radius);
+}
+
+void AssimpModel::calculateAnimClipBounds() {
+  mAnimClipBoundingSpheres.clear();
+  if (mAnimClips.empty() || mBoneList.empty()) {
+    return;
+  }
+
+  /* a skinned vertex is a weighted average of its bone transforms, so it
+   * stays inside the union of the transformed boxes of its bones */
+  std::vector<glm::vec3> boneMinPos(
+      mBoneList.size(), glm::vec3(std::numeric_limits<float>::max()));
+  std::vector<glm::vec3> boneMaxPos(
+      mBoneList.size(), glm::vec3(std::numeric_limits<float>::lowest()));
+  for (const auto& mesh : mModelMeshes) {
+    for (const auto& vertex : mesh.vertices) {
+      for (int i = 0; i < 4; ++i) {
+        unsigned int boneId = vertex.boneNum[i];
+        if (vertex.boneWeights[i] > 0.0f && boneId < mBoneList.size()) {
+          boneMinPos.at(boneId) =
+              glm::min(boneMinPos.at(boneId), glm::vec3(vertex.position));
+          boneMaxPos.at(boneId) =
+              glm::max(boneMaxPos.at(boneId), glm::vec3(vertex.position));
+        }
       }
     }
-
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(renderData.rdCommandBuffer, 0, 1,
-                           &mVertexBuffers.at(i).buffer, &offset);
-    vkCmdBindIndexBuffer(renderData.rdCommandBuffer, mIndexBuffers.at(i).buffer,
-                         0, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(renderData.rdCommandBuffer,
-                     static_cast<uint32_t>(mesh.indices.size()), 1, 0, 0, 0);
   }
-}
 
-void AssimpModel::drawInstanced(VkRenderData& renderData,
-                                uint32_t instanceCount) {
-  for (unsigned int i = 0; i < mModelMeshes.size(); ++i) {
-    VkMesh& mesh = mModelMeshes.at(i);
+  std::vector<NodeTransformData> nodeTransforms(mBoneList.size());
+  std::vector<glm::mat4> trsMatrices(mBoneList.size());
+
+  for (const auto& clip : mAnimClips) {
+    glm::vec3 clipMinPos = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 clipMaxPos = glm::vec3(std::numeric_limits<float>::lowest());
+    AnimClipCursor cursor{};
+
+    for (unsigned int sample = 0; sample < kAnimBoundsSamples; ++sample) {
+      float time = clip->getClipDuration() * sample / kAnimBoundsSamples;
+      clip->samplePose(time, cursor, nodeTransforms);
+
+      /* same matrices as the compute shaders */
+      for (size_t i = 0; i < mBoneList.size(); ++i) {
+        const NodeTransformData& data = nodeTransforms.at(i);
+        glm::quat rotation = glm::quat(data.rotation.w, data.rotation.x,
+                                       data.rotation.y, data.rotation.z);
+        trsMatrices.at(i) =
+            glm::translate(glm::mat4(1.0f), glm::vec3(data.translation)) *
+            glm::mat4_cast(rotation) *
+            glm::scale(glm::mat4(1.0f), glm::vec3(data.scale));
+      }
 
-    // find diffuse texture by name
-    VkTextureData diffuseTex{};
-    auto diffuseTexName = mesh.textures.find(aiTextureType_DIFFUSE);
-    if (diffuseTexName != mesh.textures.end()) {
-      auto diffuseTexture = mTextures.find(diffuseTexName->second);
-      if (diffuseTexture != mTextures.end()) {
-        diffuseTex = diffuseTexture->second;
+      for (size_t i = 0; i < mBoneList.size(); ++i) {
+        /* bone without vertices */
+        if (boneMinPos.at(i).x > boneMaxPos.at(i).x) {
+          continue;
+        }
+
+        glm::mat4 nodeMatrix = trsMatrices.at(i);
+        for (int32_t parent = mBoneParentIndexList.at(i); parent >= 0;
+             parent = mBoneParentIndexList.at(parent)) {
+          nodeMatrix = trsMatrices.at(parent) * nodeMatrix;
+        }
+        glm::mat4 skinMatrix = nodeMatrix * mBoneList.at(i)->getOffsetMatrix();
+
+        for (int corner = 0; corner < 8; ++corner) {
+          glm::vec3 cornerPos =
+              glm::vec3(corner & 1 ? boneMaxPos.at(i).x : boneMinPos.at(i).x,
+                        corner & 2 ? boneMaxPos.at(i).y : boneMinPos.at(i).y,
+                        corner & 4 ? boneMaxPos.at(i).z : boneMinPos.at(i).z);
+          glm::vec3 skinnedPos =
+              glm::vec3(skinMatrix * glm::vec4(cornerPos, 1.0f));
+          clipMinPos = glm::min(clipMinPos, skinnedPos);
+          clipMaxPos = glm::max(clipMaxPos, skinnedPos);
+        }
       }
     }
 
-    /* switch between animated and non-animated pipeline layout */
-    VkPipelineLayout renderLayout;
-    if (hasAnimations()) {
-      renderLayout = renderData.rdAssimpSkinningPipelineLayout;
-    } else {
-      renderLayout = renderData.rdAssimpPipelineLayout;
+    /* no skinned vertices at all */
+    if (clipMinPos.x > clipMaxPos.x) {
+      mAnimClipBoundingSpheres.emplace_back(mBoundingSphere);
+      continue;
     }
 
-    if (diffuseTex.image != VK_NULL_HANDLE) {
-      vkCmdBindDescriptorSets(renderData.rdCommandBuffer,
-                              VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout, 0,
-                              1, &diffuseTex.descSet, 0, nullptr);
-    } else {
-      if (mesh.usesPBRColors) {
-        vkCmdBindDescriptorSets(renderData.rdCommandBuffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout,
-                                0, 1, &mWhiteTexture.descSet, 0, nullptr);
-      } else {
-        vkCmdBindDescriptorSets(renderData.rdCommandBuffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout,
-                                0, 1, &mPlaceholderTexture.descSet, 0, nullptr);
+    glm::vec3 center = (clipMinPos + clipMaxPos) * 0.5f;
+    float radius =
+        glm::length(clipMaxPos - clipMinPos) * 0.5f * kAnimBoundsPadding;
+    mAnimClipBoundingSpheres.emplace_back(center, radius);
+
+    Logger::log(1, "%s: clip '%s' bounding sphere at %f/%f/%f with radius %f\n",
+                __FUNCTION__, clip->getClipName().c_str(), center.x, center.y,
+                center.z, radius);
+  }
+}
+
+void AssimpModel::calculateBoneLevels() {
+  size_t numBones = mBoneList.size();
+
+  /* depth in the bone hierarchy, root bones are on level 0 */
+  std::vector<uint32_t> boneLevels(numBones, 0);
+  uint32_t levelCount = 0;
+  for (size_t i = 0; i < numBones; ++i) {
+    for (int32_t parent = mBoneParentIndexList.at(i); parent >= 0;
+         parent = mBoneParentIndexList.at(parent)) {
+      ++boneLevels.at(i);
+    }
+    levelCount = std::max(levelCount, boneLevels.at(i) + 1);
+  }
+
+  /* counting sort by level, parents always end up in front of children */
+  mBoneLevelData.assign(2 + levelCount + numBones, 0);
+  mBoneLevelData.at(0) = levelCount;
+  uint32_t* levelStart = mBoneLevelData.data() + 1;
+  for (uint32_t level : boneLevels) {
+    ++levelStart[level + 1];
+  }
+  for (uint32_t level = 0; level < levelCount; ++level) {
+    levelStart[level + 1] += levelStart[level];
+  }
+
+  std::vector<uint32_t> insertPos(levelStart, levelStart + levelCount);
+  uint32_t* sortedBones = levelStart + levelCount + 1;
+  for (uint32_t i = 0; i < numBones; ++i) {
+    sortedBones[insertPos.at(boneLevels.at(i))++] = i;
+  }
+
+  Logger::log(1, "%s: %i bone%s in %i hierarchy level%s\n", __FUNCTION__,
+              numBones, numBones == 1 ? "" : "s", levelCount,
+              levelCount == 1 ? "" : "s");
+}
+
+void AssimpModel::collectAnimClipKeys() {
+  mAnimChannelGpuData.clear();
+  mAnimKeyTimes.clear();
+  mAnimKeyValues.clear();
+  if (mAnimClips.empty() || mBoneList.empty()) {
+    return;
+  }
+
+  for (const auto& clip : mAnimClips) {
+    clip->appendGpuKeys(mBoneList.size(), mAnimChannelGpuData, mAnimKeyTimes,
+                        mAnimKeyValues);
+  }
+
+  size_t keyDataSize =
+      mAnimChannelGpuData.size() * sizeof(AnimChannelGpuData) +
+      mAnimKeyTimes.size() * sizeof(float) +
+      mAnimKeyValues.size() * sizeof(glm::vec4);
+  Logger::log(1, "%s: %i keys of %i clip%s use %i bytes on the GPU\n",
+              __FUNCTION__, mAnimKeyTimes.size(), mAnimClips.size(),
+              mAnimClips.size() == 1 ? "" : "s", keyDataSize);
+}
+
+bool AssimpModel::bakeAnimations(VkRenderData& renderData) {
+  if (mAnimBakeFailed || mAnimClips.empty() || mBoneList.empty()) {
+    return false;
+  }
+
+  Timer bakeTimer;
+  bakeTimer.start();
+
+  size_t numBones = mBoneList.size();
+  size_t frameSize = numBones * sizeof(glm::mat4);
+  uint32_t maxClipFrames = static_cast<uint32_t>(
+      std::max(kMaxBakedClipSize / frameSize, static_cast<size_t>(2)));
+
+  /* bones sorted by hierarchy level, parents are always done first */
+  uint32_t levelCount = mBoneLevelData.at(0);
+  const uint32_t* sortedBones = mBoneLevelData.data() + levelCount + 2;
+
+  std::vector<glm::mat4> bakedMatrices{};
+  std::vector<NodeTransformData> nodeTransforms(numBones);
+  std::vector<glm::mat4> nodeMatrices(numBones);
+  mBakedAnimClips.clear();
+
+  for (const auto& clip : mAnimClips) {
+    float ticksPerSecond = clip->getClipTicksPerSecond() > 0.0f
+                               ? clip->getClipTicksPerSecond()
+                               : 1.0f;
+    float clipSeconds = clip->getClipDuration() / ticksPerSecond;
+    uint32_t frameCount =
+        static_cast<uint32_t>(std::ceil(clipSeconds * kBakedAnimFrameRate)) +
+        1;
+    bool frameRateReduced = frameCount > maxClipFrames;
+    frameCount =
+        std::clamp(frameCount, static_cast<uint32_t>(2), maxClipFrames);
+
+    BakedAnimClip bakedClip{};
+    bakedClip.matrixOffset = static_cast<uint32_t>(bakedMatrices.size());
+    bakedClip.frameCount = frameCount;
+    mBakedAnimClips.emplace_back(bakedClip);
+
+    AnimClipCursor cursor{};
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+      float time = clip->getClipDuration() * frame / (frameCount - 1);
+      clip->samplePose(time, cursor, nodeTransforms);
+
+      /* same matrices as the compute shaders */
+      for (size_t i = 0; i < numBones; ++i) {
+        uint32_t bone = sortedBones[i];
+        const NodeTransformData& data = nodeTransforms.at(bone);
+        glm::quat rotation = glm::quat(data.rotation.w, data.rotation.x,
+                                       data.rotation.y, data.rotation.z);
+        glm::mat4 trsMatrix =
+            glm::translate(glm::mat4(1.0f), glm::vec3(data.translation)) *
+            glm::mat4_cast(rotation) *
+            glm::scale(glm::mat4(1.0f), glm::vec3(data.scale));
+
+        int32_t parent = mBoneParentIndexList.at(bone);
+        nodeMatrices.at(bone) =
+            parent < 0 ? trsMatrix : nodeMatrices.at(parent) * trsMatrix;
+      }
+
+      for (size_t i = 0; i < numBones; ++i) {
+        bakedMatrices.emplace_back(nodeMatrices.at(i) *
+                                   mBoneList.at(i)->getOffsetMatrix());
       }
     }
 
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(renderData.rdCommandBuffer, 0, 1,
-                           &mVertexBuffers.at(i).buffer, &offset);
-    vkCmdBindIndexBuffer(renderData.rdCommandBuffer, mIndexBuffers.at(i).buffer,
-                         0, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(renderData.rdCommandBuffer,
-                     static_cast<uint32_t>(mesh.indices.size()), instanceCount,
-                     0, 0, 0);
+    Logger::log(1, "%s: clip '%s' baked into %i frames, %i bytes%s\n",
+                __FUNCTION__, clip->getClipName().c_str(), frameCount,
+                frameCount * frameSize,
+                frameRateReduced ? " (frame rate reduced to fit the limit)"
+                                 : "");
+  }
+
+  mBakedAnimationSize = bakedMatrices.size() * sizeof(glm::mat4);
+  if (!ShaderStorageBuffer::init(renderData, &mShaderBakedBoneMatrixBuffer,
+                                 mBakedAnimationSize) ||
+      !ShaderStorageBuffer::uploadSSBOData(
+          renderData, &mShaderBakedBoneMatrixBuffer, bakedMatrices) ||
+      !createBakedAnimDescriptorSet(renderData)) {
+    Logger::log(1, "%s error: could not upload baked animations of '%s'\n",
+                __FUNCTION__, mModelFilename.c_str());
+    mAnimBakeFailed = true;
+    mBakedAnimClips.clear();
+    mBakedAnimationSize = 0;
+    return false;
   }
+
+  Logger::log(1, "%s: %i clip%s of '%s' baked into %i bytes in %f ms\n",
+              __FUNCTION__, mBakedAnimClips.size(),
+              mBakedAnimClips.size() == 1 ? "" : "s", mModelFilename.c_str(),
+              mBakedAnimationSize, bakeTimer.stop());
+  return true;
 }
 
-unsigned int AssimpModel::getTriangleCount() { return mTriangleCount; }
+bool AssimpModel::hasBakedAnimations() { return !mBakedAnimClips.empty(); }
+
+VkBakedInstanceData AssimpModel::getBakedInstanceData(unsigned int clipNr,
+                                                      float playTime) {
+  VkBakedInstanceData bakedData{};
+  if (clipNr >= mBakedAnimClips.size()) {
+    return bakedData;
+  }
+
+  const BakedAnimClip& bakedClip = mBakedAnimClips.at(clipNr);
+  float clipDuration = mAnimClips.at(clipNr)->getClipDuration();
+  float framePos = 0.0f;
+  if (clipDuration > 0.0f) {
+    framePos = std::clamp(playTime / clipDuration, 0.0f, 1.0f) *
+               (bakedClip.frameCount - 1);
+  }
+  uint32_t frame =
+      std::min(static_cast<uint32_t>(framePos), bakedClip.frameCount - 2);
+
+  uint32_t numBones = static_cast<uint32_t>(mBoneList.size());
+  bakedData.frameOffset = bakedClip.matrixOffset + frame * numBones;
+  bakedData.nextFrameOffset = bakedData.frameOffset + numBones;
+  bakedData.blend = framePos - static_cast<float>(frame);
+  return bakedData;
+}
+
+size_t AssimpModel::getBakedAnimationSize() { return mBakedAnimationSize; }
+
+void AssimpModel::setDualQuatSkinning(bool enable) {
+  mDualQuatSkinning = enable;
+}
+
+bool AssimpModel::getDualQuatSkinning() { return mDualQuatSkinning; }
 
 void AssimpModel::cleanup(VkRenderData& renderData) {
   vkFreeDescriptorSets(renderData.rdVkbDevice.device,
                        renderData.rdDescriptorPool, 1,
                        &mMatrixMultPerModelDescriptorSet);
-
-  for (auto& buffer : mVertexBuffers) {
-    VertexBuffer::cleanup(renderData, &buffer);
+  if (mBakedAnimPerModelDescriptorSet != VK_NULL_HANDLE) {
+    vkFreeDescriptorSets(renderData.rdVkbDevice.device,
+                         renderData.rdDescriptorPool, 1,
+                         &mBakedAnimPerModelDescriptorSet);
   }
-  for (auto& buffer : mIndexBuffers) {
-    IndexBuffer::cleanup(renderData, &buffer);
+
+  /* the next defragment closes the holes */
+  for (auto& meshRanges : mMeshRanges) {
+    GeometryArena::freeMesh(renderData, &meshRanges);
   }
+  mMeshRanges.clear();
+  mMeshDrawRecords.clear();
 
   ShaderStorageBuffer::cleanup(renderData, &mShaderBoneMatrixOffsetBuffer);
   ShaderStorageBuffer::cleanup(renderData, &mShaderBoneParentBuffer);
+  ShaderStorageBuffer::cleanup(renderData, &mShaderBoneLevelBuffer);
+  ShaderStorageBuffer::cleanup(renderData, &mShaderAnimChannelBuffer);
+  ShaderStorageBuffer::cleanup(renderData, &mShaderAnimKeyTimeBuffer);
+  ShaderStorageBuffer::cleanup(renderData, &mShaderAnimKeyValueBuffer);
+  ShaderStorageBuffer::cleanup(renderData, &mShaderBakedBoneMatrixBuffer);
 
   for (auto& [_, tex] : mTextures) {
     Texture::cleanup(renderData, &tex);
@@ -499,6 +1450,10 @@ VkDescriptorSet& AssimpModel::getMatrixMultDescriptorSet() {
   return mMatrixMultPerModelDescriptorSet;
 }
 
+VkDescriptorSet& AssimpModel::getBakedAnimDescriptorSet() {
+  return mBakedAnimPerModelDescriptorSet;
+}
+
 const std::vector<std::shared_ptr<AssimpAnimClip>>&
 AssimpModel::getAnimClips() {
   return mAnimClips;
@@ -1,6 +1,7 @@
 /* Assimp model, ready to draw */
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
@@ -11,21 +12,51 @@
 #include "AssimpAnimClip.h"
 #include "AssimpMesh.h"
 #include "AssimpNode.h"
-#include "IndexBuffer.h"
+#include "ModelCache.h"
 #include "Texture.h"
-#include "VertexBuffer.h"
 #include "VkRenderData.h"
 
+/* one clip baked into final bone matrices, the frames are evenly spaced over
+ * the clip duration, first and last frame included */
+struct BakedAnimClip {
+  uint32_t matrixOffset = 0;
+  uint32_t frameCount = 0;
+};
+
 class AssimpModel {
  public:
   bool loadModel(VkRenderData& renderData, const std::string& modelFilename,
                  unsigned int extraImportFlags = 0);
+  /* CPU part of the loading, does not touch Vulkan and may run on any thread */
+  bool loadModelData(const std::string& modelFilename,
+                     unsigned int extraImportFlags = 0);
+  /* same for a unit box standing on the ground, no file involved */
+  bool loadBoxModelData(const std::string& modelName);
+  /* creates the Vulkan objects, must run on the render thread */
+  bool uploadModelData(VkRenderData& renderData);
+
+  /* 0.0 to 1.0, may be read while another thread loads the model */
+  float getLoadProgress();
+  void cancelLoading();
+
   glm::mat4 getRootTranformationMatrix();
 
-  void draw(VkRenderData& renderData);
-  void drawInstanced(VkRenderData& renderData, uint32_t instanceCount);
+  /* one record per mesh, the arena offsets are refreshed here if the
+   * geometry arena was reallocated since the last call */
+  const std::vector<VkMeshDrawRecord>& getDrawRecords(
+      const VkRenderData& renderData);
+  uint32_t getMeshCount();
   unsigned int getTriangleCount();
 
+  /* quantized vertex buffers, decided on upload */
+  bool usesPackedVertices();
+  size_t getVertexBufferSize();
+
+  /* bind pose bounds in model space, xyz is the center, w the radius */
+  glm::vec4 getBoundingSphere();
+  /* conservative bounds of all poses of a clip, same space as above */
+  glm::vec4 getAnimClipBoundingSphere(unsigned int clipNr);
+
   std::string getModelFileName();
   std::string getModelFileNamePath();
 
@@ -43,17 +74,53 @@ class AssimpModel {
 
   VkDescriptorSet& getMatrixMultDescriptorSet();
 
+  /* optional, samples all clips at a fixed rate into final bone matrices.
+   * the skinning shader blends two baked frames, no compute passes needed */
+  bool bakeAnimations(VkRenderData& renderData);
+  bool hasBakedAnimations();
+  /* baked frames around the play time, the offsets are bone matrices */
+  VkBakedInstanceData getBakedInstanceData(unsigned int clipNr,
+                                           float playTime);
+  size_t getBakedAnimationSize();
+  VkDescriptorSet& getBakedAnimDescriptorSet();
+
+  /* rigid skinning with two vec4 per bone instead of a mat4, bone scaling
+   * is lost */
+  void setDualQuatSkinning(bool enable);
+  bool getDualQuatSkinning();
+
   void cleanup(VkRenderData& renderData);
 
  private:
-  void processNode(VkRenderData& renderData, std::shared_ptr<AssimpNode> node,
-                   aiNode* aNode, const aiScene* scene,
-                   const std::string& assetDirectory);
+  void processNode(std::shared_ptr<AssimpNode> node, aiNode* aNode,
+                   const aiScene* scene, const std::string& assetDirectory);
   void createNodeList(std::shared_ptr<AssimpNode> node,
                       std::shared_ptr<AssimpNode> newNode,
                       std::vector<std::shared_ptr<AssimpNode>>& list);
 
+  bool importModel(const std::string& modelFilename, unsigned int importFlags,
+                   const std::string& assetDirectory,
+                   const std::string& cacheFilename,
+                   const ModelSourceInfo& sourceInfo);
+  bool saveModelCache(const std::string& cacheFilename,
+                      const ModelSourceInfo& sourceInfo,
+                      unsigned int importFlags, const aiScene* scene);
+  /* hashes the source only if its size or time differ, the hash is kept
+   * in sourceInfo for the import */
+  bool loadModelCache(const std::string& cacheFilename,
+                      const std::string& modelFilename,
+                      ModelSourceInfo& sourceInfo, unsigned int importFlags,
+                      const std::string& assetDirectory);
+  void clearModelData();
+  bool decodeDefaultTextures();
+  void calculateBounds();
+  void calculateAnimClipBounds();
+  void calculateBoneLevels();
+  void collectAnimClipKeys();
+  void updateDrawRecordOffsets(const VkRenderData& renderData);
+
 	bool createDescriptorSet(const VkRenderData& renderData);
+  bool createBakedAnimDescriptorSet(const VkRenderData& renderData);
 
   unsigned int mTriangleCount = 0;
   unsigned int mVertexCount = 0;
@@ -66,25 +133,72 @@ class AssimpModel {
   std::vector<std::shared_ptr<AssimpNode>> mNodeList{};
 
   std::vector<std::shared_ptr<AssimpBone>> mBoneList;
+  std::vector<int32_t> mBoneParentIndexList{};
+  /* level count, start of every level plus the end, bones sorted by level */
+  std::vector<uint32_t> mBoneLevelData{};
 
   std::vector<std::shared_ptr<AssimpAnimClip>> mAnimClips{};
 
+  /* keys of all clips for sampling on the GPU, one channel entry per clip
+   * and bone */
+  std::vector<AnimChannelGpuData> mAnimChannelGpuData{};
+  std::vector<float> mAnimKeyTimes{};
+  std::vector<glm::vec4> mAnimKeyValues{};
+
+  /* baked poses, only the GPU buffer keeps the matrices */
+  std::vector<BakedAnimClip> mBakedAnimClips{};
+  size_t mBakedAnimationSize = 0;
+  bool mAnimBakeFailed = false;
+
+  bool mDualQuatSkinning = false;
+
+  bool mPackedVertices = false;
+  size_t mVertexBufferSize = 0;
+
   std::vector<VkMesh> mModelMeshes{};
-  std::vector<VkVertexBufferData> mVertexBuffers{};
-  std::vector<VkIndexBufferData> mIndexBuffers{};
+  /* vertices and indices live in the geometry arena */
+  std::vector<VkMeshRanges> mMeshRanges{};
+  /* built on upload, the texture is the diffuse, white or placeholder one */
+  std::vector<VkMeshDrawRecord> mMeshDrawRecords{};
+  uint32_t mDrawRecordGeneration = 0;
 
 	VkShaderStorageBufferData mShaderBoneParentBuffer{};
   VkShaderStorageBufferData mShaderBoneMatrixOffsetBuffer{};
+  VkShaderStorageBufferData mShaderBoneLevelBuffer{};
+  VkShaderStorageBufferData mShaderAnimChannelBuffer{};
+  VkShaderStorageBufferData mShaderAnimKeyTimeBuffer{};
+  VkShaderStorageBufferData mShaderAnimKeyValueBuffer{};
+  VkShaderStorageBufferData mShaderBakedBoneMatrixBuffer{};
 
   // map textures to external or internal texture names
   std::unordered_map<std::string, VkTextureData> mTextures{};
   VkTextureData mPlaceholderTexture{};
   VkTextureData mWhiteTexture{};
 
+  /* decoded images, kept between loadModelData() and uploadModelData() */
+  std::unordered_map<std::string, VkTextureImage> mTextureImages{};
+  VkTextureImage mPlaceholderTextureImage{};
+  VkTextureImage mWhiteTextureImage{};
+
+  std::atomic<float> mLoadProgress = 0.0f;
+  std::atomic<bool> mCancelLoad = false;
+
   glm::mat4 mRootTransformMatrix = glm::mat4(1.0f);
+  glm::vec4 mBoundingSphere = glm::vec4(0.0f);
+  std::vector<glm::vec4> mAnimClipBoundingSpheres{};
+
+  /* poses sampled per clip, the padding covers the poses in between */
+  static constexpr unsigned int kAnimBoundsSamples = 64;
+  static constexpr float kAnimBoundsPadding = 1.1f;
+
+  /* baked frames per second of clip time, clips larger than the limit get
+   * fewer frames, but never less than two */
+  static constexpr float kBakedAnimFrameRate = 30.0f;
+  static constexpr size_t kMaxBakedClipSize = 8 * 1024 * 1024;
 
   std::string mModelFilenamePath;
   std::string mModelFilename;
 
 	VkDescriptorSet mMatrixMultPerModelDescriptorSet = VK_NULL_HANDLE;
+  VkDescriptorSet mBakedAnimPerModelDescriptorSet = VK_NULL_HANDLE;
 };
@@ -58,7 +58,7 @@ void AssimpNode::setRootTransformMatrix(glm::mat4 matrix) {
   mRootTransformMatrix = matrix;
 }
 
-std::string AssimpNode::getNodeName() {
+const std::string& AssimpNode::getNodeName() {
   return mNodeName;
 }
 
@@ -76,7 +76,7 @@ std::string AssimpNode::getParentNodeName() {
   return std::string("(invalid)");
 }
 
-std::vector<std::shared_ptr<AssimpNode>> AssimpNode::getChilds() {
+const std::vector<std::shared_ptr<AssimpNode>>& AssimpNode::getChilds() {
   return mChildNodes;
 }
 
@@ -24,11 +24,11 @@ class AssimpNode : public std::enable_shared_from_this<AssimpNode>  {
     void updateTRSMatrix();
     glm::mat4 getTRSMatrix();
 
-    std::string getNodeName();
+    const std::string& getNodeName();
     std::shared_ptr<AssimpNode> getParentNode();
     std::string getParentNodeName();
 
-    std::vector<std::shared_ptr<AssimpNode>> getChilds();
+    const std::vector<std::shared_ptr<AssimpNode>>& getChilds();
     std::vector<std::string> getChildNames();
 
   private:
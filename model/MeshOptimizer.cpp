@@ -0,0 +1,238 @@
+#include "MeshOptimizer.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+  /* scoring constants from the paper */
+  constexpr float kCacheDecayPower = 1.5f;
+  constexpr float kLastTriangleScore = 0.75f;
+  constexpr float kValenceBoostScale = 2.0f;
+  constexpr float kValenceBoostPower = 0.5f;
+
+  float getVertexScore(int cachePosition, uint32_t remainingTriangles) {
+    /* no triangle left, never pick it */
+    if (remainingTriangles == 0) {
+      return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+      /* the vertices of the last triangle get a fixed score, so the next
+       * triangle does not prefer one of its edges */
+      if (cachePosition < 3) {
+        score = kLastTriangleScore;
+      } else {
+        const float scaler =
+            1.0f / static_cast<float>(MeshOptimizer::kCacheSize - 3);
+        score = std::pow(1.0f - (cachePosition - 3) * scaler,
+                         kCacheDecayPower);
+      }
+    }
+
+    /* vertices with few triangles left are finished first */
+    score += kValenceBoostScale *
+             std::pow(static_cast<float>(remainingTriangles),
+                      -kValenceBoostPower);
+    return score;
+  }
+
+  /* 64 bit FNV-1a, same as the model cache uses for files */
+  uint64_t hashVertex(const unsigned char* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= data[i];
+      hash *= 0x100000001b3ull;
+    }
+    return hash;
+  }
+}
+
+size_t MeshOptimizer::weldVertices(const void* vertices, size_t vertexCount,
+                                   size_t vertexSize,
+                                   std::vector<uint32_t>& remap) {
+  const unsigned char* vertexData = static_cast<const unsigned char*>(vertices);
+  remap.assign(vertexCount, kUnusedVertex);
+
+  /* open addressing, the table stores the first vertex of every value */
+  size_t tableSize = 1;
+  while (tableSize < vertexCount * 2) {
+    tableSize *= 2;
+  }
+  std::vector<uint32_t> table(tableSize, kUnusedVertex);
+
+  uint32_t uniqueCount = 0;
+  for (size_t i = 0; i < vertexCount; ++i) {
+    const unsigned char* vertex = vertexData + i * vertexSize;
+    size_t slot = hashVertex(vertex, vertexSize) & (tableSize - 1);
+
+    while (table[slot] != kUnusedVertex &&
+           std::memcmp(vertexData + table[slot] * vertexSize, vertex,
+                       vertexSize) != 0) {
+      slot = (slot + 1) & (tableSize - 1);
+    }
+
+    if (table[slot] == kUnusedVertex) {
+      table[slot] = static_cast<uint32_t>(i);
+      remap[i] = uniqueCount++;
+    } else {
+      remap[i] = remap[table[slot]];
+    }
+  }
+  return uniqueCount;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices,
+                                        size_t vertexCount) {
+  size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+
+  /* triangles of every vertex, the not yet emitted ones come first */
+  std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+  for (const auto index : indices) {
+    ++remainingTriangles[index];
+  }
+
+  std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    triangleOffsets[i + 1] = triangleOffsets[i] + remainingTriangles[i];
+  }
+
+  std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+  std::vector<uint32_t> fillCount(vertexCount, 0);
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    uint32_t vertex = indices[i];
+    vertexTriangles[triangleOffsets[vertex] + fillCount[vertex]++] =
+        static_cast<uint32_t>(i / 3);
+  }
+
+  std::vector<int> cachePositions(vertexCount, -1);
+  std::vector<float> vertexScores(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    vertexScores[i] = getVertexScore(-1, remainingTriangles[i]);
+  }
+
+  std::vector<uint8_t> triangleEmitted(triangleCount, 0);
+
+  std::vector<uint32_t> newIndices{};
+  newIndices.reserve(indices.size());
+
+  /* room for the whole cache plus the three new vertices */
+  std::vector<uint32_t> cache{};
+  std::vector<uint32_t> newCache{};
+  cache.reserve(kCacheSize + 3);
+  newCache.reserve(kCacheSize + 3);
+
+  int64_t bestTriangle = -1;
+  size_t nextUnusedTriangle = 0;
+  for (size_t emitted = 0; emitted < triangleCount; ++emitted) {
+    /* nothing in the cache has triangles left, continue with the first
+     * remaining one instead of a full scan */
+    if (bestTriangle < 0) {
+      while (triangleEmitted[nextUnusedTriangle]) {
+        ++nextUnusedTriangle;
+      }
+      bestTriangle = static_cast<int64_t>(nextUnusedTriangle);
+    }
+
+    triangleEmitted[bestTriangle] = 1;
+    newCache.clear();
+    for (int i = 0; i < 3; ++i) {
+      uint32_t vertex = indices[bestTriangle * 3 + i];
+      newIndices.emplace_back(vertex);
+      newCache.emplace_back(vertex);
+
+      /* move the triangle behind the remaining ones of the vertex */
+      uint32_t* triangles = vertexTriangles.data() + triangleOffsets[vertex];
+      uint32_t remaining = remainingTriangles[vertex];
+      for (uint32_t j = 0; j < remaining; ++j) {
+        if (triangles[j] == static_cast<uint32_t>(bestTriangle)) {
+          triangles[j] = triangles[remaining - 1];
+          triangles[remaining - 1] = static_cast<uint32_t>(bestTriangle);
+          break;
+        }
+      }
+      --remainingTriangles[vertex];
+    }
+
+    /* the triangle goes to the front, the rest of the cache moves back */
+    for (const auto vertex : cache) {
+      if (vertex != newCache[0] && vertex != newCache[1] &&
+          vertex != newCache[2]) {
+        newCache.emplace_back(vertex);
+      }
+    }
+
+    for (size_t i = 0; i < newCache.size(); ++i) {
+      uint32_t vertex = newCache[i];
+      cachePositions[vertex] = i < kCacheSize ? static_cast<int>(i) : -1;
+      vertexScores[vertex] =
+          getVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+    }
+
+    /* only the triangles of the changed vertices have a new score, pick the
+     * best of them */
+    bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (const auto vertex : newCache) {
+      const uint32_t* triangles =
+          vertexTriangles.data() + triangleOffsets[vertex];
+      for (uint32_t j = 0; j < remainingTriangles[vertex]; ++j) {
+        uint32_t triangle = triangles[j];
+        float score = vertexScores[indices[triangle * 3]] +
+                      vertexScores[indices[triangle * 3 + 1]] +
+                      vertexScores[indices[triangle * 3 + 2]];
+        if (score > bestScore) {
+          bestScore = score;
+          bestTriangle = triangle;
+        }
+      }
+    }
+
+    if (newCache.size() > kCacheSize) {
+      newCache.resize(kCacheSize);
+    }
+    std::swap(cache, newCache);
+  }
+
+  indices = std::move(newIndices);
+}
+
+size_t MeshOptimizer::optimizeVertexFetch(const std::vector<uint32_t>& indices,
+                                          size_t vertexCount,
+                                          std::vector<uint32_t>& remap) {
+  remap.assign(vertexCount, kUnusedVertex);
+
+  uint32_t nextVertex = 0;
+  for (const auto index : indices) {
+    if (remap[index] == kUnusedVertex) {
+      remap[index] = nextVertex++;
+    }
+  }
+  return nextVertex;
+}
+
+float MeshOptimizer::calculateACMR(const std::vector<uint32_t>& indices,
+                                   size_t vertexCount,
+                                   unsigned int cacheSize) {
+  size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return 0.0f;
+  }
+
+  /* a vertex is still in the FIFO if less than cacheSize misses happened
+   * since it was loaded */
+  std::vector<uint32_t> loadTime(vertexCount, 0);
+  uint32_t missCount = 0;
+  uint32_t time = cacheSize + 1;
+  for (const auto index : indices) {
+    if (time - loadTime[index] > cacheSize) {
+      loadTime[index] = time++;
+      ++missCount;
+    }
+  }
+  return static_cast<float>(missCount) / static_cast<float>(triangleCount);
+}
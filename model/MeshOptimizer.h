@@ -0,0 +1,35 @@
+/* index and vertex order optimizations, run once on mesh import */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MeshOptimizer {
+  public:
+    /* remap entry of vertices no triangle uses */
+    static constexpr uint32_t kUnusedVertex = 0xffffffff;
+    /* FIFO size for the ACMR and the cache position scores */
+    static constexpr unsigned int kCacheSize = 32;
+
+    /* merges vertices with identical bytes, remap[old] is the new index of
+     * the vertex. returns the new vertex count */
+    static size_t weldVertices(const void* vertices, size_t vertexCount,
+                               size_t vertexSize, std::vector<uint32_t>& remap);
+
+    /* Forsyth's linear-speed vertex cache optimization, reorders the
+     * triangles in place */
+    static void optimizeVertexCache(std::vector<uint32_t>& indices,
+                                    size_t vertexCount);
+
+    /* numbers the vertices in the order the triangles use them, unused
+     * vertices get kUnusedVertex. returns the used vertex count */
+    static size_t optimizeVertexFetch(const std::vector<uint32_t>& indices,
+                                      size_t vertexCount,
+                                      std::vector<uint32_t>& remap);
+
+    /* average cache miss ratio, vertex shader runs per triangle */
+    static float calculateACMR(const std::vector<uint32_t>& indices,
+                               size_t vertexCount,
+                               unsigned int cacheSize = kCacheSize);
+};
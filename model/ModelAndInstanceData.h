@@ -26,6 +26,11 @@ using instanceCenterCallback = std::function<void(std::shared_ptr<AssimpInstance
 using undoRedoCallback = std::function<void(void)>;
 using ApplyCallback = std::function<void(const class InstanceSettings&)>;
 
+struct ModelLoadProgress {
+  std::string modelFileName;
+  float progress = 0.0f;
+};
+
 struct ModelAndInstanceData {
   std::vector<std::shared_ptr<AssimpModel>> miModelList{};
   int miSelectedModel = 0;
@@ -42,6 +47,9 @@ struct ModelAndInstanceData {
 
   std::unordered_set<std::shared_ptr<AssimpModel>> miPendingDeleteAssimpModels{};
 
+  /* models still loading in the background, updated every frame */
+  std::vector<ModelLoadProgress> miModelLoadProgress{};
+
   /* callbacks */
   modelCheckCallback miModelCheckCallbackFunction;
   modelAddCallback miModelAddCallbackFunction;
@@ -0,0 +1,144 @@
+#include "ModelCache.h"
+
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+
+#include "Logger.h"
+#include "MappedFile.h"
+
+void ModelCacheWriter::writeString(const std::string& value) {
+  write(static_cast<uint32_t>(value.size()));
+  mBuffer.insert(mBuffer.end(), value.begin(), value.end());
+}
+
+void ModelCacheWriter::writeBlock(const void* data, uint64_t size) {
+  write(size);
+  align();
+  const char* bytes = static_cast<const char*>(data);
+  mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+}
+
+void ModelCacheWriter::align() {
+  size_t padding = (ModelCache::kBlockAlignment -
+                    mBuffer.size() % ModelCache::kBlockAlignment) %
+                   ModelCache::kBlockAlignment;
+  mBuffer.insert(mBuffer.end(), padding, 0);
+}
+
+bool ModelCacheWriter::saveToFile(const std::string& fileName) {
+  /* write to a temporary file first, a crash must not leave a broken cache */
+  std::string tempFileName = fileName + ".tmp";
+  std::ofstream outFile(tempFileName, std::ios::binary | std::ios::trunc);
+  if (!outFile.is_open()) {
+    Logger::log(1, "%s error: could not open file '%s' (%s)\n", __FUNCTION__,
+                tempFileName.c_str(), strerror(errno));
+    return false;
+  }
+
+  outFile.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+  outFile.close();
+  if (outFile.fail()) {
+    Logger::log(1, "%s error: could not write file '%s'\n", __FUNCTION__,
+                tempFileName.c_str());
+    std::filesystem::remove(tempFileName);
+    return false;
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tempFileName, fileName, error);
+  if (error) {
+    Logger::log(1, "%s error: could not rename '%s' to '%s' (%s)\n",
+                __FUNCTION__, tempFileName.c_str(), fileName.c_str(),
+                error.message().c_str());
+    std::filesystem::remove(tempFileName, error);
+    return false;
+  }
+
+  return true;
+}
+
+ModelCacheReader::ModelCacheReader(const char* data, size_t size)
+    : mData(data), mSize(size) {}
+
+bool ModelCacheReader::readString(std::string& value) {
+  uint32_t length = 0;
+  if (!read(length) || mSize - mOffset < length) {
+    return false;
+  }
+  value.assign(mData + mOffset, length);
+  mOffset += length;
+  return true;
+}
+
+bool ModelCacheReader::readBlock(const char*& data, uint64_t& size) {
+  if (!read(size) || !align() || mSize - mOffset < size) {
+    return false;
+  }
+  data = mData + mOffset;
+  mOffset += size;
+  return true;
+}
+
+bool ModelCacheReader::align() {
+  size_t padding = (ModelCache::kBlockAlignment -
+                    mOffset % ModelCache::kBlockAlignment) %
+                   ModelCache::kBlockAlignment;
+  if (mSize - mOffset < padding) {
+    return false;
+  }
+  mOffset += padding;
+  return true;
+}
+
+std::string ModelCache::getCacheFileName(const std::string& modelFileName) {
+  return modelFileName + ".vkcache";
+}
+
+bool ModelCache::getSourceInfo(const std::string& fileName,
+                               ModelSourceInfo& info) {
+  std::error_code error;
+  uint64_t size = std::filesystem::file_size(fileName, error);
+  if (error) {
+    Logger::log(1, "%s error: could not get size of file '%s' (%s)\n",
+                __FUNCTION__, fileName.c_str(), error.message().c_str());
+    return false;
+  }
+  auto modifiedTime = std::filesystem::last_write_time(fileName, error);
+  if (error) {
+    Logger::log(1, "%s error: could not get time of file '%s' (%s)\n",
+                __FUNCTION__, fileName.c_str(), error.message().c_str());
+    return false;
+  }
+
+  info = ModelSourceInfo{};
+  info.size = size;
+  info.modifiedTime =
+      static_cast<int64_t>(modifiedTime.time_since_epoch().count());
+  return true;
+}
+
+bool ModelCache::hashFile(const std::string& fileName, uint64_t& hash) {
+  MappedFile file;
+  if (!file.open(fileName)) {
+    Logger::log(1, "%s error: could not open file '%s'\n", __FUNCTION__,
+                fileName.c_str());
+    return false;
+  }
+
+  const unsigned char* data =
+      reinterpret_cast<const unsigned char*>(file.getData());
+  const size_t numWords = file.getSize() / sizeof(uint64_t);
+  hash = 14695981039346656037ull;
+  for (size_t i = 0; i < numWords; ++i) {
+    uint64_t word;
+    std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+    hash ^= word;
+    hash *= 1099511628211ull;
+  }
+  for (size_t i = numWords * sizeof(uint64_t); i < file.getSize(); ++i) {
+    hash ^= data[i];
+    hash *= 1099511628211ull;
+  }
+  return true;
+}
@@ -0,0 +1,106 @@
+/* binary cache of an imported model, avoids running Assimp again */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* appends plain data to a memory buffer, written to disk in one go */
+class ModelCacheWriter {
+  public:
+    template <typename T>
+    void write(const T& value) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const char* data = reinterpret_cast<const char*>(&value);
+      mBuffer.insert(mBuffer.end(), data, data + sizeof(T));
+    }
+
+    void writeString(const std::string& value);
+
+    /* bulk data is aligned, so the reader can use it in place */
+    template <typename T>
+    void writeVector(const std::vector<T>& values) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      writeBlock(values.data(), values.size() * sizeof(T));
+    }
+    void writeBlock(const void* data, uint64_t size);
+
+    bool saveToFile(const std::string& fileName);
+
+  private:
+    void align();
+
+    std::vector<char> mBuffer{};
+};
+
+/* reads from a (mapped) memory area, every read is bounds checked */
+class ModelCacheReader {
+  public:
+    ModelCacheReader(const char* data, size_t size);
+
+    template <typename T>
+    bool read(T& value) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      if (mSize - mOffset < sizeof(T)) {
+        return false;
+      }
+      std::memcpy(&value, mData + mOffset, sizeof(T));
+      mOffset += sizeof(T);
+      return true;
+    }
+
+    bool readString(std::string& value);
+
+    template <typename T>
+    bool readVector(std::vector<T>& values) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const char* data = nullptr;
+      uint64_t size = 0;
+      if (!readBlock(data, size) || size % sizeof(T) != 0) {
+        return false;
+      }
+      values.resize(size / sizeof(T));
+      if (size > 0) {
+        std::memcpy(values.data(), data, size);
+      }
+      return true;
+    }
+
+    /* returns a pointer into the source memory, no copy is made */
+    bool readBlock(const char*& data, uint64_t& size);
+
+  private:
+    bool align();
+
+    const char* mData = nullptr;
+    size_t mSize = 0;
+    size_t mOffset = 0;
+};
+
+/* identifies the source file of a cache. the hash is only computed if the
+ * size or the modification time differ from the cached ones */
+struct ModelSourceInfo {
+  uint64_t size = 0;
+  int64_t modifiedTime = 0;
+  uint64_t hash = 0;
+  bool hashed = false;
+};
+
+class ModelCache {
+  public:
+    /* 'VKMC' */
+    static constexpr uint32_t kMagic = 0x434d4b56;
+    /* increase on every change of the file layout */
+    static constexpr uint32_t kVersion = 4;
+    static constexpr size_t kBlockAlignment = 16;
+
+    static std::string getCacheFileName(const std::string& modelFileName);
+    /* size and modification time only, the file is not read */
+    static bool getSourceInfo(const std::string& fileName,
+                              ModelSourceInfo& info);
+    /* 64 bit FNV-1a over 8 byte words of the whole file, the tail bytes
+     * are added one by one */
+    static bool hashFile(const std::string& fileName, uint64_t& hash);
+};
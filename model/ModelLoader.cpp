@@ -0,0 +1,110 @@
+#include "ModelLoader.h"
+
+#include <algorithm>
+
+#include "AssimpModel.h"
+#include "Logger.h"
+
+ModelLoader::~ModelLoader() { cleanup(); }
+
+bool ModelLoader::init(unsigned int numThreads) {
+  cleanup();
+
+  numThreads = std::max(numThreads, 1u);
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    std::unique_ptr<LoaderThread> loaderThread =
+        std::make_unique<LoaderThread>();
+    loaderThread->thread = std::thread(loaderLoop, loaderThread.get());
+    mLoaderThreads.emplace_back(std::move(loaderThread));
+  }
+
+  Logger::log(1, "%s: model loader started with %i thread%s\n", __FUNCTION__,
+              numThreads, numThreads == 1 ? "" : "s");
+  return true;
+}
+
+void ModelLoader::cleanup() {
+  if (mLoaderThreads.empty()) {
+    return;
+  }
+
+  for (const auto& request : mPendingRequests) {
+    request.model->cancelLoading();
+  }
+
+  /* an empty request stops the thread after the current load */
+  for (const auto& loaderThread : mLoaderThreads) {
+    loaderThread->requests.enqueue(ModelLoadRequest{});
+  }
+  for (const auto& loaderThread : mLoaderThreads) {
+    loaderThread->thread.join();
+  }
+
+  mLoaderThreads.clear();
+  mPendingRequests.clear();
+  mLoadProgress.clear();
+}
+
+void ModelLoader::loadModel(std::shared_ptr<AssimpModel> model,
+                            const std::string& modelFileName) {
+  /* use the thread with the least work */
+  const auto loaderThread = std::min_element(
+      mLoaderThreads.begin(), mLoaderThreads.end(),
+      [](const auto& first, const auto& second) {
+        return first->pendingLoads < second->pendingLoads;
+      });
+
+  ModelLoadRequest request{model, modelFileName};
+  mPendingRequests.emplace_back(request);
+  (*loaderThread)->pendingLoads++;
+  (*loaderThread)->requests.enqueue(std::move(request));
+}
+
+bool ModelLoader::getFinishedModel(ModelLoadResult& result) {
+  for (const auto& loaderThread : mLoaderThreads) {
+    if (loaderThread->results.try_dequeue(result)) {
+      loaderThread->pendingLoads--;
+      mPendingRequests.erase(
+          std::remove_if(mPendingRequests.begin(), mPendingRequests.end(),
+                         [&result](const ModelLoadRequest& request) {
+                           return request.model == result.model;
+                         }),
+          mPendingRequests.end());
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ModelLoader::isLoading(const std::string& modelFileName) {
+  return std::any_of(mPendingRequests.begin(), mPendingRequests.end(),
+                     [&modelFileName](const ModelLoadRequest& request) {
+                       return request.modelFileName == modelFileName;
+                     });
+}
+
+const std::vector<ModelLoadProgress>& ModelLoader::getLoadProgress() {
+  mLoadProgress.clear();
+  for (const auto& request : mPendingRequests) {
+    mLoadProgress.emplace_back(
+        ModelLoadProgress{request.modelFileName, request.model->getLoadProgress()});
+  }
+  return mLoadProgress;
+}
+
+void ModelLoader::loaderLoop(LoaderThread* loaderThread) {
+  while (true) {
+    ModelLoadRequest request;
+    loaderThread->requests.wait_dequeue(request);
+    if (!request.model) {
+      break;
+    }
+
+    ModelLoadResult result;
+    result.model = request.model;
+    result.modelFileName = request.modelFileName;
+    result.success = request.model->loadModelData(request.modelFileName);
+
+    loaderThread->results.enqueue(std::move(result));
+  }
+}
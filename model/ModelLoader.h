@@ -0,0 +1,57 @@
+/* loads models on background threads, the GPU upload stays on the render thread */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <readerwriterqueue.h>
+
+#include "ModelAndInstanceData.h"
+
+class AssimpModel;
+
+struct ModelLoadRequest {
+  std::shared_ptr<AssimpModel> model = nullptr;
+  std::string modelFileName;
+};
+
+struct ModelLoadResult {
+  std::shared_ptr<AssimpModel> model = nullptr;
+  std::string modelFileName;
+  bool success = false;
+};
+
+class ModelLoader {
+  public:
+    ~ModelLoader();
+
+    bool init(unsigned int numThreads);
+    /* running imports are cancelled, finished but unclaimed models dropped */
+    void cleanup();
+
+    /* all calls below are for the render thread only */
+    void loadModel(std::shared_ptr<AssimpModel> model,
+                   const std::string& modelFileName);
+    /* returns false if no model has finished since the last call */
+    bool getFinishedModel(ModelLoadResult& result);
+
+    bool isLoading(const std::string& modelFileName);
+    const std::vector<ModelLoadProgress>& getLoadProgress();
+
+  private:
+    /* every thread has its own pair of single producer/consumer queues */
+    struct LoaderThread {
+      std::thread thread;
+      moodycamel::BlockingReaderWriterQueue<ModelLoadRequest> requests{};
+      moodycamel::ReaderWriterQueue<ModelLoadResult> results{};
+      unsigned int pendingLoads = 0;
+    };
+
+    static void loaderLoop(LoaderThread* loaderThread);
+
+    std::vector<std::unique_ptr<LoaderThread>> mLoaderThreads{};
+    std::vector<ModelLoadRequest> mPendingRequests{};
+    std::vector<ModelLoadProgress> mLoadProgress{};
+};
@@ -0,0 +1,10 @@
+/* per-node animation result, layout matches the compute shader input */
+#pragma once
+
+#include <glm/glm.hpp>
+
+struct NodeTransformData {
+	glm::vec4 translation{0.f};
+	glm::vec4 scale{1.f};
+	glm::vec4 rotation{1.f, 0.f, 0.f, 0.f};
+};
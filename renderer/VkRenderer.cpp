@@ -5,6 +5,8 @@
 #include <ctime>
 #include <filesystem>
 #include <glm/gtc/matrix_transform.hpp>
+#include <span>
+#include <thread>
 
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
@@ -15,13 +17,19 @@
 #include "CommandBuffer.h"
 #include "CommandPool.h"
 #include "ComputePipeline.h"
+#include "DrawRecord.h"
 #include "Framebuffer.h"
+#include "GeometryArena.h"
+#include "FrustumCuller.h"
 #include "InstanceSettings.h"
 #include "Logger.h"
 #include "PipelineLayout.h"
 #include "Renderpass.h"
+#include "SecondaryCommandBuffer.h"
 #include "SkinningPipeline.h"
 #include "SyncObjects.h"
+#include "TextureTable.h"
+#include "UploadManager.h"
 #include "VkRenderer.h"
 
 VkRenderer::VkRenderer(GLFWwindow* window) { mRenderData.rdWindow = window; }
@@ -64,6 +72,10 @@ bool VkRenderer::init(unsigned int width, unsigned int height) {
     return false;
   }
 
+  if (!createSelectionReadbacks()) {
+    return false;
+  }
+
   if (!createCommandPool()) {
     return false;
   }
@@ -72,6 +84,11 @@ bool VkRenderer::init(unsigned int width, unsigned int height) {
     return false;
   }
 
+  if (!UploadManager::init(mRenderData, kUploadRingSize)) {
+    return false;
+  }
+  GeometryArena::init(mRenderData);
+
   if (!createMatrixUBO()) {
     return false;
   }
@@ -112,10 +129,25 @@ bool VkRenderer::init(unsigned int width, unsigned int height) {
     return false;
   }
 
+  if (!createTimestampQueries()) {
+    return false;
+  }
+
   if (!initUserInterface()) {
     return false;
   }
 
+  if (!mJobSystem.init(mRenderData.rdNumAnimationWorkers)) {
+    return false;
+  }
+  mRenderData.rdNumAnimationWorkers = mJobSystem.getNumWorkers();
+  mRenderData.rdMaxAnimationWorkers =
+      std::max(std::thread::hardware_concurrency(), 1u);
+
+  if (!mModelLoader.init(kModelLoaderThreads)) {
+    return false;
+  }
+
   /* register callbacks */
   mModelInstData.miModelCheckCallbackFunction = [this](std::string fileName) {
     return hasModel(fileName);
@@ -164,6 +196,16 @@ bool VkRenderer::init(unsigned int width, unsigned int height) {
   mModelInstData.miAssimpInstances.emplace_back(nullInstance);
   assignInstanceIndices();
 
+  /* shown in place of the models still loading */
+  mPlaceholderModel = std::make_shared<AssimpModel>();
+  if (!mPlaceholderModel->loadBoxModelData(kPlaceholderModelName) ||
+      !mPlaceholderModel->uploadModelData(mRenderData) ||
+      !UploadManager::flush(mRenderData)) {
+    Logger::log(1, "%s error: could not create placeholder model\n",
+                __FUNCTION__);
+    return false;
+  }
+
   /* init the central settings container */
   mModelInstData.miSettingsContainer =
       std::make_shared<AssimpSettingsContainer>(nullInstance);
@@ -220,10 +262,15 @@ bool VkRenderer::draw() {
   mRenderData.rdUploadToVBOTime = 0.0f;
   mRenderData.rdUIGenerateTime = 0.0f;
 
-  /* Wait for the prev frame */
+  /* Wait until the GPU is done with the resources of this frame slot */
+  const uint32_t frame = mRenderData.rdCurrentFrame;
+  mRenderData.rdCommandBuffer = mRenderData.rdCommandBuffers.at(frame);
+  mRenderData.rdComputeCommandBuffer =
+      mRenderData.rdComputeCommandBuffers.at(frame);
+
   VkResult result = VK_SUCCESS;
-  std::vector<VkFence> waitFences = {mRenderData.rdComputeFence,
-                                     mRenderData.rdRenderFence};
+  std::vector<VkFence> waitFences = {mRenderData.rdComputeFences.at(frame),
+                                     mRenderData.rdRenderFences.at(frame)};
   result = vkWaitForFences(mRenderData.rdVkbDevice.device,
                            static_cast<uint32_t>(waitFences.size()),
                            waitFences.data(), VK_TRUE, UINT64_MAX);
@@ -233,11 +280,79 @@ bool VkRenderer::draw() {
     return false;
   }
 
+  /* the picking copy of the last use of this frame slot has finished */
+  if (mSelectionReadbacks.at(frame).pending) {
+    int selectedInstanceId = Framebuffer::getSelectionReadbackValue(
+        mRenderData, &mSelectionReadbacks.at(frame));
+    if (mRenderData.rdApplicationMode == appMode::edit) {
+      if (0 < selectedInstanceId &&
+          selectedInstanceId <
+              static_cast<int>(mModelInstData.miAssimpInstances.size())) {
+        mModelInstData.miSelectedInstance = selectedInstanceId;
+      } else {
+        mModelInstData.miSelectedInstance = 0;
+      }
+    }
+  }
+
+  /* culling results of the last use of this frame slot */
+  if (mCullFrameInstanceCounts.at(frame) > 0 &&
+      mRenderData.rdCullingMode != cullingMode::cpu) {
+    VkIndirectDrawHeader drawHeader{};
+    if (FrameRingBuffer::readFrameData(mRenderData, mDrawCommandBuffer, frame,
+                                       0, &drawHeader,
+                                       sizeof(VkIndirectDrawHeader))) {
+      size_t testedInstances = mCullFrameInstanceCounts.at(frame);
+      mRenderData.rdVisibleInstances = std::min(
+          static_cast<size_t>(drawHeader.visibleInstances), testedInstances);
+      mRenderData.rdCulledInstances =
+          testedInstances - mRenderData.rdVisibleInstances;
+    }
+  }
+
+  /* skinning timestamps of the last use of this frame slot */
+  if (mTimestampsPending.at(frame)) {
+    uint64_t timestamps[2] = {};
+    result = vkGetQueryPoolResults(
+        mRenderData.rdVkbDevice.device, mTimestampQueryPool, 2 * frame, 2,
+        sizeof(timestamps), timestamps, sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (result == VK_SUCCESS) {
+      mRenderData.rdSkinningComputeTime =
+          static_cast<float>(timestamps[1] - timestamps[0]) *
+          mTimestampPeriod / 1000000.0f;
+    }
+    mTimestampsPending.at(frame) = false;
+  }
+
+  /* recycle the staging memory of finished uploads */
+  if (!UploadManager::retire(mRenderData)) {
+    return false;
+  }
+
+  /* free deleted models before the new ones take their arena space */
+  deletePendingModels();
+
+  /* upload the models finished by the loader threads */
+  processLoadedModels();
+
+  /* the fence wait above guarantees the GPU is done with these slices */
+  FrameRingBuffer::beginFrame(&mPerspectiveViewMatrixUBO, frame);
+  FrameRingBuffer::beginFrame(&mShaderNodeTransformBuffer, frame);
+  FrameRingBuffer::beginFrame(&mSelectedInstanceBuffer, frame);
+  FrameRingBuffer::beginFrame(&mShaderModelRootMatrixBuffer, frame);
+  FrameRingBuffer::beginFrame(&mCullInstanceBuffer, frame);
+  FrameRingBuffer::beginFrame(&mDrawCommandBuffer, frame);
+  FrameRingBuffer::beginFrame(&mAnimInstanceBuffer, frame);
+  FrameRingBuffer::beginFrame(&mBakedInstanceBuffer, frame);
+  FrameRingBuffer::beginFrame(&mDrawDataBuffer, frame);
+
   /* Render buffer acquisition */
   uint32_t imageIndex = 0;
   result = vkAcquireNextImageKHR(
       mRenderData.rdVkbDevice.device, mRenderData.rdVkbSwapchain.swapchain,
-      UINT64_MAX, mRenderData.rdPresentSemaphore, VK_NULL_HANDLE, &imageIndex);
+      UINT64_MAX, mRenderData.rdPresentSemaphores.at(frame), VK_NULL_HANDLE,
+      &imageIndex);
   if (result == VK_ERROR_OUT_OF_DATE_KHR) {
     return recreateSwapchain();
   } else {
@@ -249,52 +364,79 @@ bool VkRenderer::draw() {
     }
   }
 
-  result = vkResetFences(mRenderData.rdVkbDevice.device, 1,
-                         &mRenderData.rdRenderFence);
-  if (result != VK_SUCCESS) {
-    Logger::log(1, "%s error:  fence reset failed (error: %i)\n", __FUNCTION__,
-                result);
-    return false;
-  }
-
   /* Update view proj matrix */
-  mMatrices.proj = glm::perspective(
-      glm::radians(static_cast<float>(mRenderData.rdFOV)),
-      static_cast<float>(mRenderData.rdVkbSwapchain.extent.width) /
-          static_cast<float>(mRenderData.rdVkbSwapchain.extent.height),
-      0.1f, 500.0f);
-  mMatrices.view = mCamera->getViewMatrix();
+  updateMatrices();
 
   /* Upload UBO */
   mUploadToUBOTimer.start();
-  UniformBuffer::uploadData(mRenderData, &mPerspectiveViewMatrixUBO, mMatrices);
+  FrameRingBuffer::uploadFrameData(mRenderData, &mPerspectiveViewMatrixUBO,
+                                   &mMatrices, sizeof(VkUploadMatrices),
+                                   &mMatrixDynamicOffset);
   mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
+  /* with CPU culling only the visible instances are uploaded and drawn */
+  const auto& instancesPerModel =
+      mRenderData.rdCullingMode == cullingMode::cpu
+          ? mVisibleInstancesPerModel
+          : mModelInstData.miAssimpInstancesPerModel;
+
   /* Update model matrix SSBO */
   /* calculate the size of the node matrix buffer over all animated instances */
   size_t boneMatrixBufferSize = 0;
-  for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
+  /* the bone palette is counted in vec4, dual quaternions use two per bone */
+  size_t bonePaletteSize = 0;
+  size_t numInstancesToDraw = 0;
+  /* mesh commands per pipeline, the commands are grouped by pipeline */
+  std::array<uint32_t, kNumDrawPipelines> pipelineCommandCounts{};
+  for (const auto& [_, instances] : instancesPerModel) {
     size_t numInstances = instances.size();
+    numInstancesToDraw += numInstances;
     std::shared_ptr<AssimpModel> model = instances.at(0)->getModel();
     if (numInstances > 0 && model->getTriangleCount() > 0) {
-      /* animated models */
-      if (model->hasAnimations() && !model->getBoneList().empty()) {
+      pipelineCommandCounts.at(static_cast<size_t>(getDrawPipeline(model))) +=
+          model->getMeshCount();
+
+      /* animated models, baked animations need no node or bone matrices */
+      if (model->hasAnimations() && !model->getBoneList().empty() &&
+          !usesBakedAnimations(model)) {
         size_t numBones = model->getBoneList().size();
 
         /* buffer size must always be a multiple of "local_size_y" instances to
          * avoid undefined behavior */
-        boneMatrixBufferSize += numBones * ((numInstances - 1) / 32 + 1) * 32;
+        size_t paddedBones = numBones * ((numInstances - 1) / 32 + 1) * 32;
+        boneMatrixBufferSize += paddedBones;
+        bonePaletteSize += paddedBones * (model->getDualQuatSkinning() ? 2 : 4);
       }
     }
   }
 
   /* clear and resize world pos matrices */
   mWorldPosMatrices.clear();
-  mWorldPosMatrices.resize(mModelInstData.miAssimpInstances.size());
+  mWorldPosMatrices.resize(numInstancesToDraw);
   mNodeTransformData.clear();
-  mNodeTransformData.resize(boneMatrixBufferSize);
+  mAnimInstanceData.clear();
+  if (!mRenderData.rdUseGpuAnimSampling) {
+    mNodeTransformData.resize(boneMatrixBufferSize);
+  }
   mSelectedInstance.clear();
-  mSelectedInstance.resize(mModelInstData.miAssimpInstances.size());
+  mSelectedInstance.resize(numInstancesToDraw);
+  mBakedInstanceData.clear();
+  if (mRenderData.rdUseBakedAnimations) {
+    mBakedInstanceData.resize(numInstancesToDraw);
+  }
+  mRenderData.rdBakedAnimationSize = 0;
+  mCullInstanceData.clear();
+
+  /* every model appends its commands to the range of its pipeline */
+  std::array<uint32_t, kNumDrawPipelines> nextPipelineCommand{};
+  uint32_t numDrawCommands = 0;
+  for (size_t i = 0; i < kNumDrawPipelines; ++i) {
+    nextPipelineCommand.at(i) = numDrawCommands;
+    numDrawCommands += pipelineCommandCounts.at(i);
+    mDrawBatches.at(i).clear();
+  }
+  mDrawCommands.resize(numDrawCommands);
+  mDrawData.resize(numDrawCommands);
 
   /* save the selected instance for color highlight */
   std::shared_ptr<AssimpInstance> currentSelectedInstance = nullptr;
@@ -311,14 +453,69 @@ bool VkRenderer::draw() {
 
   size_t instanceToStore = 0;
   size_t animatedInstancesToStore = 0;
-  for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
+  /* counted in vec4, the mat4 shader gets the offset in mat4 */
+  uint32_t drawBonePaletteOffset = 0;
+  /* scales the number of record jobs */
+  size_t numDrawModels = 0;
+  for (const auto& [_, instances] : instancesPerModel) {
     size_t numInstances = instances.size();
     std::shared_ptr<AssimpModel> model = instances.front()->getModel();
     if (numInstances > 0 && model->getTriangleCount() > 0) {
+      ++numDrawModels;
+      drawPipeline pipelineType = getDrawPipeline(model);
+      size_t pipelineIndex = static_cast<size_t>(pipelineType);
+      uint32_t firstCommand = nextPipelineCommand.at(pipelineIndex);
+      nextPipelineCommand.at(pipelineIndex) += model->getMeshCount();
+
+      VkDrawData modelDrawData{};
+      modelDrawData.worldPosOffset = static_cast<uint32_t>(instanceToStore);
+      VkDescriptorSet modelSet = VK_NULL_HANDLE;
+      if (pipelineType == drawPipeline::skinningBaked ||
+          pipelineType == drawPipeline::skinningBakedPacked) {
+        modelSet = model->getBakedAnimDescriptorSet();
+      } else if (pipelineType != drawPipeline::assimp &&
+                 pipelineType != drawPipeline::assimpPacked) {
+        modelDrawData.modelStride =
+            static_cast<uint32_t>(model->getBoneList().size());
+        modelDrawData.skinMatOffset = model->getDualQuatSkinning()
+                                          ? drawBonePaletteOffset
+                                          : drawBonePaletteOffset / 4;
+        drawBonePaletteOffset += getBonePaletteSize(model, numInstances);
+      }
+      DrawRecord::writeDrawCommands(model->getDrawRecords(mRenderData),
+                                    modelDrawData, firstCommand,
+                                    mDrawCommands, mDrawData);
+
+      /* models without their own set extend the previous multi draw */
+      std::vector<VkDrawBatch>& batches = mDrawBatches.at(pipelineIndex);
+      if (batches.empty() || batches.back().modelSet != modelSet) {
+        VkDrawBatch batch{};
+        batch.firstCommand = firstCommand;
+        batch.modelSet = modelSet;
+        batches.emplace_back(batch);
+      }
+      batches.back().commandCount += model->getMeshCount();
+
+      /* all meshes of the model share the culling result of an instance */
+      VkCullInstanceData cullData{};
+      cullData.firstCommand = firstCommand;
+      cullData.commandCount = model->getMeshCount();
+      cullData.worldPosOffset = static_cast<uint32_t>(instanceToStore);
+      for (unsigned int i = 0; i < numInstances; ++i) {
+        cullData.boundingSphere = instances.at(i)->getBoundingSphere();
+        cullData.instanceIndex = i;
+        mCullInstanceData.push_back(cullData);
+      }
+
       /* animated models */
       if (model->hasAnimations() && !model->getBoneList().empty()) {
         size_t numBones = model->getBoneList().size();
-        animatedModelLoaded = true;
+        bool bakedAnimations = usesBakedAnimations(model);
+        if (bakedAnimations) {
+          mRenderData.rdBakedAnimationSize += model->getBakedAnimationSize();
+        } else {
+          animatedModelLoaded = true;
+        }
 
         mUploadToSSBOTimer.start();
 
@@ -327,10 +524,24 @@ bool VkRenderer::draw() {
                           instances.at(i)->getBoneMatrices();
           mModelBoneMatrices.insert(mModelBoneMatrices.end(),
           instanceBoneMatrices.begin(), instanceBoneMatrices.end());*/
-          const auto& nodeTransforms = instances.at(i)->getNodeTransformData();
-          std::copy(nodeTransforms.begin(), nodeTransforms.end(),
-                    mNodeTransformData.begin() + animatedInstancesToStore +
-                        i * numBones);
+          InstanceSettings instSettings =
+              instances.at(i)->getInstanceSettings();
+          if (bakedAnimations) {
+            mBakedInstanceData.at(instanceToStore + i) =
+                model->getBakedInstanceData(instSettings.animClipNr,
+                                            instSettings.animPlayTimePos);
+          } else if (mRenderData.rdUseGpuAnimSampling) {
+            VkAnimInstanceData animInstance{};
+            animInstance.clipNr = instSettings.animClipNr;
+            animInstance.playTime = instSettings.animPlayTimePos;
+            mAnimInstanceData.emplace_back(animInstance);
+          } else {
+            const auto& nodeTransforms =
+                instances.at(i)->getNodeTransformData();
+            std::copy(nodeTransforms.begin(), nodeTransforms.end(),
+                      mNodeTransformData.begin() + animatedInstancesToStore +
+                          i * numBones);
+          }
           mWorldPosMatrices.at(instanceToStore + i) =
               instances.at(i)->getWorldTransformMatrix();
 
@@ -342,19 +553,22 @@ bool VkRenderer::draw() {
                 mRenderData.rdUnselectedInstanceToneDownValue;
           }
 
-          InstanceSettings instSettings =
-              instances.at(i)->getInstanceSettings();
           mSelectedInstance.at(instanceToStore + i).y =
               instSettings.instanceIndexPos;
         }
 
         mRenderData.rdUploadToSSBOTime += mUploadToSSBOTimer.stop();
 
-        size_t trsMatrixSize = numBones * numInstances * sizeof(glm::mat4);
-        mRenderData.rdMatricesSize += trsMatrixSize;
+        if (!bakedAnimations) {
+          size_t trsMatrixSize =
+              numBones * numInstances *
+              (model->getDualQuatSkinning() ? 2 * sizeof(glm::vec4)
+                                            : sizeof(glm::mat4));
+          mRenderData.rdMatricesSize += trsMatrixSize;
+          animatedInstancesToStore += numInstances * numBones;
+        }
 
         instanceToStore += numInstances;
-        animatedInstancesToStore += numInstances * numBones;
       } else {
         /* non-animated models */
         mUploadToSSBOTimer.start();
@@ -386,37 +600,105 @@ bool VkRenderer::draw() {
   /* we need to update descriptors after the upload if buffer size changed */
   bool bufferResized = false;
   mUploadToSSBOTimer.start();
-  bufferResized = ShaderStorageBuffer::uploadSSBOData(
-      mRenderData, &mShaderNodeTransformBuffer,
-      (char*)mNodeTransformData.data(),
-      mNodeTransformData.size() * sizeof(NodeTransformData));
-  bufferResized |= ShaderStorageBuffer::uploadSSBOData(
-      mRenderData, &mSelectedInstanceBuffer, (char*)mSelectedInstance.data(),
-      mSelectedInstance.size() * sizeof(glm::vec2));
+  size_t nodeTransformDataSize =
+      mNodeTransformData.size() * sizeof(NodeTransformData);
+  size_t selectionDataSize = mSelectedInstance.size() * sizeof(glm::vec2);
+  size_t worldPosDataSize = mWorldPosMatrices.size() * sizeof(glm::mat4);
+  size_t cullDataSize = mCullInstanceData.size() * sizeof(VkCullInstanceData);
+  size_t drawCommandDataSize =
+      mDrawCommands.size() * sizeof(VkDrawIndexedIndirectCommand);
+  size_t visibleDataSize = mWorldPosMatrices.size() * sizeof(uint32_t);
+  size_t animInstanceDataSize =
+      mAnimInstanceData.size() * sizeof(VkAnimInstanceData);
+  size_t bakedInstanceDataSize =
+      mBakedInstanceData.size() * sizeof(VkBakedInstanceData);
+  size_t drawDataSize = mDrawData.size() * sizeof(VkDrawData);
 
   /* resize SSBO if needed */
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mShaderNodeTransformBuffer, nodeTransformDataSize);
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mSelectedInstanceBuffer, selectionDataSize);
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mShaderModelRootMatrixBuffer, worldPosDataSize);
   bufferResized |= ShaderStorageBuffer::checkForResize(
       mRenderData, &mShaderTRSMatrixBuffer,
       boneMatrixBufferSize * sizeof(glm::mat4));
   bufferResized |= ShaderStorageBuffer::checkForResize(
       mRenderData, &mShaderBoneMatrixBuffer,
-      boneMatrixBufferSize * sizeof(glm::mat4));
+      bonePaletteSize * sizeof(glm::vec4));
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mCullInstanceBuffer, cullDataSize);
+  bufferResized |= ShaderStorageBuffer::checkForResize(
+      mRenderData, &mVisibleInstanceBuffer, visibleDataSize);
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mAnimInstanceBuffer, animInstanceDataSize);
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mBakedInstanceBuffer, bakedInstanceDataSize);
+  bufferResized |= FrameRingBuffer::checkForResize(
+      mRenderData, &mDrawDataBuffer, drawDataSize);
+  if (mRenderData.rdUseGpuAnimSampling) {
+    bufferResized |= ShaderStorageBuffer::checkForResize(
+        mRenderData, &mShaderGpuPoseBuffer,
+        boneMatrixBufferSize * sizeof(NodeTransformData));
+  }
+  if (FrameRingBuffer::checkForResize(
+          mRenderData, &mDrawCommandBuffer,
+          sizeof(VkIndirectDrawHeader) + drawCommandDataSize)) {
+    /* the old slices are gone, including the culling results */
+    std::fill(mCullFrameInstanceCounts.begin(), mCullFrameInstanceCounts.end(),
+              0);
+    bufferResized = true;
+  }
   if (bufferResized) {
     updateDescriptorSets();
     updateComputeDescriptorSets();
   }
+
+  /* persistently mapped, only the written range is flushed */
+  FrameRingBuffer::uploadFrameData(
+      mRenderData, &mShaderNodeTransformBuffer, mNodeTransformData.data(),
+      nodeTransformDataSize, &mNodeTransformDynamicOffset);
+  FrameRingBuffer::uploadFrameData(mRenderData, &mSelectedInstanceBuffer,
+                                   mSelectedInstance.data(), selectionDataSize,
+                                   &mSelectionDynamicOffset);
+  FrameRingBuffer::uploadFrameData(
+      mRenderData, &mShaderModelRootMatrixBuffer, mWorldPosMatrices.data(),
+      worldPosDataSize, &mWorldPosDynamicOffset);
+  FrameRingBuffer::uploadFrameData(mRenderData, &mCullInstanceBuffer,
+                                   mCullInstanceData.data(), cullDataSize,
+                                   &mCullInstanceDynamicOffset);
+  FrameRingBuffer::uploadFrameData(
+      mRenderData, &mAnimInstanceBuffer, mAnimInstanceData.data(),
+      animInstanceDataSize, &mAnimInstanceDynamicOffset);
+  FrameRingBuffer::uploadFrameData(
+      mRenderData, &mBakedInstanceBuffer, mBakedInstanceData.data(),
+      bakedInstanceDataSize, &mBakedInstanceDynamicOffset);
+  FrameRingBuffer::uploadFrameData(mRenderData, &mDrawDataBuffer,
+                                   mDrawData.data(), drawDataSize,
+                                   &mDrawDataDynamicOffset);
+
+  /* the culling shader counts the instances up from zero */
+  VkIndirectDrawHeader drawHeader{};
+  FrameRingBuffer::uploadFrameData(mRenderData, &mDrawCommandBuffer,
+                                   &drawHeader, sizeof(VkIndirectDrawHeader),
+                                   &mDrawCommandDynamicOffset);
+  FrameRingBuffer::writeFrameData(mRenderData, &mDrawCommandBuffer,
+                                  sizeof(VkIndirectDrawHeader),
+                                  mDrawCommands.data(), drawCommandDataSize);
+  mCullFrameInstanceCounts.at(frame) = mCullInstanceData.size();
   mRenderData.rdUploadToSSBOTime += mUploadToSSBOTimer.stop();
 
   /* record compute commands */
   result = vkResetFences(mRenderData.rdVkbDevice.device, 1,
-                         &mRenderData.rdComputeFence);
+                         &mRenderData.rdComputeFences.at(frame));
   if (result != VK_SUCCESS) {
     Logger::log(1, "%s error: compute fence reset failed (error: %i)\n",
                 __FUNCTION__, result);
     return false;
   }
 
-  if (animatedModelLoaded) {
+  if (animatedModelLoaded || !mCullInstanceData.empty()) {
     if (!CommandBuffer::reset(mRenderData.rdComputeCommandBuffer, 0)) {
       Logger::log(1, "%s error: failed to reset compute command buffer\n",
                   __FUNCTION__);
@@ -429,23 +711,60 @@ bool VkRenderer::draw() {
       return false;
     }
 
+    /* GPU time of all skinning dispatches of this frame */
+    const uint32_t firstQuery = 2 * frame;
+    if (mTimestampQueryPool != VK_NULL_HANDLE) {
+      vkCmdResetQueryPool(mRenderData.rdComputeCommandBuffer,
+                          mTimestampQueryPool, firstQuery, 2);
+      vkCmdWriteTimestamp(mRenderData.rdComputeCommandBuffer,
+                          VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                          mTimestampQueryPool, firstQuery);
+    }
+
     uint32_t computeShaderModelOffset = 0;
-    for (const auto& [_, instances] :
-         mModelInstData.miAssimpInstancesPerModel) {
+    uint32_t bonePaletteOffset = 0;
+    uint32_t animInstanceOffset = 0;
+    for (const auto& [_, instances] : instancesPerModel) {
       size_t numInstances = instances.size();
       std::shared_ptr<AssimpModel> model = instances.at(0)->getModel();
       if (numInstances > 0 && model->getTriangleCount() > 0) {
         /* compute shader for animated models only */
-        if (model->hasAnimations() && !model->getBoneList().empty()) {
+        if (model->hasAnimations() && !model->getBoneList().empty() &&
+            !usesBakedAnimations(model)) {
           size_t numBones = model->getBoneList().size();
 
-          runComputeShaders(model, numInstances, computeShaderModelOffset);
+          if (mRenderData.rdUseGpuAnimSampling) {
+            runAnimSamplingShader(model, numInstances,
+                                  computeShaderModelOffset, animInstanceOffset);
+            animInstanceOffset += numInstances;
+          }
+
+          if (mRenderData.rdUseFusedSkinningCompute &&
+              numBones <= kMaxFusedSkinningBones) {
+            runFusedComputeShader(model, numInstances,
+                                  computeShaderModelOffset, bonePaletteOffset);
+          } else {
+            runComputeShaders(model, numInstances, computeShaderModelOffset,
+                              bonePaletteOffset);
+          }
 
           computeShaderModelOffset += numInstances * numBones;
+          bonePaletteOffset += getBonePaletteSize(model, numInstances);
         }
       }
     }
 
+    if (mTimestampQueryPool != VK_NULL_HANDLE) {
+      vkCmdWriteTimestamp(mRenderData.rdComputeCommandBuffer,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          mTimestampQueryPool, firstQuery + 1);
+      mTimestampsPending.at(frame) = true;
+    }
+
+    if (!mCullInstanceData.empty()) {
+      runCullingShader(static_cast<uint32_t>(mCullInstanceData.size()));
+    }
+
     if (!CommandBuffer::end(mRenderData.rdComputeCommandBuffer)) {
       Logger::log(1, "%s error: failed to end compute command buffer\n",
                   __FUNCTION__);
@@ -466,14 +785,16 @@ bool VkRenderer::draw() {
     computeSubmitInfo.pWaitDstStageMask = &waitStage;
 
     result = vkQueueSubmit(mRenderData.rdComputeQueue, 1, &computeSubmitInfo,
-                           mRenderData.rdComputeFence);
+                           mRenderData.rdComputeFences.at(frame));
     if (result != VK_SUCCESS) {
       Logger::log(1, "%s error: failed to submit compute command buffer (%i)\n",
                   __FUNCTION__, result);
       return false;
     };
   } else {
-    /* do an empty submit if we don't have animated models to satisfy fence and
+    mRenderData.rdSkinningComputeTime = 0.0f;
+
+    /* do an empty submit if we don't have any instances to satisfy fence and
      * semaphor */
     VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
@@ -486,7 +807,7 @@ bool VkRenderer::draw() {
     computeSubmitInfo.pWaitDstStageMask = &waitStage;
 
     result = vkQueueSubmit(mRenderData.rdComputeQueue, 1, &computeSubmitInfo,
-                           mRenderData.rdComputeFence);
+                           mRenderData.rdComputeFences.at(frame));
     if (result != VK_SUCCESS) {
       Logger::log(1, "%s error: failed to submit compute command buffer (%i)\n",
                   __FUNCTION__, result);
@@ -494,18 +815,9 @@ bool VkRenderer::draw() {
     };
   }
 
-  /* we need to update descriptors after the upload if buffer size changed */
-  mUploadToSSBOTimer.start();
-  bufferResized = ShaderStorageBuffer::uploadSSBOData(
-      mRenderData, &mShaderModelRootMatrixBuffer, mWorldPosMatrices);
-  if (bufferResized) {
-    updateDescriptorSets();
-  }
-  mRenderData.rdUploadToSSBOTime += mUploadToSSBOTimer.stop();
-
   /* start with graphics rendering */
   result = vkResetFences(mRenderData.rdVkbDevice.device, 1,
-                         &mRenderData.rdRenderFence);
+                         &mRenderData.rdRenderFences.at(frame));
   if (result != VK_SUCCESS) {
     Logger::log(1, "%s error:  fence reset failed (error: %i)\n", __FUNCTION__,
                 result);
@@ -517,6 +829,15 @@ bool VkRenderer::draw() {
     return false;
   }
 
+  /* the worker count may have been changed in the UI */
+  if (!SecondaryCommandBuffer::init(mRenderData, kMaxFramesInFlight,
+                                    mJobSystem.getNumWorkers()) ||
+      !SecondaryCommandBuffer::reset(mRenderData, frame)) {
+    Logger::log(1, "%s error: failed to reset secondary command buffers\n",
+                __FUNCTION__);
+    return false;
+  }
+
   if (!CommandBuffer::beginTransient(mRenderData.rdCommandBuffer)) {
     Logger::log(1, "%s error: failed to begin command buffer\n", __FUNCTION__);
     return false;
@@ -545,88 +866,78 @@ bool VkRenderer::draw() {
   rpInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
   rpInfo.pClearValues = clearValues.data();
 
+  /* all draws are in secondary command buffers */
   vkCmdBeginRenderPass(mRenderData.rdCommandBuffer, &rpInfo,
-                       VK_SUBPASS_CONTENTS_INLINE);
-
-  /* Flip viewport to be compatible with OpenGL */
-  VkViewport viewport{};
-  viewport.x = 0.0f;
-  viewport.y = static_cast<float>(mRenderData.rdVkbSwapchain.extent.height);
-  viewport.width = static_cast<float>(mRenderData.rdVkbSwapchain.extent.width);
-  viewport.height =
-      -static_cast<float>(mRenderData.rdVkbSwapchain.extent.height);
-  viewport.minDepth = 0.0f;
-  viewport.maxDepth = 1.0f;
-
-  VkRect2D scissor{};
-  scissor.offset = {0, 0};
-  scissor.extent = mRenderData.rdVkbSwapchain.extent;
-
-  vkCmdSetViewport(mRenderData.rdCommandBuffer, 0, 1, &viewport);
-  vkCmdSetScissor(mRenderData.rdCommandBuffer, 0, 1, &scissor);
+                       VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+  VkCommandBufferInheritanceInfo inheritanceInfo{};
+  inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  inheritanceInfo.renderPass = mRenderData.rdRenderpass;
+  inheritanceInfo.subpass = 0;
+  inheritanceInfo.framebuffer = mRenderData.rdFramebuffers.at(imageIndex);
+
+  /* Draw the models, the number of jobs grows with the number of models */
+  mRecordTimer.start();
+  size_t numRecordJobs = 0;
+  if (numDrawCommands > 0) {
+    numRecordJobs = 1;
+    if (mRenderData.rdUseParallelRecording) {
+      numRecordJobs = std::clamp(
+          (numDrawModels + kModelsPerRecordJob - 1) / kModelsPerRecordJob,
+          static_cast<size_t>(1),
+          static_cast<size_t>(mJobSystem.getNumWorkers()));
+    }
+  }
+  uint32_t commandsPerJob =
+      numRecordJobs > 0
+          ? (numDrawCommands + static_cast<uint32_t>(numRecordJobs) - 1) /
+                static_cast<uint32_t>(numRecordJobs)
+          : 0;
+
+  mRecordCommandBuffers.assign(numRecordJobs, VK_NULL_HANDLE);
+  mRecordDrawCallCounts.assign(numRecordJobs, 0);
+
+  /* every job writes only its own entries */
+  auto recordJobs = [&](size_t first, size_t last, unsigned int worker) {
+    for (size_t job = first; job < last; ++job) {
+      VkCommandBuffer commandBuffer = SecondaryCommandBuffer::begin(
+          mRenderData, frame, worker, inheritanceInfo);
+      if (commandBuffer == VK_NULL_HANDLE) {
+        continue;
+      }
 
-  /* Draw the models */
-  uint32_t worldPosMatIndexOffset = 0;
-  uint32_t worldPosMatIndexOffsetSkinned = 0;
-  for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
-    size_t numberOfInstances = instances.size();
-    std::shared_ptr<AssimpModel> model = instances.at(0)->getModel();
-    if (numberOfInstances > 0 && model->getTriangleCount() > 0) {
-      /* Animated models */
-      if (model->hasAnimations() && !model->getBoneList().empty()) {
-        uint32_t numberOfBones =
-            static_cast<uint32_t>(model->getBoneList().size());
+      uint32_t beginCommand = static_cast<uint32_t>(job) * commandsPerJob;
+      uint32_t endCommand =
+          std::min(beginCommand + commandsPerJob, numDrawCommands);
+      mRecordDrawCallCounts.at(job) =
+          recordModelDraws(commandBuffer, beginCommand, endCommand);
 
-        vkCmdBindPipeline(mRenderData.rdCommandBuffer,
-                          VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          mRenderData.rdAssimpSkinningPipeline);
-
-        vkCmdBindDescriptorSets(
-            mRenderData.rdCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-            mRenderData.rdAssimpSkinningPipelineLayout, 1, 1,
-            &mRenderData.rdAssimpSkinningDescriptorSet, 0, nullptr);
-
-        mUploadToUBOTimer.start();
-        mModelData.pkModelStride = numberOfBones;
-        mModelData.pkWorldPosOffset = worldPosMatIndexOffset;
-        mModelData.pkSkinMatOffset = worldPosMatIndexOffsetSkinned;
-        vkCmdPushConstants(mRenderData.rdCommandBuffer,
-                           mRenderData.rdAssimpSkinningPipelineLayout,
-                           VK_SHADER_STAGE_VERTEX_BIT, 0,
-                           static_cast<uint32_t>(sizeof(VkPushConstants)),
-                           &mModelData);
-        mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+      if (CommandBuffer::end(commandBuffer)) {
+        mRecordCommandBuffers.at(job) = commandBuffer;
+      }
+    }
+  };
 
-        model->drawInstanced(mRenderData, numberOfInstances);
+  /* a single job stays on the render thread, which is worker 0 */
+  if (numRecordJobs > 1) {
+    mJobSystem.parallelFor(numRecordJobs, 1, recordJobs);
+    mRenderData.rdRecordWorkerTimes = mJobSystem.getWorkerTimes();
+    mRenderData.rdRecordTime = mRecordTimer.stop();
+  } else {
+    recordJobs(0, numRecordJobs, 0);
+    mRenderData.rdRecordTime = mRecordTimer.stop();
+    mRenderData.rdRecordWorkerTimes.assign(1, mRenderData.rdRecordTime);
+  }
+  mRenderData.rdRecordJobCount = numRecordJobs;
 
-        worldPosMatIndexOffset += numberOfInstances;
-        worldPosMatIndexOffsetSkinned += numberOfInstances * numberOfBones;
-      } else {
-        /* Non-animated models */
-
-        vkCmdBindPipeline(mRenderData.rdCommandBuffer,
-                          VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          mRenderData.rdAssimpPipeline);
-
-        vkCmdBindDescriptorSets(mRenderData.rdCommandBuffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                mRenderData.rdAssimpPipelineLayout, 1, 1,
-                                &mRenderData.rdAssimpDescriptorSet, 0, nullptr);
-
-        mUploadToUBOTimer.start();
-        mModelData.pkModelStride = 0;
-        mModelData.pkWorldPosOffset = worldPosMatIndexOffset;
-        mModelData.pkSkinMatOffset = 0;
-        vkCmdPushConstants(
-            mRenderData.rdCommandBuffer, mRenderData.rdAssimpPipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT, 0,
-            static_cast<uint32_t>(sizeof(VkPushConstants)), &mModelData);
-        mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
-
-        model->drawInstanced(mRenderData, numberOfInstances);
-        worldPosMatIndexOffset += numberOfInstances;
-      }
+  mRenderData.rdDrawCallCount = 0;
+  for (size_t i = 0; i < numRecordJobs; ++i) {
+    if (mRecordCommandBuffers.at(i) == VK_NULL_HANDLE) {
+      Logger::log(1, "%s error: failed to record draw job %i\n", __FUNCTION__,
+                  i);
+      return false;
     }
+    mRenderData.rdDrawCallCount += mRecordDrawCallCounts.at(i);
   }
 
   /* imGui overlay */
@@ -637,12 +948,41 @@ bool VkRenderer::draw() {
     mRenderData.rdUIGenerateTime += mUIGenerateTimer.stop();
 
     mUIDrawTimer.start();
-    mUserInterface.render(mRenderData);
+    VkCommandBuffer uiCommandBuffer =
+        SecondaryCommandBuffer::begin(mRenderData, frame, 0, inheritanceInfo);
+    if (uiCommandBuffer == VK_NULL_HANDLE) {
+      Logger::log(1, "%s error: failed to begin UI command buffer\n",
+                  __FUNCTION__);
+      return false;
+    }
+    mUserInterface.render(uiCommandBuffer);
+    if (!CommandBuffer::end(uiCommandBuffer)) {
+      Logger::log(1, "%s error: failed to end UI command buffer\n",
+                  __FUNCTION__);
+      return false;
+    }
+    mRecordCommandBuffers.emplace_back(uiCommandBuffer);
     mRenderData.rdUIDrawTime = mUIDrawTimer.stop();
   }
 
+  /* executed in job order, the UI comes last */
+  if (!mRecordCommandBuffers.empty()) {
+    vkCmdExecuteCommands(mRenderData.rdCommandBuffer,
+                         static_cast<uint32_t>(mRecordCommandBuffers.size()),
+                         mRecordCommandBuffers.data());
+  }
+
   vkCmdEndRenderPass(mRenderData.rdCommandBuffer);
 
+  /* copy the pixels around the cursor, resolved when this slot comes back */
+  if (mMousePick) {
+    if (mRenderData.rdApplicationMode == appMode::edit) {
+      Framebuffer::recordSelectionReadback(
+          mRenderData, &mSelectionReadbacks.at(frame), mMousePos);
+    }
+    mMousePick = false;
+  }
+
   if (!CommandBuffer::end(mRenderData.rdCommandBuffer)) {
     Logger::log(1, "%s error: failed to end command buffer\n", __FUNCTION__);
     return false;
@@ -652,21 +992,23 @@ bool VkRenderer::draw() {
   VkSubmitInfo submitInfo{};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-  std::vector<VkSemaphore> waitSemaphores = {mRenderData.rdComputeSemaphore,
-                                             mRenderData.rdPresentSemaphore};
+  std::vector<VkSemaphore> waitSemaphores = {
+      mRenderData.rdComputeSemaphore,
+      mRenderData.rdPresentSemaphores.at(frame)};
   std::vector<VkPipelineStageFlags> waitStages = {
-      VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
 
-  /* compute shader: contine if in vertex input ready
+  /* compute shader: the indirect draws need the culling results
    * vertex shader: wait for color attachment output ready */
   submitInfo.pWaitDstStageMask = waitStages.data();
 
   submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
   submitInfo.pWaitSemaphores = waitSemaphores.data();
 
-  std::vector<VkSemaphore> signalSemaphores = {mRenderData.rdRenderSemaphore,
-                                               mRenderData.rdGraphicSemaphore};
+  std::vector<VkSemaphore> signalSemaphores = {
+      mRenderData.rdRenderSemaphores.at(imageIndex),
+      mRenderData.rdGraphicSemaphore};
 
   submitInfo.signalSemaphoreCount =
       static_cast<uint32_t>(signalSemaphores.size());
@@ -676,36 +1018,20 @@ bool VkRenderer::draw() {
   submitInfo.pCommandBuffers = &mRenderData.rdCommandBuffer;
 
   result = vkQueueSubmit(mRenderData.rdGraphicsQueue, 1, &submitInfo,
-                         mRenderData.rdRenderFence);
+                         mRenderData.rdRenderFences.at(frame));
   if (result != VK_SUCCESS) {
     Logger::log(1, "%s error: failed to submit draw command buffer (%i)\n",
                 __FUNCTION__, result);
     return false;
   }
 
-  /* wait for queue to be idle */
-  vkQueueWaitIdle(mRenderData.rdGraphicsQueue);
-
-  if (mMousePick) {
-    if (mRenderData.rdApplicationMode == appMode::edit) {
-      int selectedInstanceId =
-          Framebuffer::getPixelValueFromSelectionImage(mRenderData, mMousePos);
-
-      if (0 < selectedInstanceId) {
-        mModelInstData.miSelectedInstance =
-            static_cast<int>(selectedInstanceId);
-      } else {
-        mModelInstData.miSelectedInstance = 0;
-      }
-    }
-    mMousePick = false;
-  }
+  mRenderData.rdCurrentFrame = (frame + 1) % kMaxFramesInFlight;
 
   /* Present to the screen */
   VkPresentInfoKHR presentInfo{};
   presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
   presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores = &mRenderData.rdRenderSemaphore;
+  presentInfo.pWaitSemaphores = &mRenderData.rdRenderSemaphores.at(imageIndex);
 
   presentInfo.swapchainCount = 1;
   presentInfo.pSwapchains = &mRenderData.rdVkbSwapchain.swapchain;
@@ -750,31 +1076,135 @@ std::shared_ptr<AssimpModel> VkRenderer::getModel(std::string modelFileName) {
 }
 
 bool VkRenderer::addModel(std::string modelFileName) {
-  if (hasModel(modelFileName)) {
+  if (hasModel(modelFileName) || mModelLoader.isLoading(modelFileName)) {
     Logger::log(1, "%s warning: model '%s' already existed, skipping\n",
                 __FUNCTION__, modelFileName.c_str());
     return false;
   }
 
+  /* the model shows up in the model list once it has been uploaded */
   std::shared_ptr<AssimpModel> model = std::make_shared<AssimpModel>();
-  if (!model->loadModel(mRenderData, modelFileName)) {
-    Logger::log(1, "%s error: could not load model file '%s'\n", __FUNCTION__,
-                modelFileName.c_str());
-    return false;
+  mModelLoader.loadModel(model, modelFileName);
+
+  /* the box marks the spot and can be moved until the model is ready */
+  mPlaceholderInstances[modelFileName] = addInstance(mPlaceholderModel);
+
+  return true;
+}
+
+std::shared_ptr<AssimpInstance> VkRenderer::removePlaceholder(
+    const std::string& modelFileName) {
+  auto placeholderIter = mPlaceholderInstances.find(modelFileName);
+  if (placeholderIter == mPlaceholderInstances.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<AssimpInstance> placeholder = placeholderIter->second;
+  mPlaceholderInstances.erase(placeholderIter);
+
+  /* the box may have been deleted in the UI */
+  if (std::find(mModelInstData.miAssimpInstances.begin(),
+                mModelInstData.miAssimpInstances.end(),
+                placeholder) == mModelInstData.miAssimpInstances.end()) {
+    return nullptr;
+  }
+  deleteInstance(placeholder);
+
+  /* the draw loops expect at least one instance per model entry */
+  if (mModelInstData.miAssimpInstancesPerModel[kPlaceholderModelName]
+          .empty()) {
+    mModelInstData.miAssimpInstancesPerModel.erase(kPlaceholderModelName);
+  }
+  if (mModelInstData.miSelectedInstance >=
+      static_cast<int>(mModelInstData.miAssimpInstances.size())) {
+    mModelInstData.miSelectedInstance =
+        static_cast<int>(mModelInstData.miAssimpInstances.size()) - 1;
+  }
+  return placeholder;
+}
+
+void VkRenderer::processLoadedModels() {
+  /* all models finished since the last frame are uploaded in one batch */
+  ModelLoadResult result;
+  while (mModelLoader.getFinishedModel(result)) {
+    std::shared_ptr<AssimpModel> model = result.model;
+    if (!result.success) {
+      Logger::log(1, "%s error: could not load model file '%s'\n",
+                  __FUNCTION__, result.modelFileName.c_str());
+      removePlaceholder(result.modelFileName);
+      continue;
+    }
+
+    if (!model->uploadModelData(mRenderData)) {
+      Logger::log(1, "%s error: could not upload model file '%s'\n",
+                  __FUNCTION__, result.modelFileName.c_str());
+      /* the batch may already contain copies into the model buffers */
+      UploadManager::flush(mRenderData);
+      UploadManager::retire(mRenderData, true);
+      model->cleanup(mRenderData);
+      removePlaceholder(result.modelFileName);
+      continue;
+    }
+
+    mModelInstData.miModelList.emplace_back(model);
+
+    /* also add a new instance here to see the model */
+    std::shared_ptr<AssimpInstance> newInstance = addInstance(model);
+
+    /* the instance replaces its box, including any edits made meanwhile */
+    std::shared_ptr<AssimpInstance> placeholder =
+        removePlaceholder(result.modelFileName);
+    if (placeholder) {
+      InstanceSettings placeholderSettings =
+          placeholder->getInstanceSettings();
+      InstanceSettings instanceSettings = newInstance->getInstanceSettings();
+      instanceSettings.worldPosition = placeholderSettings.worldPosition;
+      instanceSettings.worldRotation = placeholderSettings.worldRotation;
+      instanceSettings.scale = placeholderSettings.scale;
+      newInstance->setInstanceSettings(instanceSettings);
+    }
+
+    if (mModelInstData.miAssimpInstances.size() == 2) {
+      std::shared_ptr<AssimpInstance> firstInstance =
+          mModelInstData.miAssimpInstances.at(1);
+      centerInstance(firstInstance);
+    }
+
+    /* select new model and new instance */
+    mModelInstData.miSelectedModel = mModelInstData.miModelList.size() - 1;
+    mModelInstData.miSelectedInstance =
+        mModelInstData.miAssimpInstances.size() - 1;
+  }
+
+  /* one submit for all copies of this frame */
+  if (!UploadManager::flush(mRenderData)) {
+    Logger::log(1, "%s error: could not submit model uploads\n", __FUNCTION__);
   }
 
-  mModelInstData.miModelList.emplace_back(model);
+  mModelInstData.miModelLoadProgress = mModelLoader.getLoadProgress();
+}
 
-  /* also add a new instance here to see the model */
-  addInstance(model);
+void VkRenderer::deletePendingModels() {
+  if (mModelInstData.miPendingDeleteAssimpModels.empty()) {
+    return;
+  }
 
-  if (mModelInstData.miAssimpInstances.size() == 2) {
-    std::shared_ptr<AssimpInstance> firstInstance =
-        mModelInstData.miAssimpInstances.at(1);
-    centerInstance(firstInstance);
+  /* frames in flight may still draw the models */
+  VkResult result = vkDeviceWaitIdle(mRenderData.rdVkbDevice.device);
+  if (result != VK_SUCCESS) {
+    Logger::log(1, "%s error: could not wait for device idle (error: %i)\n",
+                __FUNCTION__, result);
+    return;
   }
 
-  return true;
+  for (const auto& model : mModelInstData.miPendingDeleteAssimpModels) {
+    model->cleanup(mRenderData);
+  }
+  mModelInstData.miPendingDeleteAssimpModels.clear();
+
+  if (!GeometryArena::defragment(mRenderData)) {
+    Logger::log(1, "%s error: could not defragment the geometry arena\n",
+                __FUNCTION__);
+  }
 }
 
 void VkRenderer::deleteModel(std::string modelFileName) {
@@ -798,9 +1228,10 @@ void VkRenderer::deleteModel(std::string modelFileName) {
     mModelInstData.miAssimpInstancesPerModel.erase(shortModelFileName);
   }
 
-  /* add models to pending delete list */
+  /* the current frame may still draw the model, the Vulkan objects are
+   * destroyed at the start of the next frame */
   for (const auto& model : mModelInstData.miModelList) {
-    if (model && (model->getTriangleCount() > 0)) {
+    if (model && model->getModelFileName() == modelFileName) {
       mModelInstData.miPendingDeleteAssimpModels.insert(model);
     }
   }
@@ -907,8 +1338,33 @@ void VkRenderer::centerInstance(std::shared_ptr<AssimpInstance> instance) {
 }
 
 void VkRenderer::updateAnimations(float deltaTime) {
-  mRenderData.rdUpdateAnimationTime = 0.0f;
+  /* worker count has been changed in the UI */
+  if (static_cast<unsigned int>(mRenderData.rdNumAnimationWorkers) !=
+      mJobSystem.getNumWorkers()) {
+    mJobSystem.init(mRenderData.rdNumAnimationWorkers);
+  }
+
+  mUpdateAnimationTimer.start();
+
+  /* the camera has already been moved for this frame */
+  updateMatrices();
+
+  /* invisible instances only advance their play time */
+  if (mRenderData.rdCullingMode == cullingMode::cpu) {
+    cullInstances();
+  } else {
+    mVisibleInstancesPerModel.clear();
+    for (const auto& [_, instances] :
+         mModelInstData.miAssimpInstancesPerModel) {
+      for (const auto& instance : instances) {
+        instance->setVisible(true);
+      }
+    }
+  }
+  updateAnimationLods();
 
+  /* split the animated instances into chunks for the workers */
+  mAnimationUpdateRanges.clear();
   for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
     size_t numInstances = instances.size();
     if (numInstances > 0) {
@@ -916,14 +1372,45 @@ void VkRenderer::updateAnimations(float deltaTime) {
 
       /* animated models */
       if (model->hasAnimations() && !model->getBoneList().empty()) {
-        mUpdateAnimationTimer.start();
-        for (unsigned int i = 0; i < numInstances; ++i) {
-          instances.at(i)->updateAnimation(deltaTime);
+        bool bakedAnimations = usesBakedAnimations(model);
+        for (size_t begin = 0; begin < numInstances;
+             begin += kAnimationUpdateChunkSize) {
+          AnimationUpdateRange range;
+          range.instances = &instances;
+          range.bakedAnimations = bakedAnimations;
+          range.begin = begin;
+          range.end = std::min(begin + kAnimationUpdateChunkSize, numInstances);
+          mAnimationUpdateRanges.emplace_back(range);
         }
-        mRenderData.rdUpdateAnimationTime += mUpdateAnimationTimer.stop();
       }
     }
   }
+
+  /* every instance only touches its own data, so ranges run in parallel */
+  mJobSystem.parallelFor(
+      mAnimationUpdateRanges.size(), 1,
+      [this, deltaTime](size_t first, size_t last, unsigned int) {
+        for (size_t i = first; i < last; ++i) {
+          const AnimationUpdateRange& range = mAnimationUpdateRanges.at(i);
+          std::span<const std::shared_ptr<AssimpInstance>> instances(
+              range.instances->data() + range.begin, range.end - range.begin);
+
+          if (mRenderData.rdUseGpuAnimSampling || range.bakedAnimations) {
+            for (const auto& instance : instances) {
+              instance->updatePlayTime(deltaTime);
+            }
+          } else if (mRenderData.rdUseBatchAnimSampling) {
+            AssimpInstance::updateAnimations(instances, deltaTime);
+          } else {
+            for (const auto& instance : instances) {
+              instance->updateAnimation(deltaTime);
+            }
+          }
+        }
+      });
+
+  mRenderData.rdAnimationWorkerTimes = mJobSystem.getWorkerTimes();
+  mRenderData.rdUpdateAnimationTime = mUpdateAnimationTimer.stop();
 }
 
 void VkRenderer::cleanup() {
@@ -935,6 +1422,9 @@ void VkRenderer::cleanup() {
     return;
   }
 
+  mJobSystem.cleanup();
+  mModelLoader.cleanup();
+
   /* delete models to destroy Vulkan objects */
   for (const auto& model : mModelInstData.miModelList) {
     model->cleanup(mRenderData);
@@ -944,39 +1434,90 @@ void VkRenderer::cleanup() {
     model->cleanup(mRenderData);
   }
 
+  if (mPlaceholderModel) {
+    mPlaceholderModel->cleanup(mRenderData);
+  }
+  mPlaceholderInstances.clear();
+
   mUserInterface.cleanup(mRenderData);
 
+  GeometryArena::cleanup(mRenderData);
+  UploadManager::cleanup(mRenderData);
   SyncObjects::cleanup(&mRenderData);
-  CommandBuffer::cleanup(mRenderData, mRenderData.rdCommandPool,
-                         &mRenderData.rdCommandBuffer);
-  CommandBuffer::cleanup(mRenderData, mRenderData.rdComputeCommandPool,
-                         &mRenderData.rdComputeCommandBuffer);
+  for (auto& commandBuffer : mRenderData.rdCommandBuffers) {
+    CommandBuffer::cleanup(mRenderData, mRenderData.rdCommandPool,
+                           &commandBuffer);
+  }
+  for (auto& commandBuffer : mRenderData.rdComputeCommandBuffers) {
+    CommandBuffer::cleanup(mRenderData, mRenderData.rdComputeCommandPool,
+                           &commandBuffer);
+  }
+  SecondaryCommandBuffer::cleanup(mRenderData);
   CommandPool::cleanup(mRenderData, mRenderData.rdCommandPool);
   CommandPool::cleanup(mRenderData, mRenderData.rdComputeCommandPool);
   Framebuffer::cleanup(&mRenderData);
 
   SkinningPipeline::cleanup(mRenderData, mRenderData.rdAssimpPipeline);
   SkinningPipeline::cleanup(mRenderData, mRenderData.rdAssimpSkinningPipeline);
+  SkinningPipeline::cleanup(mRenderData,
+                            mRenderData.rdAssimpSkinningBakedPipeline);
+  SkinningPipeline::cleanup(mRenderData,
+                            mRenderData.rdAssimpSkinningDualQuatPipeline);
+  SkinningPipeline::cleanup(mRenderData, mRenderData.rdAssimpPackedPipeline);
+  SkinningPipeline::cleanup(mRenderData,
+                            mRenderData.rdAssimpSkinningPackedPipeline);
+  SkinningPipeline::cleanup(mRenderData,
+                            mRenderData.rdAssimpSkinningBakedPackedPipeline);
+  SkinningPipeline::cleanup(mRenderData,
+                            mRenderData.rdAssimpSkinningDualQuatPackedPipeline);
   ComputePipeline::cleanup(mRenderData,
                            mRenderData.rdAssimpComputeTransformPipeline);
   ComputePipeline::cleanup(mRenderData,
                            mRenderData.rdAssimpComputeMatrixMultPipeline);
+  ComputePipeline::cleanup(mRenderData,
+                           mRenderData.rdAssimpComputeCullPipeline);
+  ComputePipeline::cleanup(mRenderData,
+                           mRenderData.rdAssimpComputeFusedPipeline);
+  ComputePipeline::cleanup(mRenderData,
+                           mRenderData.rdAssimpComputeAnimSamplePipeline);
 
   PipelineLayout::cleanup(mRenderData, mRenderData.rdAssimpPipelineLayout);
   PipelineLayout::cleanup(mRenderData,
                           mRenderData.rdAssimpSkinningPipelineLayout);
+  PipelineLayout::cleanup(mRenderData,
+                          mRenderData.rdAssimpSkinningBakedPipelineLayout);
   PipelineLayout::cleanup(mRenderData,
                           mRenderData.rdAssimpComputeTransformaPipelineLayout);
   PipelineLayout::cleanup(mRenderData,
                           mRenderData.rdAssimpComputeMatrixMultPipelineLayout);
+  PipelineLayout::cleanup(mRenderData,
+                          mRenderData.rdAssimpComputeCullPipelineLayout);
+  PipelineLayout::cleanup(mRenderData,
+                          mRenderData.rdAssimpComputeFusedPipelineLayout);
+  PipelineLayout::cleanup(mRenderData,
+                          mRenderData.rdAssimpComputeAnimSamplePipelineLayout);
   Renderpass::cleanup(&mRenderData);
 
-  UniformBuffer::cleanup(mRenderData, &mPerspectiveViewMatrixUBO);
+  FrameRingBuffer::cleanup(mRenderData, &mPerspectiveViewMatrixUBO);
   ShaderStorageBuffer::cleanup(mRenderData, &mShaderTRSMatrixBuffer);
-  ShaderStorageBuffer::cleanup(mRenderData, &mShaderNodeTransformBuffer);
-  ShaderStorageBuffer::cleanup(mRenderData, &mShaderModelRootMatrixBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mShaderNodeTransformBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mShaderModelRootMatrixBuffer);
   ShaderStorageBuffer::cleanup(mRenderData, &mShaderBoneMatrixBuffer);
-  ShaderStorageBuffer::cleanup(mRenderData, &mSelectedInstanceBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mSelectedInstanceBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mCullInstanceBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mDrawCommandBuffer);
+  ShaderStorageBuffer::cleanup(mRenderData, &mVisibleInstanceBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mAnimInstanceBuffer);
+  ShaderStorageBuffer::cleanup(mRenderData, &mShaderGpuPoseBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mBakedInstanceBuffer);
+  FrameRingBuffer::cleanup(mRenderData, &mDrawDataBuffer);
+  for (auto& readback : mSelectionReadbacks) {
+    Framebuffer::cleanupSelectionReadback(mRenderData, &readback);
+  }
+  if (mTimestampQueryPool != VK_NULL_HANDLE) {
+    vkDestroyQueryPool(mRenderData.rdVkbDevice.device, mTimestampQueryPool,
+                       nullptr);
+  }
 
   vkFreeDescriptorSets(mRenderData.rdVkbDevice.device,
                        mRenderData.rdDescriptorPool, 1,
@@ -990,15 +1531,25 @@ void VkRenderer::cleanup() {
   vkFreeDescriptorSets(mRenderData.rdVkbDevice.device,
                        mRenderData.rdDescriptorPool, 1,
                        &mRenderData.rdAssimpComputeMatrixMultDescriptorSet);
+  vkFreeDescriptorSets(mRenderData.rdVkbDevice.device,
+                       mRenderData.rdDescriptorPool, 1,
+                       &mRenderData.rdAssimpComputeCullDescriptorSet);
+  vkFreeDescriptorSets(mRenderData.rdVkbDevice.device,
+                       mRenderData.rdDescriptorPool, 1,
+                       &mRenderData.rdAssimpComputeFusedDescriptorSet);
+  vkFreeDescriptorSets(mRenderData.rdVkbDevice.device,
+                       mRenderData.rdDescriptorPool, 1,
+                       &mRenderData.rdAssimpComputeAnimSampleDescriptorSet);
+  vkFreeDescriptorSets(
+      mRenderData.rdVkbDevice.device, mRenderData.rdDescriptorPool, 1,
+      &mRenderData.rdAssimpComputeTransformGpuPoseDescriptorSet);
+  vkFreeDescriptorSets(mRenderData.rdVkbDevice.device,
+                       mRenderData.rdDescriptorPool, 1,
+                       &mRenderData.rdAssimpComputeFusedGpuPoseDescriptorSet);
 
   vkDestroyDescriptorSetLayout(mRenderData.rdVkbDevice.device,
                                mRenderData.rdAssimpDescriptorLayout, nullptr);
-  vkDestroyDescriptorSetLayout(mRenderData.rdVkbDevice.device,
-                               mRenderData.rdAssimpTextureDescriptorLayout,
-                               nullptr);
-  vkDestroyDescriptorSetLayout(mRenderData.rdVkbDevice.device,
-                               mRenderData.rdAssimpTextureDescriptorLayout,
-                               nullptr);
+  TextureTable::cleanup(mRenderData);
   vkDestroyDescriptorSetLayout(
       mRenderData.rdVkbDevice.device,
       mRenderData.rdAssimpComputeTransformDescriptorLayout, nullptr);
@@ -1008,6 +1559,18 @@ void VkRenderer::cleanup() {
   vkDestroyDescriptorSetLayout(
       mRenderData.rdVkbDevice.device,
       mRenderData.rdAssimpComputeMatrixMultPerModelDescriptorLayout, nullptr);
+  vkDestroyDescriptorSetLayout(mRenderData.rdVkbDevice.device,
+                               mRenderData.rdAssimpComputeCullDescriptorLayout,
+                               nullptr);
+  vkDestroyDescriptorSetLayout(mRenderData.rdVkbDevice.device,
+                               mRenderData.rdAssimpComputeFusedDescriptorLayout,
+                               nullptr);
+  vkDestroyDescriptorSetLayout(
+      mRenderData.rdVkbDevice.device,
+      mRenderData.rdAssimpComputeAnimSampleDescriptorLayout, nullptr);
+  vkDestroyDescriptorSetLayout(
+      mRenderData.rdVkbDevice.device,
+      mRenderData.rdAssimpSkinningBakedPerModelDescriptorLayout, nullptr);
 
   vkDestroyDescriptorPool(mRenderData.rdVkbDevice.device,
                           mRenderData.rdDescriptorPool, nullptr);
@@ -1016,15 +1579,11 @@ void VkRenderer::cleanup() {
                      mRenderData.rdDepthImageView, nullptr);
   vkDestroyImageView(mRenderData.rdVkbDevice.device,
                      mRenderData.rdSelectionImageView, nullptr);
-  vkDestroyImageView(mRenderData.rdVkbDevice.device,
-                     mRenderData.rdLocalSelectionImageView, nullptr);
 
   vmaDestroyImage(mRenderData.rdAllocator, mRenderData.rdDepthImage,
                   mRenderData.rdDepthImageAlloc);
   vmaDestroyImage(mRenderData.rdAllocator, mRenderData.rdSelectionImage,
                   mRenderData.rdSelectionImageAlloc);
-  vmaDestroyImage(mRenderData.rdAllocator, mRenderData.rdLocalSelectionImage,
-                  mRenderData.rdLocalSelectionImageAlloc);
   vmaDestroyAllocator(mRenderData.rdAllocator);
 
   mRenderData.rdVkbSwapchain.destroy_image_views(
@@ -1134,9 +1693,32 @@ bool VkRenderer::deviceInit() {
   VkPhysicalDeviceFeatures physFeatures;
   vkGetPhysicalDeviceFeatures(firstPysicalDevSelRet.value(), &physFeatures);
 
-  auto secondPhysicalDevSelRet = physicalDevSel.set_surface(mSurface)
-                                     .set_required_features(physFeatures)
-                                     .select();
+  /* the vertex shaders read the draw data through gl_DrawID */
+  VkPhysicalDeviceShaderDrawParametersFeatures drawParametersFeatures{};
+  drawParametersFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
+  drawParametersFeatures.shaderDrawParameters = VK_TRUE;
+
+  /* texture table, the fragment shaders index a runtime sized array */
+  VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};
+  descriptorIndexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+  descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing =
+      VK_TRUE;
+  descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind =
+      VK_TRUE;
+  descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending =
+      VK_TRUE;
+  descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+  descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+
+  auto secondPhysicalDevSelRet =
+      physicalDevSel.set_surface(mSurface)
+          .set_required_features(physFeatures)
+          .add_required_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)
+          .add_required_extension_features(drawParametersFeatures)
+          .add_required_extension_features(descriptorIndexingFeatures)
+          .select();
 
   if (!secondPhysicalDevSelRet) {
     Logger::log(1, "%s error: could not get physical devices\n", __FUNCTION__);
@@ -1144,6 +1726,9 @@ bool VkRenderer::deviceInit() {
   }
 
   mRenderData.rdVkbPhysicalDevice = secondPhysicalDevSelRet.value();
+  /* without it every draw command needs its own call */
+  mRenderData.rdMultiDrawIndirectSupported = physFeatures.multiDrawIndirect;
+  mRenderData.rdUseMultiDrawIndirect = physFeatures.multiDrawIndirect;
   Logger::log(1, "%s: found physical device '%s'\n", __FUNCTION__,
               mRenderData.rdVkbPhysicalDevice.name.c_str());
 
@@ -1224,6 +1809,7 @@ bool VkRenderer::createDescriptorPool() {
       {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 10000},
       {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 10000},
       {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000},
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000},
       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000},
       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000},
   };
@@ -1250,63 +1836,53 @@ bool VkRenderer::createDescriptorPool() {
 bool VkRenderer::createDescriptorLayouts() {
   VkResult result;
 
-  {
-    /* texture */
-    VkDescriptorSetLayoutBinding assimpTextureBind{};
-    assimpTextureBind.descriptorType =
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    assimpTextureBind.binding = 0;
-    assimpTextureBind.descriptorCount = 1;
-    assimpTextureBind.pImmutableSamplers = nullptr;
-    assimpTextureBind.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-    std::vector<VkDescriptorSetLayoutBinding> assimpTexBindings = {
-        assimpTextureBind};
-
-    VkDescriptorSetLayoutCreateInfo assimpTextureCreateInfo{};
-    assimpTextureCreateInfo.sType =
-        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    assimpTextureCreateInfo.bindingCount =
-        static_cast<uint32_t>(assimpTexBindings.size());
-    assimpTextureCreateInfo.pBindings = assimpTexBindings.data();
-
-    result = vkCreateDescriptorSetLayout(
-        mRenderData.rdVkbDevice.device, &assimpTextureCreateInfo, nullptr,
-        &mRenderData.rdAssimpTextureDescriptorLayout);
-    if (result != VK_SUCCESS) {
-      Logger::log(1,
-                  "%s error: could not create Assimp texturedescriptor set "
-                  "layout (error: %i)\n",
-                  __FUNCTION__, result);
-      return false;
-    }
-  }
+  /* texture table, one set for the textures of all models */
+  if (!TextureTable::init(mRenderData)) {
+    Logger::log(1, "%s error: could not init texture table\n", __FUNCTION__);
+    return false;
+  }
 
   {
     /* non-animated shader */
     VkDescriptorSetLayoutBinding assimpUboBind{};
-    assimpUboBind.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    assimpUboBind.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     assimpUboBind.binding = 0;
     assimpUboBind.descriptorCount = 1;
     assimpUboBind.pImmutableSamplers = nullptr;
     assimpUboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
     VkDescriptorSetLayoutBinding assimpSsboBind{};
-    assimpSsboBind.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpSsboBind.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     assimpSsboBind.binding = 1;
     assimpSsboBind.descriptorCount = 1;
     assimpSsboBind.pImmutableSamplers = nullptr;
     assimpSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
     VkDescriptorSetLayoutBinding assimpSsboBind2{};
-    assimpSsboBind2.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpSsboBind2.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     assimpSsboBind2.binding = 2;
     assimpSsboBind2.descriptorCount = 1;
     assimpSsboBind2.pImmutableSamplers = nullptr;
     assimpSsboBind2.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
+    VkDescriptorSetLayoutBinding assimpVisibleSsboBind{};
+    assimpVisibleSsboBind.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpVisibleSsboBind.binding = 3;
+    assimpVisibleSsboBind.descriptorCount = 1;
+    assimpVisibleSsboBind.pImmutableSamplers = nullptr;
+    assimpVisibleSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutBinding assimpDrawDataSsboBind{};
+    assimpDrawDataSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpDrawDataSsboBind.binding = 4;
+    assimpDrawDataSsboBind.descriptorCount = 1;
+    assimpDrawDataSsboBind.pImmutableSamplers = nullptr;
+    assimpDrawDataSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
     std::vector<VkDescriptorSetLayoutBinding> assimpBindings = {
-        assimpUboBind, assimpSsboBind, assimpSsboBind2};
+        assimpUboBind, assimpSsboBind, assimpSsboBind2, assimpVisibleSsboBind,
+        assimpDrawDataSsboBind};
 
     VkDescriptorSetLayoutCreateInfo assimpCreateInfo{};
     assimpCreateInfo.sType =
@@ -1330,7 +1906,7 @@ bool VkRenderer::createDescriptorLayouts() {
   {
     /* animated shader */
     VkDescriptorSetLayoutBinding assimpUboBind{};
-    assimpUboBind.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    assimpUboBind.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     assimpUboBind.binding = 0;
     assimpUboBind.descriptorCount = 1;
     assimpUboBind.pImmutableSamplers = nullptr;
@@ -1344,22 +1920,50 @@ bool VkRenderer::createDescriptorLayouts() {
     assimpSkinningSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
     VkDescriptorSetLayoutBinding assimpSkinningSsboBind2{};
-    assimpSkinningSsboBind2.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpSkinningSsboBind2.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     assimpSkinningSsboBind2.binding = 2;
     assimpSkinningSsboBind2.descriptorCount = 1;
     assimpSkinningSsboBind2.pImmutableSamplers = nullptr;
     assimpSkinningSsboBind2.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
     VkDescriptorSetLayoutBinding assimpSkinningSsboBind3{};
-    assimpSkinningSsboBind3.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpSkinningSsboBind3.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     assimpSkinningSsboBind3.binding = 3;
     assimpSkinningSsboBind3.descriptorCount = 1;
     assimpSkinningSsboBind3.pImmutableSamplers = nullptr;
     assimpSkinningSsboBind3.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
+    VkDescriptorSetLayoutBinding assimpSkinningVisibleSsboBind{};
+    assimpSkinningVisibleSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpSkinningVisibleSsboBind.binding = 4;
+    assimpSkinningVisibleSsboBind.descriptorCount = 1;
+    assimpSkinningVisibleSsboBind.pImmutableSamplers = nullptr;
+    assimpSkinningVisibleSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    /* only read by the baked animation shader */
+    VkDescriptorSetLayoutBinding assimpSkinningBakedSsboBind{};
+    assimpSkinningBakedSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpSkinningBakedSsboBind.binding = 5;
+    assimpSkinningBakedSsboBind.descriptorCount = 1;
+    assimpSkinningBakedSsboBind.pImmutableSamplers = nullptr;
+    assimpSkinningBakedSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutBinding assimpSkinningDrawDataSsboBind{};
+    assimpSkinningDrawDataSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpSkinningDrawDataSsboBind.binding = 6;
+    assimpSkinningDrawDataSsboBind.descriptorCount = 1;
+    assimpSkinningDrawDataSsboBind.pImmutableSamplers = nullptr;
+    assimpSkinningDrawDataSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
     std::vector<VkDescriptorSetLayoutBinding> assimpSkinningBindings = {
         assimpUboBind, assimpSkinningSsboBind, assimpSkinningSsboBind2,
-        assimpSkinningSsboBind3};
+        assimpSkinningSsboBind3, assimpSkinningVisibleSsboBind,
+        assimpSkinningBakedSsboBind, assimpSkinningDrawDataSsboBind};
 
     VkDescriptorSetLayoutCreateInfo assimpSkinningCreateInfo{};
     assimpSkinningCreateInfo.sType =
@@ -1380,10 +1984,39 @@ bool VkRenderer::createDescriptorLayouts() {
     }
   }
 
+  {
+    /* baked animations, per-model data */
+    VkDescriptorSetLayoutBinding assimpBakedMatrixSsboBind{};
+    assimpBakedMatrixSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpBakedMatrixSsboBind.binding = 0;
+    assimpBakedMatrixSsboBind.descriptorCount = 1;
+    assimpBakedMatrixSsboBind.pImmutableSamplers = nullptr;
+    assimpBakedMatrixSsboBind.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo assimpBakedPerModelCreateInfo{};
+    assimpBakedPerModelCreateInfo.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    assimpBakedPerModelCreateInfo.bindingCount = 1;
+    assimpBakedPerModelCreateInfo.pBindings = &assimpBakedMatrixSsboBind;
+
+    result = vkCreateDescriptorSetLayout(
+        mRenderData.rdVkbDevice.device, &assimpBakedPerModelCreateInfo,
+        nullptr, &mRenderData.rdAssimpSkinningBakedPerModelDescriptorLayout);
+    if (result != VK_SUCCESS) {
+      Logger::log(1,
+                  "%s error: could not create Assimp baked animation per "
+                  "model descriptor set layout (error: %i)\n",
+                  __FUNCTION__, result);
+      return false;
+    }
+  }
+
   {
     /* compute transformation shader */
     VkDescriptorSetLayoutBinding assimpTransformSsboBind{};
-    assimpTransformSsboBind.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpTransformSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     assimpTransformSsboBind.binding = 0;
     assimpTransformSsboBind.descriptorCount = 1;
     assimpTransformSsboBind.pImmutableSamplers = nullptr;
@@ -1474,8 +2107,43 @@ bool VkRenderer::createDescriptorLayouts() {
     assimpBoneOffsetSsboBind.pImmutableSamplers = nullptr;
     assimpBoneOffsetSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
+    /* bones sorted by hierarchy level, only used by the fused shader */
+    VkDescriptorSetLayoutBinding assimpBoneLevelSsboBind{};
+    assimpBoneLevelSsboBind.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpBoneLevelSsboBind.binding = 2;
+    assimpBoneLevelSsboBind.descriptorCount = 1;
+    assimpBoneLevelSsboBind.pImmutableSamplers = nullptr;
+    assimpBoneLevelSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    /* channel key ranges, key times and key values for the GPU sampling */
+    VkDescriptorSetLayoutBinding assimpAnimChannelSsboBind{};
+    assimpAnimChannelSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpAnimChannelSsboBind.binding = 3;
+    assimpAnimChannelSsboBind.descriptorCount = 1;
+    assimpAnimChannelSsboBind.pImmutableSamplers = nullptr;
+    assimpAnimChannelSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpAnimKeyTimeSsboBind{};
+    assimpAnimKeyTimeSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpAnimKeyTimeSsboBind.binding = 4;
+    assimpAnimKeyTimeSsboBind.descriptorCount = 1;
+    assimpAnimKeyTimeSsboBind.pImmutableSamplers = nullptr;
+    assimpAnimKeyTimeSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpAnimKeyValueSsboBind{};
+    assimpAnimKeyValueSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpAnimKeyValueSsboBind.binding = 5;
+    assimpAnimKeyValueSsboBind.descriptorCount = 1;
+    assimpAnimKeyValueSsboBind.pImmutableSamplers = nullptr;
+    assimpAnimKeyValueSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
     std::vector<VkDescriptorSetLayoutBinding> assimpMatMultPerModelBindings = {
-        assimpParentMatrixSsboBind, assimpBoneOffsetSsboBind};
+        assimpParentMatrixSsboBind, assimpBoneOffsetSsboBind,
+        assimpBoneLevelSsboBind, assimpAnimChannelSsboBind,
+        assimpAnimKeyTimeSsboBind, assimpAnimKeyValueSsboBind};
 
     VkDescriptorSetLayoutCreateInfo assimpMatrixMultPerModelCreateInfo{};
     assimpMatrixMultPerModelCreateInfo.sType =
@@ -1498,6 +2166,142 @@ bool VkRenderer::createDescriptorLayouts() {
     }
   }
 
+  {
+    /* frustum culling compute shader */
+    VkDescriptorSetLayoutBinding assimpCullWorldPosSsboBind{};
+    assimpCullWorldPosSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpCullWorldPosSsboBind.binding = 0;
+    assimpCullWorldPosSsboBind.descriptorCount = 1;
+    assimpCullWorldPosSsboBind.pImmutableSamplers = nullptr;
+    assimpCullWorldPosSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpCullDataSsboBind{};
+    assimpCullDataSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpCullDataSsboBind.binding = 1;
+    assimpCullDataSsboBind.descriptorCount = 1;
+    assimpCullDataSsboBind.pImmutableSamplers = nullptr;
+    assimpCullDataSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpCullCommandSsboBind{};
+    assimpCullCommandSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpCullCommandSsboBind.binding = 2;
+    assimpCullCommandSsboBind.descriptorCount = 1;
+    assimpCullCommandSsboBind.pImmutableSamplers = nullptr;
+    assimpCullCommandSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpCullVisibleSsboBind{};
+    assimpCullVisibleSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpCullVisibleSsboBind.binding = 3;
+    assimpCullVisibleSsboBind.descriptorCount = 1;
+    assimpCullVisibleSsboBind.pImmutableSamplers = nullptr;
+    assimpCullVisibleSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    std::vector<VkDescriptorSetLayoutBinding> assimpCullBindings = {
+        assimpCullWorldPosSsboBind, assimpCullDataSsboBind,
+        assimpCullCommandSsboBind, assimpCullVisibleSsboBind};
+
+    VkDescriptorSetLayoutCreateInfo assimpCullCreateInfo{};
+    assimpCullCreateInfo.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    assimpCullCreateInfo.bindingCount =
+        static_cast<uint32_t>(assimpCullBindings.size());
+    assimpCullCreateInfo.pBindings = assimpCullBindings.data();
+
+    result = vkCreateDescriptorSetLayout(
+        mRenderData.rdVkbDevice.device, &assimpCullCreateInfo, nullptr,
+        &mRenderData.rdAssimpComputeCullDescriptorLayout);
+    if (result != VK_SUCCESS) {
+      Logger::log(1,
+                  "%s error: could not create Assimp culling compute buffer "
+                  "descriptor set layout (error: %i)\n",
+                  __FUNCTION__, result);
+      return false;
+    }
+  }
+
+  {
+    /* fused transform and matrix multiplication shader, global data */
+    VkDescriptorSetLayoutBinding assimpFusedTransformSsboBind{};
+    assimpFusedTransformSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpFusedTransformSsboBind.binding = 0;
+    assimpFusedTransformSsboBind.descriptorCount = 1;
+    assimpFusedTransformSsboBind.pImmutableSamplers = nullptr;
+    assimpFusedTransformSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpFusedNodeMatricesSsboBind{};
+    assimpFusedNodeMatricesSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpFusedNodeMatricesSsboBind.binding = 1;
+    assimpFusedNodeMatricesSsboBind.descriptorCount = 1;
+    assimpFusedNodeMatricesSsboBind.pImmutableSamplers = nullptr;
+    assimpFusedNodeMatricesSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    std::vector<VkDescriptorSetLayoutBinding> assimpFusedBindings = {
+        assimpFusedTransformSsboBind, assimpFusedNodeMatricesSsboBind};
+
+    VkDescriptorSetLayoutCreateInfo assimpFusedCreateInfo{};
+    assimpFusedCreateInfo.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    assimpFusedCreateInfo.bindingCount =
+        static_cast<uint32_t>(assimpFusedBindings.size());
+    assimpFusedCreateInfo.pBindings = assimpFusedBindings.data();
+
+    result = vkCreateDescriptorSetLayout(
+        mRenderData.rdVkbDevice.device, &assimpFusedCreateInfo, nullptr,
+        &mRenderData.rdAssimpComputeFusedDescriptorLayout);
+    if (result != VK_SUCCESS) {
+      Logger::log(1,
+                  "%s error: could not create Assimp fused skinning compute "
+                  "buffer descriptor set layout (error: %i)\n",
+                  __FUNCTION__, result);
+      return false;
+    }
+  }
+
+  {
+    /* keyframe sampling shader, global data */
+    VkDescriptorSetLayoutBinding assimpAnimInstanceSsboBind{};
+    assimpAnimInstanceSsboBind.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    assimpAnimInstanceSsboBind.binding = 0;
+    assimpAnimInstanceSsboBind.descriptorCount = 1;
+    assimpAnimInstanceSsboBind.pImmutableSamplers = nullptr;
+    assimpAnimInstanceSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding assimpGpuPoseSsboBind{};
+    assimpGpuPoseSsboBind.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    assimpGpuPoseSsboBind.binding = 1;
+    assimpGpuPoseSsboBind.descriptorCount = 1;
+    assimpGpuPoseSsboBind.pImmutableSamplers = nullptr;
+    assimpGpuPoseSsboBind.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    std::vector<VkDescriptorSetLayoutBinding> assimpAnimSampleBindings = {
+        assimpAnimInstanceSsboBind, assimpGpuPoseSsboBind};
+
+    VkDescriptorSetLayoutCreateInfo assimpAnimSampleCreateInfo{};
+    assimpAnimSampleCreateInfo.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    assimpAnimSampleCreateInfo.bindingCount =
+        static_cast<uint32_t>(assimpAnimSampleBindings.size());
+    assimpAnimSampleCreateInfo.pBindings = assimpAnimSampleBindings.data();
+
+    result = vkCreateDescriptorSetLayout(
+        mRenderData.rdVkbDevice.device, &assimpAnimSampleCreateInfo, nullptr,
+        &mRenderData.rdAssimpComputeAnimSampleDescriptorLayout);
+    if (result != VK_SUCCESS) {
+      Logger::log(1,
+                  "%s error: could not create Assimp keyframe sampling "
+                  "compute buffer descriptor set layout (error: %i)\n",
+                  __FUNCTION__, result);
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -1581,6 +2385,92 @@ bool VkRenderer::createDescriptorSets() {
     return false;
   }
 
+  /* frustum culling */
+  VkDescriptorSetAllocateInfo computeCullDescriptorAllocateInfo{};
+  computeCullDescriptorAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  computeCullDescriptorAllocateInfo.descriptorPool =
+      mRenderData.rdDescriptorPool;
+  computeCullDescriptorAllocateInfo.descriptorSetCount = 1;
+  computeCullDescriptorAllocateInfo.pSetLayouts =
+      &mRenderData.rdAssimpComputeCullDescriptorLayout;
+
+  result = vkAllocateDescriptorSets(
+      mRenderData.rdVkbDevice.device, &computeCullDescriptorAllocateInfo,
+      &mRenderData.rdAssimpComputeCullDescriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate Assimp Culling Compute "
+                "descriptor set (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  /* fused transform and matrix multiplication */
+  VkDescriptorSetAllocateInfo computeFusedDescriptorAllocateInfo{};
+  computeFusedDescriptorAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  computeFusedDescriptorAllocateInfo.descriptorPool =
+      mRenderData.rdDescriptorPool;
+  computeFusedDescriptorAllocateInfo.descriptorSetCount = 1;
+  computeFusedDescriptorAllocateInfo.pSetLayouts =
+      &mRenderData.rdAssimpComputeFusedDescriptorLayout;
+
+  result = vkAllocateDescriptorSets(
+      mRenderData.rdVkbDevice.device, &computeFusedDescriptorAllocateInfo,
+      &mRenderData.rdAssimpComputeFusedDescriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate Assimp Fused Compute "
+                "descriptor set (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  /* keyframe sampling */
+  VkDescriptorSetAllocateInfo computeAnimSampleDescriptorAllocateInfo{};
+  computeAnimSampleDescriptorAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  computeAnimSampleDescriptorAllocateInfo.descriptorPool =
+      mRenderData.rdDescriptorPool;
+  computeAnimSampleDescriptorAllocateInfo.descriptorSetCount = 1;
+  computeAnimSampleDescriptorAllocateInfo.pSetLayouts =
+      &mRenderData.rdAssimpComputeAnimSampleDescriptorLayout;
+
+  result = vkAllocateDescriptorSets(
+      mRenderData.rdVkbDevice.device, &computeAnimSampleDescriptorAllocateInfo,
+      &mRenderData.rdAssimpComputeAnimSampleDescriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate Assimp Keyframe Sampling "
+                "Compute descriptor set (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  /* compute transform and fused compute, reading the GPU poses */
+  result = vkAllocateDescriptorSets(
+      mRenderData.rdVkbDevice.device, &computeTransformDescriptorAllocateInfo,
+      &mRenderData.rdAssimpComputeTransformGpuPoseDescriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate Assimp Transform Compute GPU "
+                "pose descriptor set (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  result = vkAllocateDescriptorSets(
+      mRenderData.rdVkbDevice.device, &computeFusedDescriptorAllocateInfo,
+      &mRenderData.rdAssimpComputeFusedGpuPoseDescriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate Assimp Fused Compute GPU pose "
+                "descriptor set (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
   updateDescriptorSets();
   updateComputeDescriptorSets();
 
@@ -1595,21 +2485,22 @@ bool VkRenderer::updateDescriptorSets() {
     VkDescriptorBufferInfo matrixInfo{};
     matrixInfo.buffer = mPerspectiveViewMatrixUBO.buffer;
     matrixInfo.offset = 0;
-    matrixInfo.range = VK_WHOLE_SIZE;
+    matrixInfo.range = mPerspectiveViewMatrixUBO.frameSize;
 
     VkDescriptorBufferInfo worldPosInfo{};
     worldPosInfo.buffer = mShaderModelRootMatrixBuffer.buffer;
     worldPosInfo.offset = 0;
-    worldPosInfo.range = VK_WHOLE_SIZE;
+    worldPosInfo.range = mShaderModelRootMatrixBuffer.frameSize;
 
     VkDescriptorBufferInfo selectionInfo{};
     selectionInfo.buffer = mSelectedInstanceBuffer.buffer;
     selectionInfo.offset = 0;
-    selectionInfo.range = VK_WHOLE_SIZE;
+    selectionInfo.range = mSelectedInstanceBuffer.frameSize;
 
     VkWriteDescriptorSet matrixWriteDescriptorSet{};
     matrixWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    matrixWriteDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    matrixWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     matrixWriteDescriptorSet.dstSet = mRenderData.rdAssimpDescriptorSet;
     matrixWriteDescriptorSet.dstBinding = 0;
     matrixWriteDescriptorSet.descriptorCount = 1;
@@ -1617,7 +2508,8 @@ bool VkRenderer::updateDescriptorSets() {
 
     VkWriteDescriptorSet posWriteDescriptorSet{};
     posWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    posWriteDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    posWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     posWriteDescriptorSet.dstSet = mRenderData.rdAssimpDescriptorSet;
     posWriteDescriptorSet.dstBinding = 1;
     posWriteDescriptorSet.descriptorCount = 1;
@@ -1626,15 +2518,44 @@ bool VkRenderer::updateDescriptorSets() {
     VkWriteDescriptorSet selectionWriteDescriptorSet{};
     selectionWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     selectionWriteDescriptorSet.descriptorType =
-        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     selectionWriteDescriptorSet.dstSet = mRenderData.rdAssimpDescriptorSet;
     selectionWriteDescriptorSet.dstBinding = 2;
     selectionWriteDescriptorSet.descriptorCount = 1;
     selectionWriteDescriptorSet.pBufferInfo = &selectionInfo;
 
+    VkDescriptorBufferInfo visibleInfo{};
+    visibleInfo.buffer = mVisibleInstanceBuffer.buffer;
+    visibleInfo.offset = 0;
+    visibleInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet visibleWriteDescriptorSet{};
+    visibleWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    visibleWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    visibleWriteDescriptorSet.dstSet = mRenderData.rdAssimpDescriptorSet;
+    visibleWriteDescriptorSet.dstBinding = 3;
+    visibleWriteDescriptorSet.descriptorCount = 1;
+    visibleWriteDescriptorSet.pBufferInfo = &visibleInfo;
+
+    VkDescriptorBufferInfo drawDataInfo{};
+    drawDataInfo.buffer = mDrawDataBuffer.buffer;
+    drawDataInfo.offset = 0;
+    drawDataInfo.range = mDrawDataBuffer.frameSize;
+
+    VkWriteDescriptorSet drawDataWriteDescriptorSet{};
+    drawDataWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    drawDataWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    drawDataWriteDescriptorSet.dstSet = mRenderData.rdAssimpDescriptorSet;
+    drawDataWriteDescriptorSet.dstBinding = 4;
+    drawDataWriteDescriptorSet.descriptorCount = 1;
+    drawDataWriteDescriptorSet.pBufferInfo = &drawDataInfo;
+
     std::vector<VkWriteDescriptorSet> writeDescriptorSets = {
         matrixWriteDescriptorSet, posWriteDescriptorSet,
-        selectionWriteDescriptorSet};
+        selectionWriteDescriptorSet, visibleWriteDescriptorSet,
+        drawDataWriteDescriptorSet};
 
     vkUpdateDescriptorSets(mRenderData.rdVkbDevice.device,
                            static_cast<uint32_t>(writeDescriptorSets.size()),
@@ -1646,7 +2567,7 @@ bool VkRenderer::updateDescriptorSets() {
     VkDescriptorBufferInfo matrixInfo{};
     matrixInfo.buffer = mPerspectiveViewMatrixUBO.buffer;
     matrixInfo.offset = 0;
-    matrixInfo.range = VK_WHOLE_SIZE;
+    matrixInfo.range = mPerspectiveViewMatrixUBO.frameSize;
 
     VkDescriptorBufferInfo boneMatrixInfo{};
     boneMatrixInfo.buffer = mShaderBoneMatrixBuffer.buffer;
@@ -1656,16 +2577,17 @@ bool VkRenderer::updateDescriptorSets() {
     VkDescriptorBufferInfo worldPosInfo{};
     worldPosInfo.buffer = mShaderModelRootMatrixBuffer.buffer;
     worldPosInfo.offset = 0;
-    worldPosInfo.range = VK_WHOLE_SIZE;
+    worldPosInfo.range = mShaderModelRootMatrixBuffer.frameSize;
 
     VkDescriptorBufferInfo selectionInfo{};
     selectionInfo.buffer = mSelectedInstanceBuffer.buffer;
     selectionInfo.offset = 0;
-    selectionInfo.range = VK_WHOLE_SIZE;
+    selectionInfo.range = mSelectedInstanceBuffer.frameSize;
 
     VkWriteDescriptorSet matrixWriteDescriptorSet{};
     matrixWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    matrixWriteDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    matrixWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     matrixWriteDescriptorSet.dstSet = mRenderData.rdAssimpSkinningDescriptorSet;
     matrixWriteDescriptorSet.dstBinding = 0;
     matrixWriteDescriptorSet.descriptorCount = 1;
@@ -1683,7 +2605,8 @@ bool VkRenderer::updateDescriptorSets() {
 
     VkWriteDescriptorSet posWriteDescriptorSet{};
     posWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    posWriteDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    posWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     posWriteDescriptorSet.dstSet = mRenderData.rdAssimpSkinningDescriptorSet;
     posWriteDescriptorSet.dstBinding = 2;
     posWriteDescriptorSet.descriptorCount = 1;
@@ -1692,16 +2615,64 @@ bool VkRenderer::updateDescriptorSets() {
     VkWriteDescriptorSet selectionWriteDescriptorSet{};
     selectionWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     selectionWriteDescriptorSet.descriptorType =
-        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     selectionWriteDescriptorSet.dstSet =
         mRenderData.rdAssimpSkinningDescriptorSet;
     selectionWriteDescriptorSet.dstBinding = 3;
     selectionWriteDescriptorSet.descriptorCount = 1;
     selectionWriteDescriptorSet.pBufferInfo = &selectionInfo;
 
+    VkDescriptorBufferInfo visibleInfo{};
+    visibleInfo.buffer = mVisibleInstanceBuffer.buffer;
+    visibleInfo.offset = 0;
+    visibleInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet visibleWriteDescriptorSet{};
+    visibleWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    visibleWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    visibleWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpSkinningDescriptorSet;
+    visibleWriteDescriptorSet.dstBinding = 4;
+    visibleWriteDescriptorSet.descriptorCount = 1;
+    visibleWriteDescriptorSet.pBufferInfo = &visibleInfo;
+
+    VkDescriptorBufferInfo bakedInstanceInfo{};
+    bakedInstanceInfo.buffer = mBakedInstanceBuffer.buffer;
+    bakedInstanceInfo.offset = 0;
+    bakedInstanceInfo.range = mBakedInstanceBuffer.frameSize;
+
+    VkWriteDescriptorSet bakedInstanceWriteDescriptorSet{};
+    bakedInstanceWriteDescriptorSet.sType =
+        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    bakedInstanceWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bakedInstanceWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpSkinningDescriptorSet;
+    bakedInstanceWriteDescriptorSet.dstBinding = 5;
+    bakedInstanceWriteDescriptorSet.descriptorCount = 1;
+    bakedInstanceWriteDescriptorSet.pBufferInfo = &bakedInstanceInfo;
+
+    VkDescriptorBufferInfo drawDataInfo{};
+    drawDataInfo.buffer = mDrawDataBuffer.buffer;
+    drawDataInfo.offset = 0;
+    drawDataInfo.range = mDrawDataBuffer.frameSize;
+
+    VkWriteDescriptorSet drawDataWriteDescriptorSet{};
+    drawDataWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    drawDataWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    drawDataWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpSkinningDescriptorSet;
+    drawDataWriteDescriptorSet.dstBinding = 6;
+    drawDataWriteDescriptorSet.descriptorCount = 1;
+    drawDataWriteDescriptorSet.pBufferInfo = &drawDataInfo;
+
     std::vector<VkWriteDescriptorSet> skinningWriteDescriptorSets = {
         matrixWriteDescriptorSet, boneMatrixWriteDescriptorSet,
-        posWriteDescriptorSet, selectionWriteDescriptorSet};
+        posWriteDescriptorSet, selectionWriteDescriptorSet,
+        visibleWriteDescriptorSet, bakedInstanceWriteDescriptorSet,
+        drawDataWriteDescriptorSet};
 
     vkUpdateDescriptorSets(
         mRenderData.rdVkbDevice.device,
@@ -1822,48 +2793,29 @@ bool VkRenderer::createSelectionImage() {
     return false;
   }
 
-  /* local copy destination image */
-  mRenderData.rdLocalSelectionFormat = mRenderData.rdSelectionFormat;
-
-  selectImageInfo.tiling = VK_IMAGE_TILING_LINEAR;
-  selectImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  selectImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-
-  selectionAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-  selectionAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-  result =
-      vmaCreateImage(mRenderData.rdAllocator, &selectImageInfo,
-                     &selectionAllocInfo, &mRenderData.rdLocalSelectionImage,
-                     &mRenderData.rdLocalSelectionImageAlloc, nullptr);
-  if (result != VK_SUCCESS) {
-    Logger::log(1,
-                "%s error: could not create local selection buffer image view "
-                "(error: %i)\n",
-                __FUNCTION__, result);
-    return false;
-  }
-
-  selectImageViewInfo.image = mRenderData.rdLocalSelectionImage;
-  selectImageViewInfo.format = mRenderData.rdLocalSelectionFormat;
+  return true;
+}
 
-  result =
-      vkCreateImageView(mRenderData.rdVkbDevice.device, &selectImageViewInfo,
-                        nullptr, &mRenderData.rdLocalSelectionImageView);
-  if (result != VK_SUCCESS) {
-    Logger::log(1,
-                "%s error: could not create local selection buffer image view "
-                "(error: %i)\n",
-                __FUNCTION__, result);
-    return false;
+bool VkRenderer::createSelectionReadbacks() {
+  mSelectionReadbacks.resize(kMaxFramesInFlight);
+  for (auto& readback : mSelectionReadbacks) {
+    if (!Framebuffer::initSelectionReadback(mRenderData, &readback)) {
+      Logger::log(1, "%s error: could not create selection readback buffer\n",
+                  __FUNCTION__);
+      return false;
+    }
   }
-
   return true;
 }
 
 bool VkRenderer::createMatrixUBO() {
-  if (!UniformBuffer::init(mRenderData, &mPerspectiveViewMatrixUBO)) {
+  VkDeviceSize minUBOOffsetAlignment =
+      mRenderData.rdVkbPhysicalDevice.properties.limits
+          .minUniformBufferOffsetAlignment;
+  if (!FrameRingBuffer::init(mRenderData, &mPerspectiveViewMatrixUBO,
+                             sizeof(VkUploadMatrices), kMaxFramesInFlight,
+                             minUBOOffsetAlignment,
+                             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)) {
     Logger::log(1, "%s error: could not create matrix uniform buffers\n",
                 __FUNCTION__);
     return false;
@@ -1878,13 +2830,15 @@ bool VkRenderer::createSSBOs() {
     return false;
   }
 
-  if (!ShaderStorageBuffer::init(mRenderData, &mShaderModelRootMatrixBuffer)) {
+  if (!FrameRingBuffer::init(mRenderData, &mShaderModelRootMatrixBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
     Logger::log(1, "%s error: could not create nodel root position SSBO\n",
                 __FUNCTION__);
     return false;
   }
 
-  if (!ShaderStorageBuffer::init(mRenderData, &mShaderNodeTransformBuffer)) {
+  if (!FrameRingBuffer::init(mRenderData, &mShaderNodeTransformBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
     Logger::log(1, "%s error: could not create node transform SSBO\n",
                 __FUNCTION__);
     return false;
@@ -1896,8 +2850,60 @@ bool VkRenderer::createSSBOs() {
     return false;
   }
 
-  if (!ShaderStorageBuffer::init(mRenderData, &mSelectedInstanceBuffer)) {
-    Logger::log(1, "%s error: could not create bone matrix SSBO\n",
+  if (!FrameRingBuffer::init(mRenderData, &mSelectedInstanceBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
+    Logger::log(1, "%s error: could not create selection SSBO\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  if (!FrameRingBuffer::init(mRenderData, &mCullInstanceBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
+    Logger::log(1, "%s error: could not create culling data SSBO\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  /* the culling shader writes the instance counts of the draw commands */
+  if (!FrameRingBuffer::init(mRenderData, &mDrawCommandBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment,
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                 VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)) {
+    Logger::log(1, "%s error: could not create indirect draw buffer\n",
+                __FUNCTION__);
+    return false;
+  }
+  mCullFrameInstanceCounts.resize(kMaxFramesInFlight, 0);
+
+  if (!ShaderStorageBuffer::init(mRenderData, &mVisibleInstanceBuffer)) {
+    Logger::log(1, "%s error: could not create visible instances SSBO\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  if (!FrameRingBuffer::init(mRenderData, &mAnimInstanceBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
+    Logger::log(1, "%s error: could not create animation instance SSBO\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  if (!ShaderStorageBuffer::init(mRenderData, &mShaderGpuPoseBuffer)) {
+    Logger::log(1, "%s error: could not create GPU pose SSBO\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  if (!FrameRingBuffer::init(mRenderData, &mBakedInstanceBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
+    Logger::log(1, "%s error: could not create baked instance SSBO\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  if (!FrameRingBuffer::init(mRenderData, &mDrawDataBuffer, 1024,
+                             kMaxFramesInFlight, mMinSSBOOffsetAlignment)) {
+    Logger::log(1, "%s error: could not create draw data SSBO\n",
                 __FUNCTION__);
     return false;
   }
@@ -1969,6 +2975,21 @@ bool VkRenderer::createPipelineLayouts() {
     return false;
   }
 
+  /* baked animations, the frames come from a per-model set */
+  std::vector<VkDescriptorSetLayout> skinningBakedLayouts = {
+      mRenderData.rdAssimpTextureDescriptorLayout,
+      mRenderData.rdAssimpSkinningDescriptorLayout,
+      mRenderData.rdAssimpSkinningBakedPerModelDescriptorLayout};
+
+  if (!PipelineLayout::init(mRenderData,
+                            &mRenderData.rdAssimpSkinningBakedPipelineLayout,
+                            skinningBakedLayouts, pushConstants)) {
+    Logger::log(
+        1, "%s error: could not init Assimp baked Skinning pipeline layout\n",
+        __FUNCTION__);
+    return false;
+  }
+
   /* transform compute */
   std::vector<VkPushConstantRange> computePushConstants = {
       {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VkComputePushConstants)}};
@@ -2001,6 +3022,54 @@ bool VkRenderer::createPipelineLayouts() {
     return false;
   }
 
+  /* fused transform and matrix mult compute, same per-model set */
+  std::vector<VkDescriptorSetLayout> fusedLayouts = {
+      mRenderData.rdAssimpComputeFusedDescriptorLayout,
+      mRenderData.rdAssimpComputeMatrixMultPerModelDescriptorLayout};
+
+  if (!PipelineLayout::init(mRenderData,
+                            &mRenderData.rdAssimpComputeFusedPipelineLayout,
+                            fusedLayouts, computePushConstants)) {
+    Logger::log(
+        1, "%s error: could not init Assimp fused compute pipeline layout\n",
+        __FUNCTION__);
+    return false;
+  }
+
+  /* keyframe sampling compute, same per-model set */
+  std::vector<VkPushConstantRange> animSamplePushConstants = {
+      {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VkAnimSamplingPushConstants)}};
+
+  std::vector<VkDescriptorSetLayout> animSampleLayouts = {
+      mRenderData.rdAssimpComputeAnimSampleDescriptorLayout,
+      mRenderData.rdAssimpComputeMatrixMultPerModelDescriptorLayout};
+
+  if (!PipelineLayout::init(
+          mRenderData, &mRenderData.rdAssimpComputeAnimSamplePipelineLayout,
+          animSampleLayouts, animSamplePushConstants)) {
+    Logger::log(1,
+                "%s error: could not init Assimp keyframe sampling compute "
+                "pipeline layout\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  /* frustum culling compute, frustum planes in push constants */
+  std::vector<VkPushConstantRange> cullPushConstants = {
+      {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VkCullPushConstants)}};
+
+  std::vector<VkDescriptorSetLayout> cullLayouts = {
+      mRenderData.rdAssimpComputeCullDescriptorLayout};
+
+  if (!PipelineLayout::init(mRenderData,
+                            &mRenderData.rdAssimpComputeCullPipelineLayout,
+                            cullLayouts, cullPushConstants)) {
+    Logger::log(
+        1, "%s error: could not init Assimp culling compute pipeline layout\n",
+        __FUNCTION__);
+    return false;
+  }
+
   return true;
 }
 
@@ -2026,6 +3095,76 @@ bool VkRenderer::createPipelines() {
     return false;
   }
 
+  vertexShaderFile = "shaders/assimp_skinning_dq.vert.spv";
+  if (!SkinningPipeline::init(mRenderData,
+                              mRenderData.rdAssimpSkinningPipelineLayout,
+                              &mRenderData.rdAssimpSkinningDualQuatPipeline,
+                              vertexShaderFile, fragmentShaderFile)) {
+    Logger::log(1,
+                "%s error: could not init Assimp dual quaternion Skinning "
+                "shader pipeline\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  vertexShaderFile = "shaders/assimp_skinning_baked.vert.spv";
+  if (!SkinningPipeline::init(mRenderData,
+                              mRenderData.rdAssimpSkinningBakedPipelineLayout,
+                              &mRenderData.rdAssimpSkinningBakedPipeline,
+                              vertexShaderFile, fragmentShaderFile)) {
+    Logger::log(
+        1, "%s error: could not init Assimp baked Skinning shader pipeline\n",
+        __FUNCTION__);
+    return false;
+  }
+
+  /* same shaders for the quantized vertex format */
+  vertexShaderFile = "shaders/assimp_packed.vert.spv";
+  fragmentShaderFile = "shaders/assimp.frag.spv";
+  if (!SkinningPipeline::init(mRenderData, mRenderData.rdAssimpPipelineLayout,
+                              &mRenderData.rdAssimpPackedPipeline,
+                              vertexShaderFile, fragmentShaderFile, true)) {
+    Logger::log(1, "%s error: could not init Assimp packed shader pipeline\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  vertexShaderFile = "shaders/assimp_skinning_packed.vert.spv";
+  fragmentShaderFile = "shaders/assimp_skinning.frag.spv";
+  if (!SkinningPipeline::init(mRenderData,
+                              mRenderData.rdAssimpSkinningPipelineLayout,
+                              &mRenderData.rdAssimpSkinningPackedPipeline,
+                              vertexShaderFile, fragmentShaderFile, true)) {
+    Logger::log(
+        1, "%s error: could not init Assimp packed Skinning shader pipeline\n",
+        __FUNCTION__);
+    return false;
+  }
+
+  vertexShaderFile = "shaders/assimp_skinning_dq_packed.vert.spv";
+  if (!SkinningPipeline::init(
+          mRenderData, mRenderData.rdAssimpSkinningPipelineLayout,
+          &mRenderData.rdAssimpSkinningDualQuatPackedPipeline,
+          vertexShaderFile, fragmentShaderFile, true)) {
+    Logger::log(1,
+                "%s error: could not init Assimp packed dual quaternion "
+                "Skinning shader pipeline\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  vertexShaderFile = "shaders/assimp_skinning_baked_packed.vert.spv";
+  if (!SkinningPipeline::init(mRenderData,
+                              mRenderData.rdAssimpSkinningBakedPipelineLayout,
+                              &mRenderData.rdAssimpSkinningBakedPackedPipeline,
+                              vertexShaderFile, fragmentShaderFile, true)) {
+    Logger::log(1,
+                "%s error: could not init Assimp packed baked Skinning shader "
+                "pipeline\n",
+                __FUNCTION__);
+    return false;
+  }
+
   std::string computeShaderFile = "shaders/assimp_inst_transform.comp.spv";
   if (!ComputePipeline::init(
           mRenderData, mRenderData.rdAssimpComputeTransformaPipelineLayout,
@@ -2048,6 +3187,38 @@ bool VkRenderer::createPipelines() {
     return false;
   }
 
+  computeShaderFile = "shaders/assimp_instance_cull.comp.spv";
+  if (!ComputePipeline::init(
+          mRenderData, mRenderData.rdAssimpComputeCullPipelineLayout,
+          &mRenderData.rdAssimpComputeCullPipeline, computeShaderFile)) {
+    Logger::log(1,
+                "%s error: could not init Assimp culling compute shader "
+                "pipeline\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  computeShaderFile = "shaders/assimp_anim_sample.comp.spv";
+  if (!ComputePipeline::init(
+          mRenderData, mRenderData.rdAssimpComputeAnimSamplePipelineLayout,
+          &mRenderData.rdAssimpComputeAnimSamplePipeline, computeShaderFile)) {
+    Logger::log(1,
+                "%s error: could not init Assimp keyframe sampling compute "
+                "shader pipeline\n",
+                __FUNCTION__);
+    return false;
+  }
+
+  computeShaderFile = "shaders/assimp_inst_fused.comp.spv";
+  if (!ComputePipeline::init(
+          mRenderData, mRenderData.rdAssimpComputeFusedPipelineLayout,
+          &mRenderData.rdAssimpComputeFusedPipeline, computeShaderFile)) {
+    Logger::log(
+        1, "%s error: could not init Assimp fused compute shader pipeline\n",
+        __FUNCTION__);
+    return false;
+  }
+
   return true;
 }
 
@@ -2082,23 +3253,73 @@ bool VkRenderer::createCommandPool() {
 }
 
 bool VkRenderer::createCommandBuffer() {
-  if (!CommandBuffer::init(mRenderData, mRenderData.rdCommandPool,
-                           &mRenderData.rdCommandBuffer)) {
-    Logger::log(1, "%s error: could not create command buffers\n",
+  /* one set of command buffers per frame in flight */
+  mRenderData.rdCommandBuffers.resize(kMaxFramesInFlight, VK_NULL_HANDLE);
+  mRenderData.rdComputeCommandBuffers.resize(kMaxFramesInFlight,
+                                             VK_NULL_HANDLE);
+  for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
+    if (!CommandBuffer::init(mRenderData, mRenderData.rdCommandPool,
+                             &mRenderData.rdCommandBuffers.at(i))) {
+      Logger::log(1, "%s error: could not create command buffers\n",
+                  __FUNCTION__);
+      return false;
+    }
+    if (!CommandBuffer::init(mRenderData, mRenderData.rdComputeCommandPool,
+                             &mRenderData.rdComputeCommandBuffers.at(i))) {
+      Logger::log(1, "%s error: could not create compute command buffers\n",
+                  __FUNCTION__);
+      return false;
+    }
+  }
+  mRenderData.rdCommandBuffer = mRenderData.rdCommandBuffers.at(0);
+  mRenderData.rdComputeCommandBuffer =
+      mRenderData.rdComputeCommandBuffers.at(0);
+  return true;
+}
+
+bool VkRenderer::createTimestampQueries() {
+  mTimestampsPending.resize(kMaxFramesInFlight, false);
+
+  /* the skinning shaders run on the compute queue, or on the graphics
+   * queue if there is no dedicated compute queue */
+  auto queueIndexRet = mRenderData.rdVkbDevice.get_queue_index(
+      mHasDedicatedComputeQueue ? vkb::QueueType::compute
+                                : vkb::QueueType::graphics);
+  if (!queueIndexRet.has_value()) {
+    Logger::log(1, "%s error: could not get compute queue index\n",
                 __FUNCTION__);
     return false;
   }
-  if (!CommandBuffer::init(mRenderData, mRenderData.rdComputeCommandPool,
-                           &mRenderData.rdComputeCommandBuffer)) {
-    Logger::log(1, "%s error: could not create compute command buffers\n",
+
+  uint32_t timestampBits = mRenderData.rdVkbPhysicalDevice.get_queue_families()
+                               .at(queueIndexRet.value())
+                               .timestampValidBits;
+  if (timestampBits == 0) {
+    Logger::log(1, "%s: compute queue has no timestamp support\n",
                 __FUNCTION__);
+    return true;
+  }
+  mTimestampPeriod =
+      mRenderData.rdVkbPhysicalDevice.properties.limits.timestampPeriod;
+
+  VkQueryPoolCreateInfo queryPoolInfo{};
+  queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  queryPoolInfo.queryCount = 2 * kMaxFramesInFlight;
+
+  VkResult result =
+      vkCreateQueryPool(mRenderData.rdVkbDevice.device, &queryPoolInfo,
+                        nullptr, &mTimestampQueryPool);
+  if (result != VK_SUCCESS) {
+    Logger::log(1, "%s error: could not create query pool (error: %i)\n",
+                __FUNCTION__, result);
     return false;
   }
   return true;
 }
 
 bool VkRenderer::createSyncObjects() {
-  if (!SyncObjects::init(&mRenderData)) {
+  if (!SyncObjects::init(&mRenderData, kMaxFramesInFlight)) {
     Logger::log(1, "%s error: could not create sync objects\n", __FUNCTION__);
     return false;
   }
@@ -2135,12 +3356,21 @@ bool VkRenderer::recreateSwapchain() {
   mRenderData.rdVkbSwapchain.destroy_image_views(
       mRenderData.rdSwapchainImageViews);
 
+  /* the number of swapchain images may change */
+  SyncObjects::cleanupSwapchainSemaphores(&mRenderData);
+
   /* and recreate */
   if (!createSwapchain()) {
     Logger::log(1, "%s error: could not recreate swapchain\n", __FUNCTION__);
     return false;
   }
 
+  if (!SyncObjects::initSwapchainSemaphores(&mRenderData)) {
+    Logger::log(1, "%s error: could not recreate swapchain semaphores\n",
+                __FUNCTION__);
+    return false;
+  }
+
   if (!createDepthBuffer()) {
     Logger::log(1, "%s error: could not recreate depth buffer\n", __FUNCTION__);
     return false;
@@ -2183,12 +3413,12 @@ void VkRenderer::updateComputeDescriptorSets() {
     VkDescriptorBufferInfo transformInfo{};
     transformInfo.buffer = mShaderNodeTransformBuffer.buffer;
     transformInfo.offset = 0;
-    transformInfo.range = VK_WHOLE_SIZE;
+    transformInfo.range = mShaderNodeTransformBuffer.frameSize;
 
     VkWriteDescriptorSet transformWriteDescriptorSet{};
     transformWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     transformWriteDescriptorSet.descriptorType =
-        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     transformWriteDescriptorSet.dstSet =
         mRenderData.rdAssimpComputeTransformDescriptorSet;
     transformWriteDescriptorSet.dstBinding = 0;
@@ -2258,11 +3488,240 @@ void VkRenderer::updateComputeDescriptorSets() {
         static_cast<uint32_t>(matrixMultWriteDescriptorSets.size()),
         matrixMultWriteDescriptorSets.data(), 0, nullptr);
   }
+
+  {
+    /* fused transform and matrix multiplication compute shader */
+    VkDescriptorBufferInfo transformInfo{};
+    transformInfo.buffer = mShaderNodeTransformBuffer.buffer;
+    transformInfo.offset = 0;
+    transformInfo.range = mShaderNodeTransformBuffer.frameSize;
+
+    VkWriteDescriptorSet transformWriteDescriptorSet{};
+    transformWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    transformWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    transformWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeFusedDescriptorSet;
+    transformWriteDescriptorSet.dstBinding = 0;
+    transformWriteDescriptorSet.descriptorCount = 1;
+    transformWriteDescriptorSet.pBufferInfo = &transformInfo;
+
+    VkDescriptorBufferInfo boneMatrixInfo{};
+    boneMatrixInfo.buffer = mShaderBoneMatrixBuffer.buffer;
+    boneMatrixInfo.offset = 0;
+    boneMatrixInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet boneMatrixWriteDescriptorSet{};
+    boneMatrixWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    boneMatrixWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    boneMatrixWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeFusedDescriptorSet;
+    boneMatrixWriteDescriptorSet.dstBinding = 1;
+    boneMatrixWriteDescriptorSet.descriptorCount = 1;
+    boneMatrixWriteDescriptorSet.pBufferInfo = &boneMatrixInfo;
+
+    std::vector<VkWriteDescriptorSet> fusedWriteDescriptorSets = {
+        transformWriteDescriptorSet, boneMatrixWriteDescriptorSet};
+
+    vkUpdateDescriptorSets(
+        mRenderData.rdVkbDevice.device,
+        static_cast<uint32_t>(fusedWriteDescriptorSets.size()),
+        fusedWriteDescriptorSets.data(), 0, nullptr);
+  }
+
+  {
+    /* keyframe sampling compute shader */
+    VkDescriptorBufferInfo animInstanceInfo{};
+    animInstanceInfo.buffer = mAnimInstanceBuffer.buffer;
+    animInstanceInfo.offset = 0;
+    animInstanceInfo.range = mAnimInstanceBuffer.frameSize;
+
+    VkWriteDescriptorSet animInstanceWriteDescriptorSet{};
+    animInstanceWriteDescriptorSet.sType =
+        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    animInstanceWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    animInstanceWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeAnimSampleDescriptorSet;
+    animInstanceWriteDescriptorSet.dstBinding = 0;
+    animInstanceWriteDescriptorSet.descriptorCount = 1;
+    animInstanceWriteDescriptorSet.pBufferInfo = &animInstanceInfo;
+
+    VkDescriptorBufferInfo gpuPoseInfo{};
+    gpuPoseInfo.buffer = mShaderGpuPoseBuffer.buffer;
+    gpuPoseInfo.offset = 0;
+    gpuPoseInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet gpuPoseWriteDescriptorSet{};
+    gpuPoseWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    gpuPoseWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    gpuPoseWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeAnimSampleDescriptorSet;
+    gpuPoseWriteDescriptorSet.dstBinding = 1;
+    gpuPoseWriteDescriptorSet.descriptorCount = 1;
+    gpuPoseWriteDescriptorSet.pBufferInfo = &gpuPoseInfo;
+
+    std::vector<VkWriteDescriptorSet> animSampleWriteDescriptorSets = {
+        animInstanceWriteDescriptorSet, gpuPoseWriteDescriptorSet};
+
+    vkUpdateDescriptorSets(
+        mRenderData.rdVkbDevice.device,
+        static_cast<uint32_t>(animSampleWriteDescriptorSets.size()),
+        animSampleWriteDescriptorSets.data(), 0, nullptr);
+  }
+
+  {
+    /* transform and fused compute shader reading the GPU poses, the binding
+     * is dynamic in the layout, but always used with offset zero */
+    VkDescriptorBufferInfo gpuPoseInfo{};
+    gpuPoseInfo.buffer = mShaderGpuPoseBuffer.buffer;
+    gpuPoseInfo.offset = 0;
+    gpuPoseInfo.range = mShaderGpuPoseBuffer.size;
+
+    VkWriteDescriptorSet transformWriteDescriptorSet{};
+    transformWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    transformWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    transformWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeTransformGpuPoseDescriptorSet;
+    transformWriteDescriptorSet.dstBinding = 0;
+    transformWriteDescriptorSet.descriptorCount = 1;
+    transformWriteDescriptorSet.pBufferInfo = &gpuPoseInfo;
+
+    VkDescriptorBufferInfo trsInfo{};
+    trsInfo.buffer = mShaderTRSMatrixBuffer.buffer;
+    trsInfo.offset = 0;
+    trsInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet trsWriteDescriptorSet{};
+    trsWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    trsWriteDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    trsWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeTransformGpuPoseDescriptorSet;
+    trsWriteDescriptorSet.dstBinding = 1;
+    trsWriteDescriptorSet.descriptorCount = 1;
+    trsWriteDescriptorSet.pBufferInfo = &trsInfo;
+
+    VkWriteDescriptorSet fusedTransformWriteDescriptorSet =
+        transformWriteDescriptorSet;
+    fusedTransformWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeFusedGpuPoseDescriptorSet;
+
+    VkDescriptorBufferInfo boneMatrixInfo{};
+    boneMatrixInfo.buffer = mShaderBoneMatrixBuffer.buffer;
+    boneMatrixInfo.offset = 0;
+    boneMatrixInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet boneMatrixWriteDescriptorSet{};
+    boneMatrixWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    boneMatrixWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    boneMatrixWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeFusedGpuPoseDescriptorSet;
+    boneMatrixWriteDescriptorSet.dstBinding = 1;
+    boneMatrixWriteDescriptorSet.descriptorCount = 1;
+    boneMatrixWriteDescriptorSet.pBufferInfo = &boneMatrixInfo;
+
+    std::vector<VkWriteDescriptorSet> gpuPoseWriteDescriptorSets = {
+        transformWriteDescriptorSet, trsWriteDescriptorSet,
+        fusedTransformWriteDescriptorSet, boneMatrixWriteDescriptorSet};
+
+    vkUpdateDescriptorSets(
+        mRenderData.rdVkbDevice.device,
+        static_cast<uint32_t>(gpuPoseWriteDescriptorSets.size()),
+        gpuPoseWriteDescriptorSets.data(), 0, nullptr);
+  }
+
+  {
+    /* frustum culling compute shader */
+    VkDescriptorBufferInfo worldPosInfo{};
+    worldPosInfo.buffer = mShaderModelRootMatrixBuffer.buffer;
+    worldPosInfo.offset = 0;
+    worldPosInfo.range = mShaderModelRootMatrixBuffer.frameSize;
+
+    VkWriteDescriptorSet worldPosWriteDescriptorSet{};
+    worldPosWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    worldPosWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    worldPosWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeCullDescriptorSet;
+    worldPosWriteDescriptorSet.dstBinding = 0;
+    worldPosWriteDescriptorSet.descriptorCount = 1;
+    worldPosWriteDescriptorSet.pBufferInfo = &worldPosInfo;
+
+    VkDescriptorBufferInfo cullDataInfo{};
+    cullDataInfo.buffer = mCullInstanceBuffer.buffer;
+    cullDataInfo.offset = 0;
+    cullDataInfo.range = mCullInstanceBuffer.frameSize;
+
+    VkWriteDescriptorSet cullDataWriteDescriptorSet{};
+    cullDataWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    cullDataWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    cullDataWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeCullDescriptorSet;
+    cullDataWriteDescriptorSet.dstBinding = 1;
+    cullDataWriteDescriptorSet.descriptorCount = 1;
+    cullDataWriteDescriptorSet.pBufferInfo = &cullDataInfo;
+
+    VkDescriptorBufferInfo commandInfo{};
+    commandInfo.buffer = mDrawCommandBuffer.buffer;
+    commandInfo.offset = 0;
+    commandInfo.range = mDrawCommandBuffer.frameSize;
+
+    VkWriteDescriptorSet commandWriteDescriptorSet{};
+    commandWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    commandWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    commandWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeCullDescriptorSet;
+    commandWriteDescriptorSet.dstBinding = 2;
+    commandWriteDescriptorSet.descriptorCount = 1;
+    commandWriteDescriptorSet.pBufferInfo = &commandInfo;
+
+    VkDescriptorBufferInfo visibleInfo{};
+    visibleInfo.buffer = mVisibleInstanceBuffer.buffer;
+    visibleInfo.offset = 0;
+    visibleInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet visibleWriteDescriptorSet{};
+    visibleWriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    visibleWriteDescriptorSet.descriptorType =
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    visibleWriteDescriptorSet.dstSet =
+        mRenderData.rdAssimpComputeCullDescriptorSet;
+    visibleWriteDescriptorSet.dstBinding = 3;
+    visibleWriteDescriptorSet.descriptorCount = 1;
+    visibleWriteDescriptorSet.pBufferInfo = &visibleInfo;
+
+    std::vector<VkWriteDescriptorSet> cullWriteDescriptorSets = {
+        worldPosWriteDescriptorSet, cullDataWriteDescriptorSet,
+        commandWriteDescriptorSet, visibleWriteDescriptorSet};
+
+    vkUpdateDescriptorSets(
+        mRenderData.rdVkbDevice.device,
+        static_cast<uint32_t>(cullWriteDescriptorSets.size()),
+        cullWriteDescriptorSets.data(), 0, nullptr);
+  }
 }
 
 void VkRenderer::runComputeShaders(std::shared_ptr<AssimpModel> model,
-                                   int numInstances, uint32_t modelOffset) {
+                                   int numInstances, uint32_t modelOffset,
+                                   uint32_t paletteOffset) {
   uint32_t numBones = static_cast<uint32_t>(model->getBoneList().size());
+  mComputeModelData.pkBoneCount = numBones;
+  mComputeModelData.pkPaletteOffset = paletteOffset;
+  mComputeModelData.pkDualQuatPalette = model->getDualQuatSkinning() ? 1 : 0;
+
+  /* poses sampled on the GPU are read from their own buffer */
+  VkDescriptorSet transformSet =
+      mRenderData.rdUseGpuAnimSampling
+          ? mRenderData.rdAssimpComputeTransformGpuPoseDescriptorSet
+          : mRenderData.rdAssimpComputeTransformDescriptorSet;
+  uint32_t transformOffset =
+      mRenderData.rdUseGpuAnimSampling ? 0 : mNodeTransformDynamicOffset;
 
   /* node transformation */
   vkCmdBindPipeline(mRenderData.rdComputeCommandBuffer,
@@ -2270,8 +3729,8 @@ void VkRenderer::runComputeShaders(std::shared_ptr<AssimpModel> model,
                     mRenderData.rdAssimpComputeTransformPipeline);
   vkCmdBindDescriptorSets(
       mRenderData.rdComputeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-      mRenderData.rdAssimpComputeTransformaPipelineLayout, 0, 1,
-      &mRenderData.rdAssimpComputeTransformDescriptorSet, 0, 0);
+      mRenderData.rdAssimpComputeTransformaPipelineLayout, 0, 1, &transformSet,
+      1, &transformOffset);
 
   mUploadToUBOTimer.start();
   mComputeModelData.pkModelOffset = modelOffset;
@@ -2344,3 +3803,456 @@ void VkRenderer::runComputeShaders(std::shared_ptr<AssimpModel> model,
                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1,
                        &boneMatrixBufferBarrier, 0, nullptr);
 }
+
+void VkRenderer::runFusedComputeShader(std::shared_ptr<AssimpModel> model,
+                                       int numInstances, uint32_t modelOffset,
+                                       uint32_t paletteOffset) {
+  uint32_t numBones = static_cast<uint32_t>(model->getBoneList().size());
+
+  /* node transformation and matrix multiplication, one work group per
+   * instance */
+  vkCmdBindPipeline(mRenderData.rdComputeCommandBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    mRenderData.rdAssimpComputeFusedPipeline);
+
+  /* poses sampled on the GPU are read from their own buffer */
+  VkDescriptorSet fusedSet =
+      mRenderData.rdUseGpuAnimSampling
+          ? mRenderData.rdAssimpComputeFusedGpuPoseDescriptorSet
+          : mRenderData.rdAssimpComputeFusedDescriptorSet;
+  uint32_t transformOffset =
+      mRenderData.rdUseGpuAnimSampling ? 0 : mNodeTransformDynamicOffset;
+
+  VkDescriptorSet modelDescriptorSet = model->getMatrixMultDescriptorSet();
+  std::vector<VkDescriptorSet> computeSets = {fusedSet, modelDescriptorSet};
+  vkCmdBindDescriptorSets(
+      mRenderData.rdComputeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      mRenderData.rdAssimpComputeFusedPipelineLayout, 0,
+      static_cast<uint32_t>(computeSets.size()), computeSets.data(), 1,
+      &transformOffset);
+
+  mUploadToUBOTimer.start();
+  mComputeModelData.pkModelOffset = modelOffset;
+  mComputeModelData.pkBoneCount = numBones;
+  mComputeModelData.pkPaletteOffset = paletteOffset;
+  mComputeModelData.pkDualQuatPalette = model->getDualQuatSkinning() ? 1 : 0;
+  vkCmdPushConstants(mRenderData.rdComputeCommandBuffer,
+                     mRenderData.rdAssimpComputeFusedPipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                     static_cast<uint32_t>(sizeof(VkComputePushConstants)),
+                     &mComputeModelData);
+  mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+  vkCmdDispatch(mRenderData.rdComputeCommandBuffer,
+                static_cast<uint32_t>(numInstances), 1, 1);
+
+  /* wait for bone matrix buffer to be written */
+  VkBufferMemoryBarrier boneMatrixBufferBarrier{};
+  boneMatrixBufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  boneMatrixBufferBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  boneMatrixBufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  boneMatrixBufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  boneMatrixBufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  boneMatrixBufferBarrier.buffer = mShaderBoneMatrixBuffer.buffer;
+  boneMatrixBufferBarrier.offset = 0;
+  boneMatrixBufferBarrier.size = VK_WHOLE_SIZE;
+
+  vkCmdPipelineBarrier(mRenderData.rdComputeCommandBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1,
+                       &boneMatrixBufferBarrier, 0, nullptr);
+}
+
+void VkRenderer::runAnimSamplingShader(std::shared_ptr<AssimpModel> model,
+                                       int numInstances, uint32_t modelOffset,
+                                       uint32_t instanceOffset) {
+  uint32_t numBones = static_cast<uint32_t>(model->getBoneList().size());
+
+  /* keyframe search and interpolation, one invocation per bone */
+  vkCmdBindPipeline(mRenderData.rdComputeCommandBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    mRenderData.rdAssimpComputeAnimSamplePipeline);
+
+  VkDescriptorSet modelDescriptorSet = model->getMatrixMultDescriptorSet();
+  std::vector<VkDescriptorSet> computeSets = {
+      mRenderData.rdAssimpComputeAnimSampleDescriptorSet, modelDescriptorSet};
+  vkCmdBindDescriptorSets(
+      mRenderData.rdComputeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      mRenderData.rdAssimpComputeAnimSamplePipelineLayout, 0,
+      static_cast<uint32_t>(computeSets.size()), computeSets.data(), 1,
+      &mAnimInstanceDynamicOffset);
+
+  VkAnimSamplingPushConstants samplingData{};
+  samplingData.pkModelOffset = modelOffset;
+  samplingData.pkBoneCount = numBones;
+  samplingData.pkInstanceOffset = instanceOffset;
+  samplingData.pkInstanceCount = static_cast<uint32_t>(numInstances);
+  vkCmdPushConstants(mRenderData.rdComputeCommandBuffer,
+                     mRenderData.rdAssimpComputeAnimSamplePipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                     static_cast<uint32_t>(sizeof(VkAnimSamplingPushConstants)),
+                     &samplingData);
+
+  vkCmdDispatch(mRenderData.rdComputeCommandBuffer,
+                (numBones * numInstances + 63) / 64, 1, 1);
+
+  /* wait for the poses to be written */
+  VkBufferMemoryBarrier gpuPoseBufferBarrier{};
+  gpuPoseBufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  gpuPoseBufferBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  gpuPoseBufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  gpuPoseBufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  gpuPoseBufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  gpuPoseBufferBarrier.buffer = mShaderGpuPoseBuffer.buffer;
+  gpuPoseBufferBarrier.offset = 0;
+  gpuPoseBufferBarrier.size = VK_WHOLE_SIZE;
+
+  vkCmdPipelineBarrier(mRenderData.rdComputeCommandBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1,
+                       &gpuPoseBufferBarrier, 0, nullptr);
+}
+
+uint32_t VkRenderer::getBonePaletteSize(std::shared_ptr<AssimpModel> model,
+                                        size_t numInstances) {
+  size_t paletteSize = model->getBoneList().size() * numInstances *
+                       (model->getDualQuatSkinning() ? 2 : 4);
+  /* the next model may need mat4 alignment */
+  return static_cast<uint32_t>((paletteSize + 3) / 4 * 4);
+}
+
+bool VkRenderer::usesBakedAnimations(std::shared_ptr<AssimpModel> model) {
+  if (!mRenderData.rdUseBakedAnimations) {
+    return false;
+  }
+  if (!model->hasBakedAnimations()) {
+    model->bakeAnimations(mRenderData);
+  }
+  return model->hasBakedAnimations();
+}
+
+drawPipeline VkRenderer::getDrawPipeline(std::shared_ptr<AssimpModel> model) {
+  /* the packed variant directly follows its full vertex pipeline */
+  uint8_t packedOffset = model->usesPackedVertices() ? 1 : 0;
+  if (!model->hasAnimations() || model->getBoneList().empty()) {
+    return static_cast<drawPipeline>(
+        static_cast<uint8_t>(drawPipeline::assimp) + packedOffset);
+  }
+  if (usesBakedAnimations(model)) {
+    return static_cast<drawPipeline>(
+        static_cast<uint8_t>(drawPipeline::skinningBaked) + packedOffset);
+  }
+  if (model->getDualQuatSkinning()) {
+    return static_cast<drawPipeline>(
+        static_cast<uint8_t>(drawPipeline::skinningDualQuat) + packedOffset);
+  }
+  return static_cast<drawPipeline>(
+      static_cast<uint8_t>(drawPipeline::skinning) + packedOffset);
+}
+
+VkPipeline VkRenderer::getDrawPipelineHandle(drawPipeline pipelineType) {
+  switch (pipelineType) {
+    case drawPipeline::assimp:
+      return mRenderData.rdAssimpPipeline;
+    case drawPipeline::assimpPacked:
+      return mRenderData.rdAssimpPackedPipeline;
+    case drawPipeline::skinning:
+      return mRenderData.rdAssimpSkinningPipeline;
+    case drawPipeline::skinningPacked:
+      return mRenderData.rdAssimpSkinningPackedPipeline;
+    case drawPipeline::skinningDualQuat:
+      return mRenderData.rdAssimpSkinningDualQuatPipeline;
+    case drawPipeline::skinningDualQuatPacked:
+      return mRenderData.rdAssimpSkinningDualQuatPackedPipeline;
+    case drawPipeline::skinningBaked:
+      return mRenderData.rdAssimpSkinningBakedPipeline;
+    case drawPipeline::skinningBakedPacked:
+      return mRenderData.rdAssimpSkinningBakedPackedPipeline;
+    default:
+      return VK_NULL_HANDLE;
+  }
+}
+
+VkPipelineLayout VkRenderer::getDrawPipelineLayout(drawPipeline pipelineType) {
+  switch (pipelineType) {
+    case drawPipeline::assimp:
+    case drawPipeline::assimpPacked:
+      return mRenderData.rdAssimpPipelineLayout;
+    case drawPipeline::skinningBaked:
+    case drawPipeline::skinningBakedPacked:
+      return mRenderData.rdAssimpSkinningBakedPipelineLayout;
+    default:
+      /* all other skinning pipelines share the layout */
+      return mRenderData.rdAssimpSkinningPipelineLayout;
+  }
+}
+
+size_t VkRenderer::recordModelDraws(VkCommandBuffer commandBuffer,
+                                    uint32_t beginCommand,
+                                    uint32_t endCommand) {
+  /* secondary command buffers inherit no state from the primary one */
+  /* Flip viewport to be compatible with OpenGL */
+  VkViewport viewport{};
+  viewport.x = 0.0f;
+  viewport.y = static_cast<float>(mRenderData.rdVkbSwapchain.extent.height);
+  viewport.width = static_cast<float>(mRenderData.rdVkbSwapchain.extent.width);
+  viewport.height =
+      -static_cast<float>(mRenderData.rdVkbSwapchain.extent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+
+  VkRect2D scissor{};
+  scissor.offset = {0, 0};
+  scissor.extent = mRenderData.rdVkbSwapchain.extent;
+
+  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+  vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+  /* same binding order in both sets: matrices, world positions, selection */
+  std::vector<uint32_t> dynamicOffsets = {
+      mMatrixDynamicOffset, mWorldPosDynamicOffset, mSelectionDynamicOffset,
+      mDrawDataDynamicOffset};
+  /* the skinning set adds the baked instance data */
+  std::vector<uint32_t> skinningDynamicOffsets = {
+      mMatrixDynamicOffset, mWorldPosDynamicOffset, mSelectionDynamicOffset,
+      mBakedInstanceDynamicOffset, mDrawDataDynamicOffset};
+  /* the draw commands follow the header in the current slice */
+  VkDeviceSize drawCommandOffset =
+      mDrawCommandDynamicOffset + sizeof(VkIndirectDrawHeader);
+  /* without the feature gl_DrawID is always zero, every command gets its
+   * own call and draw data offset */
+  bool multiDrawIndirect = mRenderData.rdUseMultiDrawIndirect &&
+                           mRenderData.rdMultiDrawIndirectSupported;
+
+  TextureTable::bind(mRenderData, commandBuffer,
+                     mRenderData.rdAssimpPipelineLayout);
+
+  /* one multi draw per pipeline and draw batch inside the range */
+  size_t drawCallCount = 0;
+  VkPushConstants pushConstants{};
+  for (size_t i = 0; i < kNumDrawPipelines; ++i) {
+    drawPipeline pipelineType = static_cast<drawPipeline>(i);
+    VkPipelineLayout pipelineLayout = getDrawPipelineLayout(pipelineType);
+    bool pipelineBound = false;
+    VkDescriptorSet boundModelSet = VK_NULL_HANDLE;
+
+    for (const auto& batch : mDrawBatches.at(i)) {
+      uint32_t firstCommand = std::max(batch.firstCommand, beginCommand);
+      uint32_t lastCommand =
+          std::min(batch.firstCommand + batch.commandCount, endCommand);
+      if (firstCommand >= lastCommand) {
+        continue;
+      }
+
+      if (!pipelineBound) {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          getDrawPipelineHandle(pipelineType));
+
+        if (pipelineType == drawPipeline::assimp ||
+            pipelineType == drawPipeline::assimpPacked) {
+          vkCmdBindDescriptorSets(
+              commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+              1, 1, &mRenderData.rdAssimpDescriptorSet,
+              static_cast<uint32_t>(dynamicOffsets.size()),
+              dynamicOffsets.data());
+        } else {
+          vkCmdBindDescriptorSets(
+              commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+              1, 1, &mRenderData.rdAssimpSkinningDescriptorSet,
+              static_cast<uint32_t>(skinningDynamicOffsets.size()),
+              skinningDynamicOffsets.data());
+        }
+
+        /* the packed vertex pipelines have odd numbers */
+        GeometryArena::bindBuffers(mRenderData, commandBuffer, i % 2 == 1);
+        pipelineBound = true;
+      }
+
+      if (batch.modelSet != boundModelSet) {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                pipelineLayout, 2, 1, &batch.modelSet, 0,
+                                nullptr);
+        boundModelSet = batch.modelSet;
+      }
+
+      uint32_t drawCount = multiDrawIndirect ? lastCommand - firstCommand : 1;
+      for (uint32_t command = firstCommand; command < lastCommand;
+           command += drawCount) {
+        pushConstants.pkDrawDataOffset = command;
+        vkCmdPushConstants(commandBuffer, pipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT, 0,
+                           static_cast<uint32_t>(sizeof(VkPushConstants)),
+                           &pushConstants);
+        vkCmdDrawIndexedIndirect(
+            commandBuffer, mDrawCommandBuffer.buffer,
+            drawCommandOffset + command * sizeof(VkDrawIndexedIndirectCommand),
+            drawCount, sizeof(VkDrawIndexedIndirectCommand));
+        ++drawCallCount;
+      }
+    }
+  }
+  return drawCallCount;
+}
+
+void VkRenderer::updateMatrices() {
+  mMatrices.proj = glm::perspective(
+      glm::radians(static_cast<float>(mRenderData.rdFOV)),
+      static_cast<float>(mRenderData.rdVkbSwapchain.extent.width) /
+          static_cast<float>(mRenderData.rdVkbSwapchain.extent.height),
+      0.1f, 500.0f);
+  mMatrices.view = mCamera->getViewMatrix();
+
+  FrustumCuller::extractPlanes(mMatrices.proj * mMatrices.view,
+                               mCullData.pkFrustumPlanes);
+}
+
+void VkRenderer::cullInstances() {
+  size_t numInstances = 0;
+  for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
+    numInstances += instances.size();
+  }
+  mCullCenterX.resize(numInstances);
+  mCullCenterY.resize(numInstances);
+  mCullCenterZ.resize(numInstances);
+  mCullRadius.resize(numInstances);
+  mCullVisible.resize(numInstances);
+
+  size_t index = 0;
+  for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
+    for (const auto& instance : instances) {
+      glm::vec4 sphere = instance->getWorldBoundingSphere();
+      mCullCenterX.at(index) = sphere.x;
+      mCullCenterY.at(index) = sphere.y;
+      mCullCenterZ.at(index) = sphere.z;
+      mCullRadius.at(index) = sphere.w;
+      ++index;
+    }
+  }
+
+  size_t visibleInstances = FrustumCuller::cullSpheres(
+      mCullData.pkFrustumPlanes, mCullCenterX.data(), mCullCenterY.data(),
+      mCullCenterZ.data(), mCullRadius.data(), mCullVisible.data(),
+      numInstances);
+
+  /* keep the vectors of the models to avoid allocations every frame */
+  for (auto& [_, instances] : mVisibleInstancesPerModel) {
+    instances.clear();
+  }
+
+  index = 0;
+  for (const auto& [modelName, instances] :
+       mModelInstData.miAssimpInstancesPerModel) {
+    for (const auto& instance : instances) {
+      bool visible = mCullVisible.at(index) != 0;
+      instance->setVisible(visible);
+      if (visible) {
+        mVisibleInstancesPerModel[modelName].emplace_back(instance);
+      }
+      ++index;
+    }
+  }
+
+  /* the draw loops expect at least one instance per model */
+  std::erase_if(mVisibleInstancesPerModel,
+                [](const auto& entry) { return entry.second.empty(); });
+
+  mRenderData.rdVisibleInstances = visibleInstances;
+  mRenderData.rdCulledInstances = numInstances - visibleInstances;
+}
+
+void VkRenderer::updateAnimationLods() {
+  std::fill(std::begin(mRenderData.rdAnimLodInstances),
+            std::end(mRenderData.rdAnimLodInstances), 0);
+  ++mAnimLodFrame;
+
+  /* projected height in pixels is diameter * pixelScale / depth */
+  float pixelScale =
+      mMatrices.proj[1][1] * 0.5f *
+      static_cast<float>(mRenderData.rdVkbSwapchain.extent.height);
+
+  /* running counter as phase, spreads the instances of a level over the
+   * frames instead of updating all of them in the same frame */
+  unsigned int phase = 0;
+  for (const auto& [_, instances] : mModelInstData.miAssimpInstancesPerModel) {
+    if (instances.empty()) {
+      continue;
+    }
+    std::shared_ptr<AssimpModel> model = instances.front()->getModel();
+    if (!model->hasAnimations() || model->getBoneList().empty()) {
+      continue;
+    }
+
+    for (const auto& instance : instances) {
+      unsigned int lodLevel = 0;
+      if (mRenderData.rdEnableAnimLod) {
+        glm::vec4 sphere = instance->getWorldBoundingSphere();
+        float depth = -(mMatrices.view * glm::vec4(glm::vec3(sphere), 1.0f)).z;
+
+        /* the camera is inside or very close to the instance */
+        if (depth > sphere.w) {
+          float screenSize = 2.0f * sphere.w * pixelScale / depth;
+          while (lodLevel < kAnimLodLevels - 1 &&
+                 screenSize < mRenderData.rdAnimLodScreenSizes[lodLevel]) {
+            ++lodLevel;
+          }
+        }
+      }
+
+      unsigned int updateRate = 1u << lodLevel;
+      instance->setPoseUpdateDue((mAnimLodFrame + phase) % updateRate == 0);
+      ++phase;
+
+      if (instance->isVisible()) {
+        ++mRenderData.rdAnimLodInstances[lodLevel];
+      }
+    }
+  }
+}
+
+void VkRenderer::runCullingShader(uint32_t instanceCount) {
+  vkCmdBindPipeline(mRenderData.rdComputeCommandBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    mRenderData.rdAssimpComputeCullPipeline);
+
+  std::vector<uint32_t> cullDynamicOffsets = {mWorldPosDynamicOffset,
+                                              mCullInstanceDynamicOffset,
+                                              mDrawCommandDynamicOffset};
+  vkCmdBindDescriptorSets(
+      mRenderData.rdComputeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      mRenderData.rdAssimpComputeCullPipelineLayout, 0, 1,
+      &mRenderData.rdAssimpComputeCullDescriptorSet,
+      static_cast<uint32_t>(cullDynamicOffsets.size()),
+      cullDynamicOffsets.data());
+
+  mUploadToUBOTimer.start();
+  mCullData.pkInstanceCount = instanceCount;
+  mCullData.pkCullingEnabled =
+      mRenderData.rdCullingMode == cullingMode::gpu ? 1 : 0;
+  vkCmdPushConstants(mRenderData.rdComputeCommandBuffer,
+                     mRenderData.rdAssimpComputeCullPipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                     static_cast<uint32_t>(sizeof(VkCullPushConstants)),
+                     &mCullData);
+  mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+  vkCmdDispatch(mRenderData.rdComputeCommandBuffer,
+                static_cast<uint32_t>(std::ceil(instanceCount / 64.0f)), 1, 1);
+
+  /* the instance counts are used as indirect draw parameters and the
+   * statistics are read by the CPU after the fence */
+  VkBufferMemoryBarrier drawCommandBarrier{};
+  drawCommandBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  drawCommandBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  drawCommandBarrier.dstAccessMask =
+      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+  drawCommandBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  drawCommandBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  drawCommandBarrier.buffer = mDrawCommandBuffer.buffer;
+  drawCommandBarrier.offset = mDrawCommandDynamicOffset;
+  drawCommandBarrier.size = mDrawCommandBuffer.frameSize;
+
+  vkCmdPipelineBarrier(
+      mRenderData.rdComputeCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0,
+      nullptr, 1, &drawCommandBarrier, 0, nullptr);
+}
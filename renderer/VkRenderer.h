@@ -6,17 +6,21 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <array>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Camera.h"
+#include "FrameRingBuffer.h"
+#include "JobSystem.h"
 #include "ModelAndInstanceData.h"
+#include "ModelLoader.h"
 #include "ShaderStorageBuffer.h"
 #include "Texture.h"
 #include "Timer.h"
-#include "UniformBuffer.h"
 #include "UserInterface.h"
 #include "VertexBuffer.h"
 #include "VkRenderData.h"
@@ -31,6 +35,7 @@ class VkRenderer {
 	Timer mUploadToUBOTimer{};
 	Timer mUIGenerateTimer{};
 	Timer mUIDrawTimer{};
+	Timer mRecordTimer{};
 
 	std::shared_ptr<Camera> mCamera{nullptr};
 
@@ -77,17 +82,16 @@ class VkRenderer {
 	bool bHideMouse{};
 	UserInterface mUserInterface{};
 
-	VkPushConstants mModelData{};
 	VkComputePushConstants mComputeModelData{};
-	VkUniformBufferData mPerspectiveViewMatrixUBO{};
+	VkFrameRingBufferData mPerspectiveViewMatrixUBO{};
 
 	/* color hightlight for selection etc */
 	std::vector<glm::vec2> mSelectedInstance{};
-	VkShaderStorageBufferData mSelectedInstanceBuffer{};
+	VkFrameRingBufferData mSelectedInstanceBuffer{};
 
 	/* for animated and non-animated models */
 	std::vector<glm::mat4> mWorldPosMatrices{};
-	VkShaderStorageBufferData mShaderModelRootMatrixBuffer{};
+	VkFrameRingBufferData mShaderModelRootMatrixBuffer{};
 
 	/* for animated models */
 	VkShaderStorageBufferData mShaderBoneMatrixBuffer{};
@@ -96,7 +100,108 @@ class VkRenderer {
 	bool mHasDedicatedComputeQueue = false;
 	std::vector<NodeTransformData> mNodeTransformData{};
 	VkShaderStorageBufferData mShaderTRSMatrixBuffer{};
-	VkShaderStorageBufferData mShaderNodeTransformBuffer{};
+	VkFrameRingBufferData mShaderNodeTransformBuffer{};
+
+	/* data rewritten every frame lives in per-frame slices, the offsets of
+	 * the current slices are passed when binding the descriptor sets */
+	static constexpr uint32_t kMaxFramesInFlight = 2;
+	uint32_t mMatrixDynamicOffset = 0;
+	uint32_t mWorldPosDynamicOffset = 0;
+	uint32_t mSelectionDynamicOffset = 0;
+	uint32_t mNodeTransformDynamicOffset = 0;
+
+	/* keyframe sampling on the GPU, the clips stay in the model buffers and
+	 * only clip and play time are uploaded per instance */
+	std::vector<VkAnimInstanceData> mAnimInstanceData{};
+	VkFrameRingBufferData mAnimInstanceBuffer{};
+	VkShaderStorageBufferData mShaderGpuPoseBuffer{};
+	uint32_t mAnimInstanceDynamicOffset = 0;
+
+	/* baked animations, two frames and the blend factor per instance */
+	std::vector<VkBakedInstanceData> mBakedInstanceData{};
+	VkFrameRingBufferData mBakedInstanceBuffer{};
+	uint32_t mBakedInstanceDynamicOffset = 0;
+
+	/* frustum culling on the GPU, the culling shader fills the instance
+	 * counts of the indirect draws and the list of visible instances */
+	std::vector<VkCullInstanceData> mCullInstanceData{};
+	VkFrameRingBufferData mCullInstanceBuffer{};
+	std::vector<VkDrawIndexedIndirectCommand> mDrawCommands{};
+	VkFrameRingBufferData mDrawCommandBuffer{};
+	VkShaderStorageBufferData mVisibleInstanceBuffer{};
+	VkCullPushConstants mCullData{};
+	uint32_t mCullInstanceDynamicOffset = 0;
+	uint32_t mDrawCommandDynamicOffset = 0;
+	/* number of instances tested in each frame slot, for the statistics */
+	std::vector<size_t> mCullFrameInstanceCounts{};
+
+	/* the draw commands are grouped by pipeline, every command has its draw
+	 * data at the same index */
+	static constexpr size_t kNumDrawPipelines =
+			static_cast<size_t>(drawPipeline::NUM);
+	std::vector<VkDrawData> mDrawData{};
+	VkFrameRingBufferData mDrawDataBuffer{};
+	uint32_t mDrawDataDynamicOffset = 0;
+	std::array<std::vector<VkDrawBatch>, kNumDrawPipelines> mDrawBatches{};
+
+	/* the draw commands are split into one range per record job, every job
+	 * records its range into an own secondary command buffer */
+	static constexpr size_t kModelsPerRecordJob = 16;
+	std::vector<VkCommandBuffer> mRecordCommandBuffers{};
+	std::vector<size_t> mRecordDrawCallCounts{};
+
+	/* frustum culling on the CPU, bounding spheres in world space as streams
+	 * for the SIMD test, only the visible instances are animated and drawn */
+	std::vector<float> mCullCenterX{};
+	std::vector<float> mCullCenterY{};
+	std::vector<float> mCullCenterZ{};
+	std::vector<float> mCullRadius{};
+	std::vector<uint8_t> mCullVisible{};
+	std::unordered_map<std::string, std::vector<std::shared_ptr<AssimpInstance>>>
+			mVisibleInstancesPerModel{};
+
+	/* animation LOD, update rate is halved per level */
+	static constexpr unsigned int kAnimLodLevels = 4;
+	uint32_t mAnimLodFrame = 0;
+
+	/* mouse picking results are read back when the frame slot is reused */
+	std::vector<VkSelectionReadbackData> mSelectionReadbacks{};
+
+	/* the fused skinning shader keeps all bones of an instance in shared
+	 * memory, models with more bones use the two pass version */
+	static constexpr uint32_t kMaxFusedSkinningBones = 256;
+
+	/* GPU time of the skinning dispatches, one query pair per frame slot */
+	VkQueryPool mTimestampQueryPool = VK_NULL_HANDLE;
+	float mTimestampPeriod = 0.0f;
+	std::vector<bool> mTimestampsPending{};
+
+	/* parallel animation update, instances are split into fixed ranges */
+	struct AnimationUpdateRange {
+		const std::vector<std::shared_ptr<AssimpInstance>>* instances = nullptr;
+		size_t begin = 0;
+		size_t end = 0;
+		/* only the play time is advanced, the poses are baked */
+		bool bakedAnimations = false;
+	};
+	static constexpr size_t kAnimationUpdateChunkSize = 128;
+
+	JobSystem mJobSystem{};
+	std::vector<AnimationUpdateRange> mAnimationUpdateRanges{};
+
+	/* models are imported in the background and uploaded between frames */
+	static constexpr unsigned int kModelLoaderThreads = 2;
+	ModelLoader mModelLoader{};
+
+	/* a box stands in for every queued model, the model instance takes over
+	 * the transform of the box. the box model is not in the model list */
+	static constexpr const char* kPlaceholderModelName = "placeholder box";
+	std::shared_ptr<AssimpModel> mPlaceholderModel = nullptr;
+	std::unordered_map<std::string, std::shared_ptr<AssimpInstance>>
+			mPlaceholderInstances{};
+
+	/* staging ring shared by all buffer and texture uploads */
+	static constexpr VkDeviceSize kUploadRingSize = 64 * 1024 * 1024;
 
 	/* Identity matrices */
 	VkUploadMatrices mMatrices{glm::mat4(1.0f), glm::mat4(1.0f)};
@@ -116,6 +221,7 @@ class VkRenderer {
 	bool updateDescriptorSets();
 	bool createDepthBuffer();
 	bool createSelectionImage();
+	bool createSelectionReadbacks();
 	bool createMatrixUBO();
 	bool createSSBOs();
 	bool createSwapchain();
@@ -126,16 +232,49 @@ class VkRenderer {
 	bool createCommandPool();
 	bool createCommandBuffer();
 	bool createSyncObjects();
+	bool createTimestampQueries();
 
 	bool initUserInterface();
 
 	bool recreateSwapchain();
 
+	void processLoadedModels();
+	/* returns the box of the model if it is still in the scene */
+	std::shared_ptr<AssimpInstance> removePlaceholder(
+			const std::string& modelFileName);
+	/* destroys the models of deleteModel() once the GPU is done with them */
+	void deletePendingModels();
+
 	void updateTriangleCount();
 
 	void assignInstanceIndices();
 
 	void updateComputeDescriptorSets();
 	void runComputeShaders(std::shared_ptr<AssimpModel> model, int numInstances,
-												 uint32_t modelOffset);
+												 uint32_t modelOffset, uint32_t paletteOffset);
+	void runFusedComputeShader(std::shared_ptr<AssimpModel> model,
+														 int numInstances, uint32_t modelOffset,
+														 uint32_t paletteOffset);
+	/* vec4 used by the bone palette of the instances of a model */
+	uint32_t getBonePaletteSize(std::shared_ptr<AssimpModel> model,
+															size_t numInstances);
+	void runAnimSamplingShader(std::shared_ptr<AssimpModel> model,
+														 int numInstances, uint32_t modelOffset,
+														 uint32_t instanceOffset);
+
+	/* bakes the clips on first use, false falls back to the compute path */
+	bool usesBakedAnimations(std::shared_ptr<AssimpModel> model);
+
+	drawPipeline getDrawPipeline(std::shared_ptr<AssimpModel> model);
+	VkPipeline getDrawPipelineHandle(drawPipeline pipelineType);
+	VkPipelineLayout getDrawPipelineLayout(drawPipeline pipelineType);
+	/* records the commands [beginCommand, endCommand) of the draw batches,
+	 * returns the number of draw calls. runs on the job system workers */
+	size_t recordModelDraws(VkCommandBuffer commandBuffer, uint32_t beginCommand,
+													uint32_t endCommand);
+
+	void updateMatrices();
+	void cullInstances();
+	void updateAnimationLods();
+	void runCullingShader(uint32_t instanceCount);
 };
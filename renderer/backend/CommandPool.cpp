@@ -5,12 +5,12 @@
 #include "Logger.h"
 
 bool CommandPool::init(const VkRenderData& renderData, vkb::QueueType queueType,
-                       VkCommandPool* pool) {
+                       VkCommandPool* pool, VkCommandPoolCreateFlags flags) {
   VkCommandPoolCreateInfo poolCreateInfo{};
   poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
   poolCreateInfo.queueFamilyIndex =
       renderData.rdVkbDevice.get_queue_index(queueType).value();
-  poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  poolCreateInfo.flags = flags;
 
   VkResult result = vkCreateCommandPool(renderData.rdVkbDevice.device,
                                         &poolCreateInfo, nullptr, pool);
@@ -7,6 +7,8 @@
 class CommandPool {
  public:
   static bool init(const VkRenderData& renderData, vkb::QueueType queueType,
-                   VkCommandPool* pool);
+                   VkCommandPool* pool,
+                   VkCommandPoolCreateFlags flags =
+                       VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
   static void cleanup(const VkRenderData& renderData, VkCommandPool pool);
 };
@@ -0,0 +1,144 @@
+#include "FrameRingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Logger.h"
+
+bool FrameRingBuffer::init(const VkRenderData& renderData,
+                           VkFrameRingBufferData* ringData,
+                           VkDeviceSize frameSize, uint32_t numFrames,
+                           VkDeviceSize alignment, VkBufferUsageFlags usage) {
+  /* every slice must start at a valid dynamic offset */
+  frameSize = (frameSize + alignment - 1) / alignment * alignment;
+
+  VkBufferCreateInfo bufferInfo{};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = frameSize * numFrames;
+  bufferInfo.usage = usage;
+
+  VmaAllocationCreateInfo vmaAllocInfo{};
+  vmaAllocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+  vmaAllocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo allocInfo{};
+  VkResult result =
+      vmaCreateBuffer(renderData.rdAllocator, &bufferInfo, &vmaAllocInfo,
+                      &ringData->buffer, &ringData->alloc, &allocInfo);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate frame ring SSBO via VMA (error: "
+                "%i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  ringData->data = static_cast<char*>(allocInfo.pMappedData);
+  ringData->frameSize = frameSize;
+  ringData->alignment = alignment;
+  ringData->numFrames = numFrames;
+  ringData->usage = usage;
+  ringData->frame = 0;
+
+  Logger::log(1, "%s: created frame ring SSBO with %i slices of %i bytes\n",
+              __FUNCTION__, numFrames, frameSize);
+  return true;
+}
+
+void FrameRingBuffer::beginFrame(VkFrameRingBufferData* ringData,
+                                 uint32_t frame) {
+  ringData->frame = frame % ringData->numFrames;
+}
+
+bool FrameRingBuffer::uploadFrameData(const VkRenderData& renderData,
+                                      VkFrameRingBufferData* ringData,
+                                      const void* data, VkDeviceSize size,
+                                      uint32_t* dynamicOffset) {
+  VkDeviceSize offset = ringData->frame * ringData->frameSize;
+  *dynamicOffset = static_cast<uint32_t>(offset);
+
+  if (size == 0) {
+    return true;
+  }
+
+  if (size > ringData->frameSize) {
+    Logger::log(1, "%s error: %i bytes do not fit into a slice of %i bytes\n",
+                __FUNCTION__, size, ringData->frameSize);
+    return false;
+  }
+
+  std::memcpy(ringData->data + offset, data, size);
+  vmaFlushAllocation(renderData.rdAllocator, ringData->alloc, offset, size);
+  return true;
+}
+
+bool FrameRingBuffer::writeFrameData(const VkRenderData& renderData,
+                                     VkFrameRingBufferData* ringData,
+                                     VkDeviceSize offset, const void* data,
+                                     VkDeviceSize size) {
+  if (size == 0) {
+    return true;
+  }
+
+  if (offset + size > ringData->frameSize) {
+    Logger::log(1, "%s error: %i bytes at %i do not fit into %i bytes\n",
+                __FUNCTION__, size, offset, ringData->frameSize);
+    return false;
+  }
+
+  VkDeviceSize sliceOffset = ringData->frame * ringData->frameSize + offset;
+  std::memcpy(ringData->data + sliceOffset, data, size);
+  vmaFlushAllocation(renderData.rdAllocator, ringData->alloc, sliceOffset,
+                     size);
+  return true;
+}
+
+bool FrameRingBuffer::readFrameData(const VkRenderData& renderData,
+                                    const VkFrameRingBufferData& ringData,
+                                    uint32_t frame, VkDeviceSize offset,
+                                    void* data, VkDeviceSize size) {
+  if (offset + size > ringData.frameSize || frame >= ringData.numFrames) {
+    return false;
+  }
+
+  VkDeviceSize sliceOffset = frame * ringData.frameSize + offset;
+  vmaInvalidateAllocation(renderData.rdAllocator, ringData.alloc, sliceOffset,
+                          size);
+  std::memcpy(data, ringData.data + sliceOffset, size);
+  return true;
+}
+
+bool FrameRingBuffer::checkForResize(const VkRenderData& renderData,
+                                     VkFrameRingBufferData* ringData,
+                                     VkDeviceSize frameSize) {
+  if (frameSize <= ringData->frameSize) {
+    return false;
+  }
+
+  /* grow in bigger steps to avoid resizing every few frames */
+  VkDeviceSize newFrameSize = std::max(frameSize, ringData->frameSize * 2);
+  Logger::log(1, "%s: resize frame ring SSBO %p from %i to %i bytes\n",
+              __FUNCTION__, ringData->buffer, ringData->frameSize,
+              newFrameSize);
+
+  /* the slices of the other frames may still be read by the GPU */
+  vkDeviceWaitIdle(renderData.rdVkbDevice.device);
+
+  uint32_t frame = ringData->frame;
+  uint32_t numFrames = ringData->numFrames;
+  VkDeviceSize alignment = ringData->alignment;
+  VkBufferUsageFlags usage = ringData->usage;
+  cleanup(renderData, ringData);
+  init(renderData, ringData, newFrameSize, numFrames, alignment, usage);
+  ringData->frame = frame;
+
+  return true;
+}
+
+void FrameRingBuffer::cleanup(const VkRenderData& renderData,
+                              VkFrameRingBufferData* ringData) {
+  vmaDestroyBuffer(renderData.rdAllocator, ringData->buffer, ringData->alloc);
+  ringData->buffer = VK_NULL_HANDLE;
+  ringData->alloc = VK_NULL_HANDLE;
+  ringData->data = nullptr;
+}
@@ -0,0 +1,44 @@
+/* multi-buffered SSBO or UBO for data rewritten every frame */
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VkRenderData.h"
+
+class FrameRingBuffer {
+ public:
+  static bool init(const VkRenderData& renderData,
+                   VkFrameRingBufferData* ringData, VkDeviceSize frameSize,
+                   uint32_t numFrames, VkDeviceSize alignment,
+                   VkBufferUsageFlags usage =
+                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+  /* selects the slice for this frame, the GPU must be done with it */
+  static void beginFrame(VkFrameRingBufferData* ringData, uint32_t frame);
+
+  /* copies into the current slice and flushes only the written range,
+   * returns the dynamic offset to use for the descriptor binding */
+  static bool uploadFrameData(const VkRenderData& renderData,
+                              VkFrameRingBufferData* ringData,
+                              const void* data, VkDeviceSize size,
+                              uint32_t* dynamicOffset);
+
+  /* copies to an offset inside the current slice, no dynamic offset */
+  static bool writeFrameData(const VkRenderData& renderData,
+                             VkFrameRingBufferData* ringData,
+                             VkDeviceSize offset, const void* data,
+                             VkDeviceSize size);
+  /* reads back GPU results from a slice the GPU is done with */
+  static bool readFrameData(const VkRenderData& renderData,
+                            const VkFrameRingBufferData& ringData,
+                            uint32_t frame, VkDeviceSize offset, void* data,
+                            VkDeviceSize size);
+
+  /* grows all slices, returns true if the descriptors must be updated */
+  static bool checkForResize(const VkRenderData& renderData,
+                             VkFrameRingBufferData* ringData,
+                             VkDeviceSize frameSize);
+
+  static void cleanup(const VkRenderData& renderData,
+                      VkFrameRingBufferData* ringData);
+};
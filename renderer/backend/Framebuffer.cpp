@@ -1,6 +1,7 @@
 #include "Framebuffer.h"
 
-#include "CommandBuffer.h"
+#include <algorithm>
+
 #include "Logger.h"
 
 bool Framebuffer::init(VkRenderData* renderData) {
@@ -37,112 +38,153 @@ bool Framebuffer::init(VkRenderData* renderData) {
   return true;
 }
 
-int Framebuffer::getPixelValueFromSelectionImage(const VkRenderData& renderData,
-                                                 glm::uvec2 pos) {
-  VkCommandBuffer readbackCmd = CommandBuffer::createTransientBuffer(
-      renderData, renderData.rdCommandPool);
-
-  VkImageSubresourceRange layoutTransferRange{};
-  layoutTransferRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  layoutTransferRange.baseMipLevel = 0;
-  layoutTransferRange.levelCount = 1;
-  layoutTransferRange.baseArrayLayer = 0;
-  layoutTransferRange.layerCount = 1;
-
-  /* transition destination (local) image to transfer destination layout
-   */
-  VkImageMemoryBarrier layoutTransferBarrier{};
-  layoutTransferBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-  layoutTransferBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  layoutTransferBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  layoutTransferBarrier.image = renderData.rdLocalSelectionImage;
-  layoutTransferBarrier.subresourceRange = layoutTransferRange;
-  layoutTransferBarrier.srcAccessMask = 0;
-  layoutTransferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-  /* transition source (selection) image to transfer source optimal layout
-   */
+bool Framebuffer::initSelectionReadback(
+    const VkRenderData& renderData, VkSelectionReadbackData* readback) {
+  VkBufferCreateInfo bufferInfo{};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = kReadbackRegionSize * kReadbackRegionSize * sizeof(int);
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+  VmaAllocationCreateInfo vmaAllocInfo{};
+  vmaAllocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+  vmaAllocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo allocInfo{};
+  VkResult result =
+      vmaCreateBuffer(renderData.rdAllocator, &bufferInfo, &vmaAllocInfo,
+                      &readback->buffer, &readback->alloc, &allocInfo);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate selection readback buffer "
+                "(error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  readback->data = static_cast<int*>(allocInfo.pMappedData);
+  readback->pending = false;
+  return true;
+}
+
+void Framebuffer::recordSelectionReadback(const VkRenderData& renderData,
+                                          VkSelectionReadbackData* readback,
+                                          glm::uvec2 pos) {
+  const VkExtent2D& extent = renderData.rdVkbSwapchain.extent;
+  if (extent.width == 0 || extent.height == 0) {
+    return;
+  }
+
+  /* copy only a small region around the cursor, kept inside the image */
+  uint32_t width = std::min(kReadbackRegionSize, extent.width);
+  uint32_t height = std::min(kReadbackRegionSize, extent.height);
+  pos.x = std::min(pos.x, extent.width - 1);
+  pos.y = std::min(pos.y, extent.height - 1);
+
+  uint32_t originX = pos.x > width / 2 ? pos.x - width / 2 : 0;
+  uint32_t originY = pos.y > height / 2 ? pos.y - height / 2 : 0;
+  originX = std::min(originX, extent.width - width);
+  originY = std::min(originY, extent.height - height);
+
+  readback->regionWidth = width;
+  readback->regionPos = glm::uvec2(pos.x - originX, pos.y - originY);
+
+  VkImageSubresourceRange selectionRange{};
+  selectionRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  selectionRange.baseMipLevel = 0;
+  selectionRange.levelCount = 1;
+  selectionRange.baseArrayLayer = 0;
+  selectionRange.layerCount = 1;
+
+  /* the render pass leaves the selection image as color attachment */
   VkImageMemoryBarrier srcLayoutTransferBarrier{};
   srcLayoutTransferBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
   srcLayoutTransferBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
   srcLayoutTransferBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  srcLayoutTransferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  srcLayoutTransferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
   srcLayoutTransferBarrier.image = renderData.rdSelectionImage;
-  srcLayoutTransferBarrier.subresourceRange = layoutTransferRange;
-  srcLayoutTransferBarrier.srcAccessMask = 0;
-  srcLayoutTransferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-  /* copy selection image to local image */
-  VkImageCopy imageCopyRegion{};
-  imageCopyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  imageCopyRegion.srcSubresource.layerCount = 1;
-  imageCopyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  imageCopyRegion.dstSubresource.layerCount = 1;
-  imageCopyRegion.extent.width = renderData.rdVkbSwapchain.extent.width;
-  imageCopyRegion.extent.height = renderData.rdVkbSwapchain.extent.height;
-  imageCopyRegion.extent.depth = 1;
-
-  /* transition destination (local) image to general layout to allow
-   * mapping */
-  VkImageMemoryBarrier destLayoutTransferBarrier{};
-  destLayoutTransferBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-  destLayoutTransferBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  destLayoutTransferBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-  destLayoutTransferBarrier.image = renderData.rdLocalSelectionImage;
-  destLayoutTransferBarrier.subresourceRange = layoutTransferRange;
-  destLayoutTransferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  destLayoutTransferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
-
-  vkCmdPipelineBarrier(readbackCmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
-                       nullptr, 1, &layoutTransferBarrier);
-  vkCmdPipelineBarrier(readbackCmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+  srcLayoutTransferBarrier.subresourceRange = selectionRange;
+  srcLayoutTransferBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  srcLayoutTransferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+  vkCmdPipelineBarrier(renderData.rdCommandBuffer,
+                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
                        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
                        nullptr, 1, &srcLayoutTransferBarrier);
-  vkCmdCopyImage(readbackCmd, renderData.rdSelectionImage,
-                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                 renderData.rdLocalSelectionImage,
-                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopyRegion);
-  vkCmdPipelineBarrier(readbackCmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                       VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                       &destLayoutTransferBarrier);
-
-  bool commandResult = CommandBuffer::submitTransientBuffer(
-      renderData, renderData.rdCommandPool, readbackCmd,
-      renderData.rdGraphicsQueue);
-
-  if (!commandResult) {
-    Logger::log(1, "%s error: could not submit readback transfer commands\n",
-                __FUNCTION__);
-    return -1;
-  }
 
-  /* get image layout */
-  VkImageSubresource subResource{};
-  subResource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  VkSubresourceLayout subResourceLayout{};
+  VkBufferImageCopy copyRegion{};
+  copyRegion.bufferOffset = 0;
+  copyRegion.bufferRowLength = 0;
+  copyRegion.bufferImageHeight = 0;
+  copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  copyRegion.imageSubresource.mipLevel = 0;
+  copyRegion.imageSubresource.baseArrayLayer = 0;
+  copyRegion.imageSubresource.layerCount = 1;
+  copyRegion.imageOffset = {static_cast<int32_t>(originX),
+                            static_cast<int32_t>(originY), 0};
+  copyRegion.imageExtent = {width, height, 1};
+
+  vkCmdCopyImageToBuffer(renderData.rdCommandBuffer,
+                         renderData.rdSelectionImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback->buffer,
+                         1, &copyRegion);
+
+  /* back to the final layout of the render pass, the next frame must not
+   * overwrite the image before the copy has finished */
+  VkImageMemoryBarrier dstLayoutTransferBarrier = srcLayoutTransferBarrier;
+  dstLayoutTransferBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  dstLayoutTransferBarrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  dstLayoutTransferBarrier.srcAccessMask = 0;
+  dstLayoutTransferBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  vkCmdPipelineBarrier(renderData.rdCommandBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0,
+                       nullptr, 0, nullptr, 1, &dstLayoutTransferBarrier);
+
+  /* make the copied pixels visible to the host */
+  VkBufferMemoryBarrier hostReadBarrier{};
+  hostReadBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  hostReadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  hostReadBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  hostReadBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  hostReadBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  hostReadBarrier.buffer = readback->buffer;
+  hostReadBarrier.offset = 0;
+  hostReadBarrier.size = VK_WHOLE_SIZE;
+
+  vkCmdPipelineBarrier(renderData.rdCommandBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+                       &hostReadBarrier, 0, nullptr);
+
+  readback->pending = true;
+}
 
-  vkGetImageSubresourceLayout(renderData.rdVkbDevice.device,
-                              renderData.rdLocalSelectionImage, &subResource,
-                              &subResourceLayout);
+int Framebuffer::getSelectionReadbackValue(const VkRenderData& renderData,
+                                           VkSelectionReadbackData* readback) {
+  readback->pending = false;
 
-  const int* pData;
-  VkResult result =
-      vmaMapMemory(renderData.rdAllocator,
-                   renderData.rdLocalSelectionImageAlloc, (void**)&pData);
+  VkResult result = vmaInvalidateAllocation(renderData.rdAllocator,
+                                            readback->alloc, 0, VK_WHOLE_SIZE);
   if (result != VK_SUCCESS) {
     Logger::log(1,
-                "%s error: could not map readback image memory (error: %i)\n",
+                "%s error: could not invalidate readback memory (error: %i)\n",
                 __FUNCTION__, result);
     return -1;
   }
 
-  pData += pos.y * subResourceLayout.rowPitch / sizeof(int) + pos.x;
-
-  int pixelData = *pData;
-
-  vmaUnmapMemory(renderData.rdAllocator, renderData.rdLocalSelectionImageAlloc);
+  return readback->data[readback->regionPos.y * readback->regionWidth +
+                        readback->regionPos.x];
+}
 
-  return pixelData;
+void Framebuffer::cleanupSelectionReadback(const VkRenderData& renderData,
+                                           VkSelectionReadbackData* readback) {
+  vmaDestroyBuffer(renderData.rdAllocator, readback->buffer, readback->alloc);
+  readback->buffer = VK_NULL_HANDLE;
+  readback->alloc = VK_NULL_HANDLE;
+  readback->data = nullptr;
+  readback->pending = false;
 }
 
 void Framebuffer::cleanup(VkRenderData* renderData) {
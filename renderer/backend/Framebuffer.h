@@ -9,7 +9,20 @@
 class Framebuffer {
  public:
   static bool init(VkRenderData* renderData);
-  static int getPixelValueFromSelectionImage(const VkRenderData& renderData,
-                                             glm::uvec2 pos);
   static void cleanup(VkRenderData* renderData);
+
+  /* mouse picking, the copy is recorded into the frame command buffer after
+   * the render pass and read back once the fence of that frame signaled */
+  static bool initSelectionReadback(const VkRenderData& renderData,
+                                    VkSelectionReadbackData* readback);
+  static void recordSelectionReadback(const VkRenderData& renderData,
+                                      VkSelectionReadbackData* readback,
+                                      glm::uvec2 pos);
+  static int getSelectionReadbackValue(const VkRenderData& renderData,
+                                       VkSelectionReadbackData* readback);
+  static void cleanupSelectionReadback(const VkRenderData& renderData,
+                                       VkSelectionReadbackData* readback);
+
+ private:
+  static constexpr uint32_t kReadbackRegionSize = 8;
 };
@@ -0,0 +1,323 @@
+#include "GeometryArena.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Logger.h"
+#include "UploadManager.h"
+
+void GeometryArena::init(VkRenderData& renderData) {
+  VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+
+  /* the buffers are created by the first upload */
+  geometryArena.vertices.elementSize = sizeof(VkVertex);
+  geometryArena.vertices.minCapacity = kMinVertexCount;
+  geometryArena.vertices.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+  geometryArena.packedVertices.elementSize = sizeof(VkPackedVertex);
+  geometryArena.packedVertices.minCapacity = kMinVertexCount;
+  geometryArena.packedVertices.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+  geometryArena.indices.elementSize = sizeof(uint32_t);
+  geometryArena.indices.minCapacity = kMinIndexCount;
+  geometryArena.indices.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+  geometryArena.vertices.allocator.init(0);
+  geometryArena.packedVertices.allocator.init(0);
+  geometryArena.indices.allocator.init(0);
+}
+
+bool GeometryArena::uploadMesh(VkRenderData& renderData, const VkMesh& mesh,
+                               bool packedVertices, VkMeshRanges* meshRanges) {
+  VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+  meshRanges->packedVertices = packedVertices;
+
+  bool vertexResult = false;
+  if (packedVertices) {
+    vertexResult = upload(renderData, geometryArena.packedVertices,
+                          mesh.packedVertices.data(),
+                          mesh.packedVertices.size(), &meshRanges->vertexRange);
+  } else {
+    vertexResult = upload(renderData, geometryArena.vertices,
+                          mesh.vertices.data(), mesh.vertices.size(),
+                          &meshRanges->vertexRange);
+  }
+  if (!vertexResult) {
+    Logger::log(1, "%s error: could not upload vertex data\n", __FUNCTION__);
+    return false;
+  }
+
+  if (!upload(renderData, geometryArena.indices, mesh.indices.data(),
+              mesh.indices.size(), &meshRanges->indexRange)) {
+    Logger::log(1, "%s error: could not upload index data\n", __FUNCTION__);
+    return false;
+  }
+  return true;
+}
+
+void GeometryArena::freeMesh(VkRenderData& renderData,
+                             VkMeshRanges* meshRanges) {
+  VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+
+  if (meshRanges->vertexRange != RangeAllocator::kInvalidRange) {
+    VkArenaBufferData& vertexArena = meshRanges->packedVertices
+                                         ? geometryArena.packedVertices
+                                         : geometryArena.vertices;
+    vertexArena.allocator.free(meshRanges->vertexRange);
+    meshRanges->vertexRange = RangeAllocator::kInvalidRange;
+  }
+
+  if (meshRanges->indexRange != RangeAllocator::kInvalidRange) {
+    geometryArena.indices.allocator.free(meshRanges->indexRange);
+    meshRanges->indexRange = RangeAllocator::kInvalidRange;
+  }
+}
+
+int32_t GeometryArena::getVertexOffset(const VkRenderData& renderData,
+                                       const VkMeshRanges& meshRanges) {
+  const VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+  const VkArenaBufferData& vertexArena = meshRanges.packedVertices
+                                             ? geometryArena.packedVertices
+                                             : geometryArena.vertices;
+  return static_cast<int32_t>(
+      vertexArena.allocator.getOffset(meshRanges.vertexRange));
+}
+
+uint32_t GeometryArena::getFirstIndex(const VkRenderData& renderData,
+                                      const VkMeshRanges& meshRanges) {
+  return static_cast<uint32_t>(
+      renderData.rdGeometryArena.indices.allocator.getOffset(
+          meshRanges.indexRange));
+}
+
+uint32_t GeometryArena::getGeneration(const VkRenderData& renderData) {
+  return renderData.rdGeometryArena.generation;
+}
+
+void GeometryArena::bindBuffers(const VkRenderData& renderData,
+                                VkCommandBuffer commandBuffer,
+                                bool packedVertices) {
+  const VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+  const VkArenaBufferData& vertexArena =
+      packedVertices ? geometryArena.packedVertices : geometryArena.vertices;
+
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexArena.buffer, &offset);
+  vkCmdBindIndexBuffer(commandBuffer, geometryArena.indices.buffer, 0,
+                       VK_INDEX_TYPE_UINT32);
+}
+
+bool GeometryArena::defragment(VkRenderData& renderData) {
+  VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+
+  for (auto* arena : {&geometryArena.vertices, &geometryArena.packedVertices,
+                      &geometryArena.indices}) {
+    const RangeAllocator& allocator = arena->allocator;
+
+    /* give memory back if less than a quarter is used */
+    uint64_t capacity = allocator.getCapacity();
+    if (allocator.getUsedSize() < capacity / 4) {
+      capacity = std::max(capacity / 2, arena->minCapacity);
+    }
+
+    /* no holes between the ranges and nothing to give back */
+    if (allocator.getUsedEnd() == allocator.getUsedSize() &&
+        capacity == allocator.getCapacity()) {
+      continue;
+    }
+
+    Logger::log(1, "%s: compacting %i of %i elements into %i\n", __FUNCTION__,
+                allocator.getUsedSize(), allocator.getUsedEnd(), capacity);
+    if (!reallocate(renderData, *arena, capacity)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+VkDeviceSize GeometryArena::getUsedSize(const VkRenderData& renderData) {
+  const VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+  VkDeviceSize usedSize = 0;
+  for (const auto* arena : {&geometryArena.vertices,
+                            &geometryArena.packedVertices,
+                            &geometryArena.indices}) {
+    usedSize += arena->allocator.getUsedSize() * arena->elementSize;
+  }
+  return usedSize;
+}
+
+VkDeviceSize GeometryArena::getCapacity(const VkRenderData& renderData) {
+  const VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+  VkDeviceSize capacity = 0;
+  for (const auto* arena : {&geometryArena.vertices,
+                            &geometryArena.packedVertices,
+                            &geometryArena.indices}) {
+    capacity += arena->allocator.getCapacity() * arena->elementSize;
+  }
+  return capacity;
+}
+
+void GeometryArena::cleanup(VkRenderData& renderData) {
+  VkGeometryArenaData& geometryArena = renderData.rdGeometryArena;
+
+  for (auto* arena : {&geometryArena.vertices, &geometryArena.packedVertices,
+                      &geometryArena.indices}) {
+    if (arena->buffer != VK_NULL_HANDLE) {
+      vmaDestroyBuffer(renderData.rdAllocator, arena->buffer, arena->alloc);
+    }
+    arena->buffer = VK_NULL_HANDLE;
+    arena->alloc = VK_NULL_HANDLE;
+    arena->allocator.init(0);
+  }
+}
+
+bool GeometryArena::allocate(VkRenderData& renderData,
+                             VkArenaBufferData& arena, uint64_t count,
+                             uint32_t* handle) {
+  *handle = arena.allocator.allocate(count);
+  if (*handle != RangeAllocator::kInvalidRange) {
+    return true;
+  }
+
+  /* double the size, the reallocation also closes all holes */
+  uint64_t capacity =
+      std::max(arena.allocator.getCapacity() * 2, arena.minCapacity);
+  while (capacity < arena.allocator.getUsedSize() + count) {
+    capacity *= 2;
+  }
+
+  Logger::log(1, "%s: growing geometry arena from %i to %i elements\n",
+              __FUNCTION__, arena.allocator.getCapacity(), capacity);
+  if (!reallocate(renderData, arena, capacity)) {
+    return false;
+  }
+
+  *handle = arena.allocator.allocate(count);
+  return *handle != RangeAllocator::kInvalidRange;
+}
+
+bool GeometryArena::upload(VkRenderData& renderData, VkArenaBufferData& arena,
+                           const void* data, uint64_t count,
+                           uint32_t* handle) {
+  if (!allocate(renderData, arena, count, handle)) {
+    return false;
+  }
+
+  VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+  return UploadManager::uploadBuffer(
+      renderData, arena.buffer, data, count * arena.elementSize, dstStage,
+      getReadAccess(arena),
+      arena.allocator.getOffset(*handle) * arena.elementSize);
+}
+
+bool GeometryArena::reallocate(VkRenderData& renderData,
+                               VkArenaBufferData& arena, uint64_t capacity) {
+  VkBufferCreateInfo bufferInfo{};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = capacity * arena.elementSize;
+  bufferInfo.usage = arena.usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo bufferAllocInfo{};
+  bufferAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VmaAllocation alloc = VK_NULL_HANDLE;
+  VkResult result = vmaCreateBuffer(renderData.rdAllocator, &bufferInfo,
+                                    &bufferAllocInfo, &buffer, &alloc, nullptr);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate geometry arena of %i bytes via "
+                "VMA (error: %i)\n",
+                __FUNCTION__, bufferInfo.size, result);
+    return false;
+  }
+
+  if (arena.buffer == VK_NULL_HANDLE) {
+    arena.buffer = buffer;
+    arena.alloc = alloc;
+    arena.allocator.resize(capacity);
+    return true;
+  }
+
+  /* pending copies into the old buffer must land first, and frames in
+   * flight may still read from it */
+  if (!UploadManager::flush(renderData)) {
+    vmaDestroyBuffer(renderData.rdAllocator, buffer, alloc);
+    return false;
+  }
+  result = vkDeviceWaitIdle(renderData.rdVkbDevice.device);
+  if (result != VK_SUCCESS) {
+    Logger::log(1, "%s error: could not wait for device idle (error: %i)\n",
+                __FUNCTION__, result);
+    vmaDestroyBuffer(renderData.rdAllocator, buffer, alloc);
+    return false;
+  }
+
+  /* the old offsets stay valid if the copy fails */
+  RangeAllocator oldAllocator = arena.allocator;
+  std::vector<RangeMove> moves = arena.allocator.defragment();
+  arena.allocator.resize(capacity);
+
+  std::vector<VkBufferCopy> copyRegions{};
+  for (const auto& move : moves) {
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = move.srcOffset * arena.elementSize;
+    copyRegion.dstOffset = move.dstOffset * arena.elementSize;
+    copyRegion.size = move.size * arena.elementSize;
+    copyRegions.emplace_back(copyRegion);
+  }
+
+  if (!copyRegions.empty()) {
+    VkCommandBuffer commandBuffer = UploadManager::getCommandBuffer(renderData);
+    if (commandBuffer == VK_NULL_HANDLE) {
+      arena.allocator = oldAllocator;
+      vmaDestroyBuffer(renderData.rdAllocator, buffer, alloc);
+      return false;
+    }
+
+    VkBufferMemoryBarrier bufferBarrier{};
+    bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    bufferBarrier.dstAccessMask = getReadAccess(arena);
+    bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.buffer = buffer;
+    bufferBarrier.offset = 0;
+    bufferBarrier.size = VK_WHOLE_SIZE;
+
+    vkCmdCopyBuffer(commandBuffer, arena.buffer, buffer,
+                    static_cast<uint32_t>(copyRegions.size()),
+                    copyRegions.data());
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0, nullptr, 1,
+                         &bufferBarrier, 0, nullptr);
+
+    /* the old buffer is destroyed below, the copy must be done by then */
+    if (!UploadManager::flush(renderData) ||
+        !UploadManager::retire(renderData, true)) {
+      Logger::log(1, "%s error: could not copy the geometry arena\n",
+                  __FUNCTION__);
+      /* the new buffer has undefined contents, keep drawing from the old
+       * one. the copy may still be pending */
+      vkDeviceWaitIdle(renderData.rdVkbDevice.device);
+      arena.allocator = oldAllocator;
+      vmaDestroyBuffer(renderData.rdAllocator, buffer, alloc);
+      return false;
+    }
+  }
+
+  vmaDestroyBuffer(renderData.rdAllocator, arena.buffer, arena.alloc);
+  arena.buffer = buffer;
+  arena.alloc = alloc;
+  ++renderData.rdGeometryArena.generation;
+  return true;
+}
+
+VkAccessFlags GeometryArena::getReadAccess(const VkArenaBufferData& arena) {
+  if (arena.usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) {
+    return VK_ACCESS_INDEX_READ_BIT;
+  }
+  return VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+}
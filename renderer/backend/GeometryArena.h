@@ -0,0 +1,54 @@
+/* vertices and indices of all models in three shared buffers, meshes draw
+ * with vertexOffset and firstIndex instead of own buffers */
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VkRenderData.h"
+
+class GeometryArena {
+ public:
+  static void init(VkRenderData& renderData);
+
+  /* the buffers grow on demand, the copies are submitted with the next
+   * UploadManager::flush(). must not run while a frame is recorded */
+  static bool uploadMesh(VkRenderData& renderData, const VkMesh& mesh,
+                         bool packedVertices, VkMeshRanges* meshRanges);
+  /* the GPU must be done with the mesh */
+  static void freeMesh(VkRenderData& renderData, VkMeshRanges* meshRanges);
+
+  /* change with every reallocation, cached values are valid as long as
+   * getGeneration() returns the same number */
+  static int32_t getVertexOffset(const VkRenderData& renderData,
+                                 const VkMeshRanges& meshRanges);
+  static uint32_t getFirstIndex(const VkRenderData& renderData,
+                                const VkMeshRanges& meshRanges);
+
+  static uint32_t getGeneration(const VkRenderData& renderData);
+
+  static void bindBuffers(const VkRenderData& renderData,
+                          VkCommandBuffer commandBuffer, bool packedVertices);
+
+  /* closes the holes left by freed meshes, waits for the device */
+  static bool defragment(VkRenderData& renderData);
+
+  /* in bytes, over all three buffers */
+  static VkDeviceSize getUsedSize(const VkRenderData& renderData);
+  static VkDeviceSize getCapacity(const VkRenderData& renderData);
+
+  static void cleanup(VkRenderData& renderData);
+
+ private:
+  /* initial sizes in elements, about 5 MiB, 1.5 MiB and 1 MiB */
+  static constexpr uint64_t kMinVertexCount = 64 * 1024;
+  static constexpr uint64_t kMinIndexCount = 256 * 1024;
+
+  static bool allocate(VkRenderData& renderData, VkArenaBufferData& arena,
+                       uint64_t count, uint32_t* handle);
+  static bool upload(VkRenderData& renderData, VkArenaBufferData& arena,
+                     const void* data, uint64_t count, uint32_t* handle);
+  /* copies the live ranges into a new buffer of the given capacity */
+  static bool reallocate(VkRenderData& renderData, VkArenaBufferData& arena,
+                         uint64_t capacity);
+  static VkAccessFlags getReadAccess(const VkArenaBufferData& arena);
+};
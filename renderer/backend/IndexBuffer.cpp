@@ -1,9 +1,7 @@
 #include "IndexBuffer.h"
 
-#include <cstring>
-
-#include "CommandBuffer.h"
 #include "Logger.h"
+#include "UploadManager.h"
 
 bool IndexBuffer::init(const VkRenderData& renderData,
                        VkIndexBufferData* bufferData, size_t bufferSize) {
@@ -28,31 +26,11 @@ bool IndexBuffer::init(const VkRenderData& renderData,
     return false;
   }
 
-  /* staging buffer for copy */
-  VkBufferCreateInfo stagingBufferInfo{};
-  stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  stagingBufferInfo.size = bufferSize;
-  ;
-  stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-  VmaAllocationCreateInfo stagingAllocInfo{};
-  stagingAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-  result = vmaCreateBuffer(renderData.rdAllocator, &stagingBufferInfo,
-                           &stagingAllocInfo, &bufferData->staging,
-                           &bufferData->stagingAlloc, nullptr);
-  if (result != VK_SUCCESS) {
-    Logger::log(1,
-                "%s error: could not allocate index staging buffer via VMA "
-                "(error: %i)\n",
-                __FUNCTION__, result);
-    return false;
-  }
   bufferData->size = bufferSize;
   return true;
 }
 
-bool IndexBuffer::uploadData(const VkRenderData& renderData,
+bool IndexBuffer::uploadData(VkRenderData& renderData,
                              VkIndexBufferData* bufferData,
                              const VkMesh& vertexData) {
   /* buffer too small, resize */
@@ -71,48 +49,12 @@ bool IndexBuffer::uploadData(const VkRenderData& renderData,
     bufferData->size = indexDataSize;
   }
 
-  /* copy data to staging buffer */
-  void* data;
-  VkResult result =
-      vmaMapMemory(renderData.rdAllocator, bufferData->stagingAlloc, &data);
-  if (result != VK_SUCCESS) {
-    Logger::log(1, "%s error: could not map index buffer memory (error: %i)\n",
-                __FUNCTION__, result);
-    return false;
-  }
-  std::memcpy(data, vertexData.indices.data(), indexDataSize);
-  vmaUnmapMemory(renderData.rdAllocator, bufferData->stagingAlloc);
-  vmaFlushAllocation(renderData.rdAllocator, bufferData->stagingAlloc, 0,
-                     indexDataSize);
-
-  VkBufferMemoryBarrier indexBufferBarrier{};
-  indexBufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-  indexBufferBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
-  indexBufferBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
-  indexBufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  indexBufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  indexBufferBarrier.buffer = bufferData->staging;
-  indexBufferBarrier.offset = 0;
-  indexBufferBarrier.size = bufferData->size;
-
-  VkBufferCopy stagingBufferCopy{};
-  stagingBufferCopy.srcOffset = 0;
-  stagingBufferCopy.dstOffset = 0;
-  stagingBufferCopy.size = bufferData->size;
-
-  /* trigger data transfer via command buffer */
-  VkCommandBuffer commandBuffer = CommandBuffer::createTransientBuffer(
-      renderData, renderData.rdCommandPool);
-
-  vkCmdCopyBuffer(commandBuffer, bufferData->staging, bufferData->buffer, 1,
-                  &stagingBufferCopy);
-  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0, nullptr, 1,
-                       &indexBufferBarrier, 0, nullptr);
-
-  if (!CommandBuffer::submitTransientBuffer(
-          renderData, renderData.rdCommandPool, commandBuffer,
-          renderData.rdGraphicsQueue)) {
+  /* copy is recorded into the current upload batch */
+  if (!UploadManager::uploadBuffer(renderData, bufferData->buffer,
+                                   vertexData.indices.data(), indexDataSize,
+                                   VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                   VK_ACCESS_INDEX_READ_BIT)) {
+    Logger::log(1, "%s error: could not upload index data\n", __FUNCTION__);
     return false;
   }
 
@@ -121,8 +63,6 @@ bool IndexBuffer::uploadData(const VkRenderData& renderData,
 
 void IndexBuffer::cleanup(const VkRenderData& renderData,
                           VkIndexBufferData* bufferData) {
-  vmaDestroyBuffer(renderData.rdAllocator, bufferData->staging,
-                   bufferData->stagingAlloc);
   vmaDestroyBuffer(renderData.rdAllocator, bufferData->buffer,
                    bufferData->alloc);
 }
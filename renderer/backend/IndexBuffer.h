@@ -8,7 +8,7 @@ class IndexBuffer {
  public:
   static bool init(const VkRenderData& renderData,
                    VkIndexBufferData* bufferData, size_t bufferSize);
-  static bool uploadData(const VkRenderData& renderData,
+  static bool uploadData(VkRenderData& renderData,
                          VkIndexBufferData* bufferData,
                          const VkMesh& vertexData);
 
@@ -0,0 +1,102 @@
+#include "SecondaryCommandBuffer.h"
+
+#include <VkBootstrap.h>
+
+#include "CommandPool.h"
+#include "Logger.h"
+
+bool SecondaryCommandBuffer::init(VkRenderData& renderData, uint32_t numFrames,
+                                  unsigned int numWorkers) {
+  renderData.rdRecordPools.resize(numFrames);
+
+  for (auto& framePools : renderData.rdRecordPools) {
+    while (framePools.size() < numWorkers) {
+      /* the pool is reset per frame, no single buffer resets */
+      VkRecordPoolData recordPool{};
+      if (!CommandPool::init(renderData, vkb::QueueType::graphics,
+                             &recordPool.pool,
+                             VK_COMMAND_POOL_CREATE_TRANSIENT_BIT)) {
+        Logger::log(1, "%s error: could not create pool for worker %i\n",
+                    __FUNCTION__, framePools.size());
+        return false;
+      }
+      framePools.emplace_back(recordPool);
+    }
+  }
+  return true;
+}
+
+bool SecondaryCommandBuffer::reset(VkRenderData& renderData, uint32_t frame) {
+  for (auto& recordPool : renderData.rdRecordPools.at(frame)) {
+    if (recordPool.usedBuffers == 0) {
+      continue;
+    }
+
+    VkResult result =
+        vkResetCommandPool(renderData.rdVkbDevice.device, recordPool.pool, 0);
+    if (result != VK_SUCCESS) {
+      Logger::log(1, "%s error: could not reset command pool (error: %i)\n",
+                  __FUNCTION__, result);
+      return false;
+    }
+    recordPool.usedBuffers = 0;
+  }
+  return true;
+}
+
+VkCommandBuffer SecondaryCommandBuffer::begin(
+    VkRenderData& renderData, uint32_t frame, unsigned int worker,
+    const VkCommandBufferInheritanceInfo& inheritanceInfo) {
+  VkRecordPoolData& recordPool = renderData.rdRecordPools.at(frame).at(worker);
+
+  if (recordPool.usedBuffers == recordPool.commandBuffers.size()) {
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = recordPool.pool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkResult result = vkAllocateCommandBuffers(renderData.rdVkbDevice.device,
+                                               &allocInfo, &commandBuffer);
+    if (result != VK_SUCCESS) {
+      Logger::log(1,
+                  "%s error: could not allocate secondary command buffer "
+                  "(error: %i)\n",
+                  __FUNCTION__, result);
+      return VK_NULL_HANDLE;
+    }
+    recordPool.commandBuffers.emplace_back(commandBuffer);
+  }
+
+  VkCommandBuffer commandBuffer =
+      recordPool.commandBuffers.at(recordPool.usedBuffers);
+
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                    VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+  beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+  VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not begin secondary command buffer "
+                "(error: %i)\n",
+                __FUNCTION__, result);
+    return VK_NULL_HANDLE;
+  }
+
+  ++recordPool.usedBuffers;
+  return commandBuffer;
+}
+
+void SecondaryCommandBuffer::cleanup(VkRenderData& renderData) {
+  /* destroying the pools frees the buffers */
+  for (const auto& framePools : renderData.rdRecordPools) {
+    for (const auto& recordPool : framePools) {
+      CommandPool::cleanup(renderData, recordPool.pool);
+    }
+  }
+  renderData.rdRecordPools.clear();
+}
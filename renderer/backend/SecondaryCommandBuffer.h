@@ -0,0 +1,27 @@
+/* secondary command buffers recorded by the job system workers, every
+ * worker allocates from its own pool per frame slot */
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VkRenderData.h"
+
+class SecondaryCommandBuffer {
+ public:
+  /* adds pools until every frame slot has one per worker, existing pools
+   * are kept. must not run while the workers record */
+  static bool init(VkRenderData& renderData, uint32_t numFrames,
+                   unsigned int numWorkers);
+
+  /* all buffers of the slot are free again, the fence of the slot must
+   * have signaled */
+  static bool reset(VkRenderData& renderData, uint32_t frame);
+
+  /* allocates or reuses a buffer of the worker and begins it inside the
+   * render pass of inheritanceInfo, null on error */
+  static VkCommandBuffer begin(
+      VkRenderData& renderData, uint32_t frame, unsigned int worker,
+      const VkCommandBufferInheritanceInfo& inheritanceInfo);
+
+  static void cleanup(VkRenderData& renderData);
+};
@@ -41,6 +41,8 @@ bool ShaderStorageBuffer::uploadSSBOData(
   if (bufferSize > pSSBO->size) {
     Logger::log(1, "%s: resize SSBO %p from %i to %i bytes\n", __FUNCTION__,
                 pSSBO->buffer, pSSBO->size, bufferSize);
+    /* other frames in flight may still use the buffer */
+    vkDeviceWaitIdle(renderData.rdVkbDevice.device);
     cleanup(renderData, pSSBO);
     init(renderData, pSSBO, bufferSize);
     bufferResized = true;
@@ -55,7 +57,7 @@ bool ShaderStorageBuffer::uploadSSBOData(
   }
   std::memcpy(data, bufferData.data(), bufferSize);
   vmaUnmapMemory(renderData.rdAllocator, pSSBO->alloc);
-  vmaFlushAllocation(renderData.rdAllocator, pSSBO->alloc, 0, pSSBO->size);
+  vmaFlushAllocation(renderData.rdAllocator, pSSBO->alloc, 0, bufferSize);
 
   return bufferResized;
 }
@@ -72,6 +74,8 @@ bool ShaderStorageBuffer::uploadSSBOData(const VkRenderData& renderData,
   if (bufferSize > pSSBO->size) {
     Logger::log(1, "%s: resize SSBO %p from %i to %i bytes\n", __FUNCTION__,
                 pSSBO->buffer, pSSBO->size, bufferSize);
+    /* other frames in flight may still use the buffer */
+    vkDeviceWaitIdle(renderData.rdVkbDevice.device);
     cleanup(renderData, pSSBO);
     init(renderData, pSSBO, bufferSize);
     bufferResized = true;
@@ -86,7 +90,7 @@ bool ShaderStorageBuffer::uploadSSBOData(const VkRenderData& renderData,
   }
   std::memcpy(data, bufferData, bufferSize);
   vmaUnmapMemory(renderData.rdAllocator, pSSBO->alloc);
-  vmaFlushAllocation(renderData.rdAllocator, pSSBO->alloc, 0, pSSBO->size);
+  vmaFlushAllocation(renderData.rdAllocator, pSSBO->alloc, 0, bufferSize);
 
   return bufferResized;
 }
@@ -97,6 +101,8 @@ bool ShaderStorageBuffer::checkForResize(const VkRenderData& renderData,
   if (bufferSize > pSSBO->size) {
     Logger::log(1, "%s: resize SSBO %p from %i to %i bytes\n", __FUNCTION__,
                 pSSBO->buffer, pSSBO->size, bufferSize);
+    /* other frames in flight may still use the buffer */
+    vkDeviceWaitIdle(renderData.rdVkbDevice.device);
     cleanup(renderData, pSSBO);
     init(renderData, pSSBO, bufferSize);
     return true;
@@ -11,7 +11,8 @@ bool SkinningPipeline::init(const VkRenderData& renderData,
                             VkPipelineLayout pipelineLayout,
                             VkPipeline* pipeline,
                             const std::string& vertexShaderFilename,
-                            const std::string& fragmentShaderFilename) {
+                            const std::string& fragmentShaderFilename,
+                            bool packedVertices) {
   /* shader */
   VkShaderModule vertexModule =
       Shader::loadShader(renderData.rdVkbDevice.device, vertexShaderFilename);
@@ -41,48 +42,96 @@ bool SkinningPipeline::init(const VkRenderData& renderData,
       vertexStageInfo, fragmentStageInfo};
 
   /* assemble the graphics pipeline itself */
-  std::vector<VkVertexInputBindingDescription> vertexBindings = {
-      {0, static_cast<uint32_t>(sizeof(VkVertex)),
-       VK_VERTEX_INPUT_RATE_VERTEX}};
-
-  VkVertexInputAttributeDescription positionAttribute{};
-  positionAttribute.binding = 0;
-  positionAttribute.location = 0;
-  positionAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  positionAttribute.offset =
-      static_cast<uint32_t>(offsetof(VkVertex, position));
-
-  VkVertexInputAttributeDescription colorAttribute{};
-  colorAttribute.binding = 0;
-  colorAttribute.location = 1;
-  colorAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  colorAttribute.offset = static_cast<uint32_t>(offsetof(VkVertex, color));
-
-  VkVertexInputAttributeDescription normalAttribute{};
-  normalAttribute.binding = 0;
-  normalAttribute.location = 2;
-  normalAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  normalAttribute.offset = static_cast<uint32_t>(offsetof(VkVertex, normal));
-
-  VkVertexInputAttributeDescription jointsAttribute{};
-  jointsAttribute.binding = 0;
-  jointsAttribute.location = 3;
-  jointsAttribute.format = VK_FORMAT_R32G32B32A32_UINT;
-  jointsAttribute.offset = static_cast<uint32_t>(offsetof(VkVertex, boneNum));
-
-  VkVertexInputAttributeDescription weightAttribute{};
-  weightAttribute.binding = 0;
-  weightAttribute.location = 4;
-  weightAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  weightAttribute.offset =
-      static_cast<uint32_t>(offsetof(VkVertex, boneWeights));
-
+  std::vector<VkVertexInputBindingDescription> vertexBindings{};
   std::vector<VkVertexInputAttributeDescription> attributes{};
-  attributes.emplace_back(positionAttribute);
-  attributes.emplace_back(colorAttribute);
-  attributes.emplace_back(normalAttribute);
-  attributes.emplace_back(jointsAttribute);
-  attributes.emplace_back(weightAttribute);
+
+  if (packedVertices) {
+    vertexBindings = {{0, static_cast<uint32_t>(sizeof(VkPackedVertex)),
+                       VK_VERTEX_INPUT_RATE_VERTEX}};
+
+    VkVertexInputAttributeDescription positionAttribute{};
+    positionAttribute.binding = 0;
+    positionAttribute.location = 0;
+    positionAttribute.format = VK_FORMAT_R16G16B16A16_SNORM;
+    positionAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkPackedVertex, position));
+
+    VkVertexInputAttributeDescription normalAttribute{};
+    normalAttribute.binding = 0;
+    normalAttribute.location = 1;
+    normalAttribute.format = VK_FORMAT_R16G16_SNORM;
+    normalAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkPackedVertex, normal));
+
+    VkVertexInputAttributeDescription texCoordAttribute{};
+    texCoordAttribute.binding = 0;
+    texCoordAttribute.location = 2;
+    texCoordAttribute.format = VK_FORMAT_R16G16_SFLOAT;
+    texCoordAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkPackedVertex, texCoord));
+
+    VkVertexInputAttributeDescription jointsAttribute{};
+    jointsAttribute.binding = 0;
+    jointsAttribute.location = 3;
+    jointsAttribute.format = VK_FORMAT_R8G8B8A8_UINT;
+    jointsAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkPackedVertex, boneNum));
+
+    VkVertexInputAttributeDescription weightAttribute{};
+    weightAttribute.binding = 0;
+    weightAttribute.location = 4;
+    weightAttribute.format = VK_FORMAT_R8G8B8A8_UNORM;
+    weightAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkPackedVertex, boneWeights));
+
+    attributes.emplace_back(positionAttribute);
+    attributes.emplace_back(normalAttribute);
+    attributes.emplace_back(texCoordAttribute);
+    attributes.emplace_back(jointsAttribute);
+    attributes.emplace_back(weightAttribute);
+  } else {
+    vertexBindings = {{0, static_cast<uint32_t>(sizeof(VkVertex)),
+                       VK_VERTEX_INPUT_RATE_VERTEX}};
+
+    VkVertexInputAttributeDescription positionAttribute{};
+    positionAttribute.binding = 0;
+    positionAttribute.location = 0;
+    positionAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    positionAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkVertex, position));
+
+    VkVertexInputAttributeDescription colorAttribute{};
+    colorAttribute.binding = 0;
+    colorAttribute.location = 1;
+    colorAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    colorAttribute.offset = static_cast<uint32_t>(offsetof(VkVertex, color));
+
+    VkVertexInputAttributeDescription normalAttribute{};
+    normalAttribute.binding = 0;
+    normalAttribute.location = 2;
+    normalAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    normalAttribute.offset = static_cast<uint32_t>(offsetof(VkVertex, normal));
+
+    VkVertexInputAttributeDescription jointsAttribute{};
+    jointsAttribute.binding = 0;
+    jointsAttribute.location = 3;
+    jointsAttribute.format = VK_FORMAT_R32G32B32A32_UINT;
+    jointsAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkVertex, boneNum));
+
+    VkVertexInputAttributeDescription weightAttribute{};
+    weightAttribute.binding = 0;
+    weightAttribute.location = 4;
+    weightAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    weightAttribute.offset =
+        static_cast<uint32_t>(offsetof(VkVertex, boneWeights));
+
+    attributes.emplace_back(positionAttribute);
+    attributes.emplace_back(colorAttribute);
+    attributes.emplace_back(normalAttribute);
+    attributes.emplace_back(jointsAttribute);
+    attributes.emplace_back(weightAttribute);
+  }
 
   VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
   vertexInputInfo.sType =
@@ -8,9 +8,11 @@
 
 class SkinningPipeline {
  public:
+  /* packed pipelines read VkPackedVertex instead of VkVertex */
   static bool init(const VkRenderData& renderData,
                    VkPipelineLayout pipelineLayout, VkPipeline* pipeline,
                    const std::string& vertexShaderFilename,
-                   const std::string& fragmentShaderFilename);
+                   const std::string& fragmentShaderFilename,
+                   bool packedVertices = false);
   static void cleanup(const VkRenderData& renderData, VkPipeline pipeline);
 };
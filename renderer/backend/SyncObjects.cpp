@@ -2,7 +2,7 @@
 #include "SyncObjects.h"
 #include "VkBootstrap.h"
 
-bool SyncObjects::init(VkRenderData* renderData) {
+bool SyncObjects::init(VkRenderData* renderData, uint32_t numFrames) {
   VkFenceCreateInfo fenceInfo{};
   fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
   fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
@@ -11,34 +11,75 @@ bool SyncObjects::init(VkRenderData* renderData) {
   semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
   if (vkCreateSemaphore(renderData->rdVkbDevice.device, &semaphoreInfo, nullptr,
-                        &renderData->rdPresentSemaphore) != VK_SUCCESS ||
-      vkCreateSemaphore(renderData->rdVkbDevice.device, &semaphoreInfo, nullptr,
-                        &renderData->rdRenderSemaphore) != VK_SUCCESS ||
-      vkCreateSemaphore(renderData->rdVkbDevice.device, &semaphoreInfo, nullptr,
                         &renderData->rdComputeSemaphore) != VK_SUCCESS ||
       vkCreateSemaphore(renderData->rdVkbDevice.device, &semaphoreInfo, nullptr,
-                        &renderData->rdGraphicSemaphore) != VK_SUCCESS ||
-      vkCreateFence(renderData->rdVkbDevice.device, &fenceInfo, nullptr,
-                    &renderData->rdRenderFence) != VK_SUCCESS ||
-      vkCreateFence(renderData->rdVkbDevice.device, &fenceInfo, nullptr,
-                    &renderData->rdComputeFence) != VK_SUCCESS) {
+                        &renderData->rdGraphicSemaphore) != VK_SUCCESS) {
     Logger::log(1, "%s error: failed to init sync objects\n", __FUNCTION__);
     return false;
   }
+
+  /* every frame in flight needs its own acquire semaphore and fences */
+  renderData->rdPresentSemaphores.resize(numFrames, VK_NULL_HANDLE);
+  renderData->rdRenderFences.resize(numFrames, VK_NULL_HANDLE);
+  renderData->rdComputeFences.resize(numFrames, VK_NULL_HANDLE);
+  for (uint32_t i = 0; i < numFrames; ++i) {
+    if (vkCreateSemaphore(renderData->rdVkbDevice.device, &semaphoreInfo,
+                          nullptr, &renderData->rdPresentSemaphores.at(i)) !=
+            VK_SUCCESS ||
+        vkCreateFence(renderData->rdVkbDevice.device, &fenceInfo, nullptr,
+                      &renderData->rdRenderFences.at(i)) != VK_SUCCESS ||
+        vkCreateFence(renderData->rdVkbDevice.device, &fenceInfo, nullptr,
+                      &renderData->rdComputeFences.at(i)) != VK_SUCCESS) {
+      Logger::log(1, "%s error: failed to init sync objects for frame %i\n",
+                  __FUNCTION__, i);
+      return false;
+    }
+  }
+
+  return initSwapchainSemaphores(renderData);
+}
+
+bool SyncObjects::initSwapchainSemaphores(VkRenderData* renderData) {
+  VkSemaphoreCreateInfo semaphoreInfo{};
+  semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+  renderData->rdRenderSemaphores.resize(renderData->rdSwapchainImages.size(),
+                                        VK_NULL_HANDLE);
+  for (auto& semaphore : renderData->rdRenderSemaphores) {
+    if (vkCreateSemaphore(renderData->rdVkbDevice.device, &semaphoreInfo,
+                          nullptr, &semaphore) != VK_SUCCESS) {
+      Logger::log(1, "%s error: failed to init swapchain semaphores\n",
+                  __FUNCTION__);
+      return false;
+    }
+  }
   return true;
 }
 
+void SyncObjects::cleanupSwapchainSemaphores(VkRenderData* renderData) {
+  for (const auto& semaphore : renderData->rdRenderSemaphores) {
+    vkDestroySemaphore(renderData->rdVkbDevice.device, semaphore, nullptr);
+  }
+  renderData->rdRenderSemaphores.clear();
+}
+
 void SyncObjects::cleanup(VkRenderData* renderData) {
-  vkDestroySemaphore(renderData->rdVkbDevice.device,
-                     renderData->rdPresentSemaphore, nullptr);
-  vkDestroySemaphore(renderData->rdVkbDevice.device,
-                     renderData->rdRenderSemaphore, nullptr);
+  cleanupSwapchainSemaphores(renderData);
+
+  for (size_t i = 0; i < renderData->rdPresentSemaphores.size(); ++i) {
+    vkDestroySemaphore(renderData->rdVkbDevice.device,
+                       renderData->rdPresentSemaphores.at(i), nullptr);
+    vkDestroyFence(renderData->rdVkbDevice.device,
+                   renderData->rdRenderFences.at(i), nullptr);
+    vkDestroyFence(renderData->rdVkbDevice.device,
+                   renderData->rdComputeFences.at(i), nullptr);
+  }
+  renderData->rdPresentSemaphores.clear();
+  renderData->rdRenderFences.clear();
+  renderData->rdComputeFences.clear();
+
   vkDestroySemaphore(renderData->rdVkbDevice.device,
                      renderData->rdComputeSemaphore, nullptr);
   vkDestroySemaphore(renderData->rdVkbDevice.device,
                      renderData->rdGraphicSemaphore, nullptr);
-  vkDestroyFence(renderData->rdVkbDevice.device, renderData->rdRenderFence,
-                 nullptr);
-  vkDestroyFence(renderData->rdVkbDevice.device, renderData->rdComputeFence,
-                 nullptr);
 }
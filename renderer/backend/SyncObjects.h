@@ -6,6 +6,10 @@
 
 class SyncObjects {
  public:
-  static bool init(VkRenderData* renderData);
+  static bool init(VkRenderData* renderData, uint32_t numFrames);
   static void cleanup(VkRenderData* renderData);
+
+  /* one render semaphore per swapchain image, recreated with the swapchain */
+  static bool initSwapchainSemaphores(VkRenderData* renderData);
+  static void cleanupSwapchainSemaphores(VkRenderData* renderData);
 };
@@ -4,19 +4,41 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#include "CommandBuffer.h"
 #include "Logger.h"
+#include "TextureTable.h"
+#include "UploadManager.h"
 
-bool Texture::loadTexture(const VkRenderData& renderData,
+bool Texture::loadTexture(VkRenderData& renderData,
                           VkTextureData* texData,
                           const std::string& textureFilename,
                           bool generateMipmaps, bool flipImage) {
+  VkTextureImage image{};
+  if (!decodeTexture(&image, textureFilename, flipImage)) {
+    return false;
+  }
+  return loadTexture(renderData, texData, image, generateMipmaps);
+}
+
+bool Texture::loadTexture(VkRenderData& renderData,
+                          VkTextureData* texData,
+                          const std::string& textureName, aiTexel* textureData,
+                          int width, int height, bool generateMipmaps,
+                          bool flipImage) {
+  VkTextureImage image{};
+  if (!decodeTexture(&image, textureName, textureData, width, height,
+                     flipImage)) {
+    return false;
+  }
+  return loadTexture(renderData, texData, image, generateMipmaps);
+}
+
+bool Texture::decodeTexture(VkTextureImage* image,
+                            const std::string& textureFilename,
+                            bool flipImage) {
   int texWidth;
   int texHeight;
   int numberOfChannels;
-  uint32_t mipmapLevels = 1;
 
-  stbi_set_flip_vertically_on_load(flipImage);
   /* always load as RGBA */
   unsigned char* textureData =
       stbi_load(textureFilename.c_str(), &texWidth, &texHeight,
@@ -29,69 +51,16 @@ bool Texture::loadTexture(const VkRenderData& renderData,
     return false;
   }
 
-  if (generateMipmaps) {
-    mipmapLevels += static_cast<uint32_t>(
-        std::floor(std::log2(std::max(texWidth, texHeight))));
-  }
-
-  VkDeviceSize imageSize = texWidth * texHeight * 4;
-
-  /* staging buffer */
-  VkBufferCreateInfo stagingBufferInfo{};
-  stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  stagingBufferInfo.size = imageSize;
-  stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-  VkBuffer stagingBuffer;
-  VmaAllocation stagingBufferAlloc;
-
-  VmaAllocationCreateInfo stagingAllocInfo{};
-  stagingAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-  VkResult result = vmaCreateBuffer(renderData.rdAllocator, &stagingBufferInfo,
-                                    &stagingAllocInfo, &stagingBuffer,
-                                    &stagingBufferAlloc, nullptr);
-  if (result != VK_SUCCESS) {
-    Logger::log(1,
-                "%s error: could not allocate texture staging buffer via VMA "
-                "(error: %i)\n",
-                __FUNCTION__, result);
-    return false;
-  }
-
-  void* uploadData;
-  result =
-      vmaMapMemory(renderData.rdAllocator, stagingBufferAlloc, &uploadData);
-  if (result != VK_SUCCESS) {
-    Logger::log(1, "%s error: could not map texture memory (error: %i)\n",
-                __FUNCTION__, result);
-    return false;
-  }
-  std::memcpy(uploadData, textureData, imageSize);
-  vmaUnmapMemory(renderData.rdAllocator, stagingBufferAlloc);
-  vmaFlushAllocation(renderData.rdAllocator, stagingBufferAlloc, 0, imageSize);
-
+  storeImage(image, textureFilename, textureData, texWidth, texHeight,
+             numberOfChannels, flipImage);
   stbi_image_free(textureData);
-
-  VkTextureStagingBuffer stagingData = {stagingBuffer, stagingBufferAlloc};
-
-  if (!uploadToGPU(renderData, texData, &stagingData, texWidth, texHeight,
-                   generateMipmaps, mipmapLevels)) {
-    Logger::log(1, "%s error: could not load texture '%s'\n", __FUNCTION__,
-                textureFilename.c_str());
-    return false;
-  }
-
-  Logger::log(1, "%s: texture '%s' loaded (%dx%d, %d channels)\n", __FUNCTION__,
-              textureFilename.c_str(), texWidth, texHeight, numberOfChannels);
   return true;
 }
 
-bool Texture::loadTexture(const VkRenderData& renderData,
-                          VkTextureData* texData,
-                          const std::string& textureName, aiTexel* textureData,
-                          int width, int height, bool generateMipmaps,
-                          bool flipImage) {
+bool Texture::decodeTexture(VkTextureImage* image,
+                            const std::string& textureName,
+                            const aiTexel* textureData, int width, int height,
+                            bool flipImage) {
   if (!textureData) {
     Logger::log(1, "%s error: could not load texture '%s'\n", __FUNCTION__,
                 textureName.c_str());
@@ -101,21 +70,17 @@ bool Texture::loadTexture(const VkRenderData& renderData,
   int texWidth;
   int texHeight;
   int numberOfChannels;
-  uint32_t mipmapLevels = 1;
-
-  /* allow to flip the image, similar to file loaded from disk */
-  stbi_set_flip_vertically_on_load(flipImage);
 
   /* we use stbi to detect the in-memory format, but always request RGBA */
+  const stbi_uc* encodedData = reinterpret_cast<const stbi_uc*>(textureData);
   unsigned char* data = nullptr;
   if (height == 0) {
-    data = stbi_load_from_memory(reinterpret_cast<unsigned char*>(textureData),
-                                 width, &texWidth, &texHeight,
+    data = stbi_load_from_memory(encodedData, width, &texWidth, &texHeight,
                                  &numberOfChannels, STBI_rgb_alpha);
   } else {
-    data = stbi_load_from_memory(reinterpret_cast<unsigned char*>(textureData),
-                                 width * height, &texWidth, &texHeight,
-                                 &numberOfChannels, STBI_rgb_alpha);
+    data = stbi_load_from_memory(encodedData, width * height, &texWidth,
+                                 &texHeight, &numberOfChannels,
+                                 STBI_rgb_alpha);
   }
 
   if (!data) {
@@ -125,79 +90,84 @@ bool Texture::loadTexture(const VkRenderData& renderData,
     return false;
   }
 
+  storeImage(image, textureName, data, texWidth, texHeight, numberOfChannels,
+             flipImage);
+  stbi_image_free(data);
+  return true;
+}
+
+/* the global stbi flip flag is not thread safe, so we flip the rows here */
+void Texture::storeImage(VkTextureImage* image, const std::string& name,
+                         const unsigned char* data, int width, int height,
+                         int channels, bool flipImage) {
+  const size_t rowSize = static_cast<size_t>(width) * 4;
+
+  image->name = name;
+  image->width = width;
+  image->height = height;
+  image->channels = channels;
+  image->pixels.resize(rowSize * height);
+
+  if (flipImage) {
+    for (int row = 0; row < height; ++row) {
+      std::memcpy(image->pixels.data() + row * rowSize,
+                  data + (height - 1 - row) * rowSize, rowSize);
+    }
+  } else {
+    std::memcpy(image->pixels.data(), data, image->pixels.size());
+  }
+}
+
+bool Texture::loadTexture(VkRenderData& renderData,
+                          VkTextureData* texData, const VkTextureImage& image,
+                          bool generateMipmaps) {
+  uint32_t mipmapLevels = 1;
   if (generateMipmaps) {
     mipmapLevels += static_cast<uint32_t>(
-        std::floor(std::log2(std::max(texWidth, texHeight))));
+        std::floor(std::log2(std::max(image.width, image.height))));
   }
 
-  VkDeviceSize imageSize = texWidth * texHeight * 4;
-
-  /* staging buffer */
-  VkBufferCreateInfo stagingBufferInfo{};
-  stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  stagingBufferInfo.size = imageSize;
-  stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  VkDeviceSize imageSize = image.pixels.size();
 
-  VkBuffer stagingBuffer;
-  VmaAllocation stagingBufferAlloc;
-
-  VmaAllocationCreateInfo stagingAllocInfo{};
-  stagingAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-  VkResult result = vmaCreateBuffer(renderData.rdAllocator, &stagingBufferInfo,
-                                    &stagingAllocInfo, &stagingBuffer,
-                                    &stagingBufferAlloc, nullptr);
-  if (result != VK_SUCCESS) {
-    Logger::log(1,
-                "%s error: could not allocate texture staging buffer via VMA "
-                "(error: %i)\n",
-                __FUNCTION__, result);
+  /* pixels go into the shared upload ring */
+  VkTextureStagingBuffer stagingData{};
+  if (!UploadManager::stageData(renderData, image.pixels.data(), imageSize,
+                                &stagingData.buffer, &stagingData.offset)) {
+    Logger::log(1, "%s error: could not stage texture '%s'\n", __FUNCTION__,
+                image.name.c_str());
     return false;
   }
 
-  void* uploadData;
-  result =
-      vmaMapMemory(renderData.rdAllocator, stagingBufferAlloc, &uploadData);
-  if (result != VK_SUCCESS) {
-    Logger::log(1, "%s error: could not map texture memory (error: %i)\n",
-                __FUNCTION__, result);
-    return false;
-  }
-  std::memcpy(uploadData, data, imageSize);
-  vmaUnmapMemory(renderData.rdAllocator, stagingBufferAlloc);
-  vmaFlushAllocation(renderData.rdAllocator, stagingBufferAlloc, 0, imageSize);
-
-  stbi_image_free(data);
-
-  VkTextureStagingBuffer stagingData = {stagingBuffer, stagingBufferAlloc};
-  if (!uploadToGPU(renderData, texData, &stagingData, texWidth, texHeight,
-                   generateMipmaps, mipmapLevels)) {
+  if (!uploadToGPU(renderData, texData, &stagingData, image.width,
+                   image.height, generateMipmaps, mipmapLevels)) {
     Logger::log(1, "%s error: could not load texture '%s'\n", __FUNCTION__,
-                textureName.c_str());
+                image.name.c_str());
     return false;
   }
 
   Logger::log(1, "%s: texture '%s' loaded (%dx%d, %d channels)\n", __FUNCTION__,
-              textureName.c_str(), texWidth, texHeight, numberOfChannels);
+              image.name.c_str(), image.width, image.height, image.channels);
   return true;
 }
 
-void Texture::cleanup(const VkRenderData& renderData, VkTextureData* texData) {
-  vkFreeDescriptorSets(renderData.rdVkbDevice.device,
-                       renderData.rdDescriptorPool, 1, &texData->descSet);
+void Texture::cleanup(VkRenderData& renderData, VkTextureData* texData) {
+  TextureTable::unregisterTexture(renderData, texData);
   vkDestroySampler(renderData.rdVkbDevice.device, texData->sampler, nullptr);
   vkDestroyImageView(renderData.rdVkbDevice.device, texData->view, nullptr);
   vmaDestroyImage(renderData.rdAllocator, texData->image, texData->alloc);
 }
 
-bool Texture::uploadToGPU(const VkRenderData& renderData,
+bool Texture::uploadToGPU(VkRenderData& renderData,
                           VkTextureData* texData,
                           VkTextureStagingBuffer* stagingData, uint32_t width,
                           uint32_t height, bool generateMipmaps,
                           uint32_t mipmapLevels) {
-  /* upload */
-  VkCommandBuffer uploadCommandBuffer = CommandBuffer::createTransientBuffer(
-      renderData, renderData.rdCommandPool);
+  /* upload, recorded into the current upload batch */
+  VkCommandBuffer uploadCommandBuffer =
+      UploadManager::getCommandBuffer(renderData);
+  if (uploadCommandBuffer == VK_NULL_HANDLE) {
+    return false;
+  }
 
   VkImageCreateInfo imageInfo{};
   imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -252,7 +222,7 @@ bool Texture::uploadToGPU(const VkRenderData& renderData,
   textureExtent.depth = 1;
 
   VkBufferImageCopy stagingBufferCopy{};
-  stagingBufferCopy.bufferOffset = 0;
+  stagingBufferCopy.bufferOffset = stagingData->offset;
   stagingBufferCopy.bufferRowLength = 0;
   stagingBufferCopy.bufferImageHeight = 0;
   stagingBufferCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -379,18 +349,6 @@ bool Texture::uploadToGPU(const VkRenderData& renderData,
                          0, nullptr, 1, &lastBarrier);
   }
 
-  bool commandResult = CommandBuffer::submitTransientBuffer(
-      renderData, renderData.rdCommandPool, uploadCommandBuffer,
-      renderData.rdGraphicsQueue);
-  vmaDestroyBuffer(renderData.rdAllocator, stagingData->buffer,
-                   stagingData->alloc);
-
-  if (!commandResult) {
-    Logger::log(1, "%s error: could not submit texture transfer commands\n",
-                __FUNCTION__);
-    return false;
-  }
-
   /* image view and sampler */
   VkImageViewCreateInfo texViewInfo{};
   texViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -452,36 +410,11 @@ bool Texture::uploadToGPU(const VkRenderData& renderData,
     return false;
   }
 
-  VkDescriptorSetAllocateInfo descriptorAllocateInfo{};
-  descriptorAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-  descriptorAllocateInfo.descriptorPool = renderData.rdDescriptorPool;
-  descriptorAllocateInfo.descriptorSetCount = 1;
-  descriptorAllocateInfo.pSetLayouts =
-      &renderData.rdAssimpTextureDescriptorLayout;
-
-  result = vkAllocateDescriptorSets(renderData.rdVkbDevice.device,
-                                    &descriptorAllocateInfo, &texData->descSet);
-  if (result != VK_SUCCESS) {
-    Logger::log(1, "%s error: could not allocate descriptor set (error: %i)\n",
-                __FUNCTION__, result);
+  if (!TextureTable::registerTexture(renderData, texData)) {
+    Logger::log(1, "%s error: could not add texture to the texture table\n",
+                __FUNCTION__);
     return false;
   }
 
-  VkDescriptorImageInfo descriptorImageInfo{};
-  descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  descriptorImageInfo.imageView = texData->view;
-  descriptorImageInfo.sampler = texData->sampler;
-
-  VkWriteDescriptorSet writeDescriptorSet{};
-  writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  writeDescriptorSet.dstSet = texData->descSet;
-  writeDescriptorSet.dstBinding = 0;
-  writeDescriptorSet.descriptorCount = 1;
-  writeDescriptorSet.pImageInfo = &descriptorImageInfo;
-
-  vkUpdateDescriptorSets(renderData.rdVkbDevice.device, 1, &writeDescriptorSet,
-                         0, nullptr);
-
   return true;
 }
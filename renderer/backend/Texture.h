@@ -5,30 +5,56 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "VkRenderData.h"
 
+/* region of the upload ring holding the pixels */
 struct VkTextureStagingBuffer {
   VkBuffer buffer = VK_NULL_HANDLE;
-  VmaAllocation alloc = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+};
+
+/* decoded RGBA image, does not need a Vulkan device */
+struct VkTextureImage {
+  std::string name;
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  std::vector<unsigned char> pixels{};
 };
 
 class Texture {
  public:
-  static bool loadTexture(const VkRenderData& renderData,
+  static bool loadTexture(VkRenderData& renderData,
                           VkTextureData* texData,
                           const std::string& textureFilename,
                           bool generateMipmaps = true, bool flipImage = false);
-  static bool loadTexture(const VkRenderData& renderData,
+  static bool loadTexture(VkRenderData& renderData,
                           VkTextureData* texData,
                           const std::string& textureName, aiTexel* textureData,
                           int width, int height, bool generateMipmaps = true,
                           bool flipImage = false);
+  static bool loadTexture(VkRenderData& renderData,
+                          VkTextureData* texData, const VkTextureImage& image,
+                          bool generateMipmaps = true);
+
+  /* CPU-only part of the loading, safe to call from any thread */
+  static bool decodeTexture(VkTextureImage* image,
+                            const std::string& textureFilename,
+                            bool flipImage = false);
+  static bool decodeTexture(VkTextureImage* image,
+                            const std::string& textureName,
+                            const aiTexel* textureData, int width, int height,
+                            bool flipImage = false);
 
-  static void cleanup(const VkRenderData& renderData, VkTextureData* texData);
+  static void cleanup(VkRenderData& renderData, VkTextureData* texData);
 
  private:
-  static bool uploadToGPU(const VkRenderData& renderData,
+  static void storeImage(VkTextureImage* image, const std::string& name,
+                         const unsigned char* data, int width, int height,
+                         int channels, bool flipImage);
+  static bool uploadToGPU(VkRenderData& renderData,
                           VkTextureData* texData,
                           VkTextureStagingBuffer* stagingData, uint32_t width,
                           uint32_t height, bool generateMipmaps,
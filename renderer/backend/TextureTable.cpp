@@ -0,0 +1,190 @@
+#include "TextureTable.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+
+bool TextureTable::init(VkRenderData& renderData) {
+  VkTextureTableData& textureTable = renderData.rdTextureTable;
+
+  VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+  indexingProperties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+  VkPhysicalDeviceProperties2 deviceProperties{};
+  deviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  deviceProperties.pNext = &indexingProperties;
+  vkGetPhysicalDeviceProperties2(
+      renderData.rdVkbPhysicalDevice.physical_device, &deviceProperties);
+
+  textureTable.capacity = std::min(
+      {kMaxTextures,
+       indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+       indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+       indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+       indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers});
+  textureTable.nextIndex = 0;
+  textureTable.freeIndices.clear();
+
+  VkDescriptorSetLayoutBinding textureBind{};
+  textureBind.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  textureBind.binding = 0;
+  textureBind.descriptorCount = textureTable.capacity;
+  textureBind.pImmutableSamplers = nullptr;
+  textureBind.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  /* unused entries stay empty, new textures are written while older frames
+   * still draw with the set */
+  VkDescriptorBindingFlagsEXT bindingFlags =
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+  bindingFlagsInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+  bindingFlagsInfo.bindingCount = 1;
+  bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+  VkDescriptorSetLayoutCreateInfo textureCreateInfo{};
+  textureCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  textureCreateInfo.pNext = &bindingFlagsInfo;
+  textureCreateInfo.flags =
+      VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+  textureCreateInfo.bindingCount = 1;
+  textureCreateInfo.pBindings = &textureBind;
+
+  VkResult result = vkCreateDescriptorSetLayout(
+      renderData.rdVkbDevice.device, &textureCreateInfo, nullptr,
+      &renderData.rdAssimpTextureDescriptorLayout);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not create texture table descriptor set "
+                "layout (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                textureTable.capacity};
+
+  VkDescriptorPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 1;
+  poolInfo.pPoolSizes = &poolSize;
+
+  result = vkCreateDescriptorPool(renderData.rdVkbDevice.device, &poolInfo,
+                                  nullptr, &textureTable.pool);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not create texture table descriptor pool "
+                "(error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  VkDescriptorSetAllocateInfo descriptorAllocateInfo{};
+  descriptorAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  descriptorAllocateInfo.descriptorPool = textureTable.pool;
+  descriptorAllocateInfo.descriptorSetCount = 1;
+  descriptorAllocateInfo.pSetLayouts =
+      &renderData.rdAssimpTextureDescriptorLayout;
+
+  result = vkAllocateDescriptorSets(renderData.rdVkbDevice.device,
+                                    &descriptorAllocateInfo,
+                                    &textureTable.descriptorSet);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate texture table descriptor set "
+                "(error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  Logger::log(1, "%s: texture table has %i entries\n", __FUNCTION__,
+              textureTable.capacity);
+  return true;
+}
+
+bool TextureTable::registerTexture(VkRenderData& renderData,
+                                   VkTextureData* texData) {
+  VkTextureTableData& textureTable = renderData.rdTextureTable;
+
+  uint32_t tableIndex = 0;
+  if (!textureTable.freeIndices.empty()) {
+    tableIndex = textureTable.freeIndices.back();
+    textureTable.freeIndices.pop_back();
+  } else if (textureTable.nextIndex < textureTable.capacity) {
+    tableIndex = textureTable.nextIndex++;
+  } else {
+    Logger::log(1, "%s error: texture table is full (%i entries)\n",
+                __FUNCTION__, textureTable.capacity);
+    return false;
+  }
+
+  VkDescriptorImageInfo descriptorImageInfo{};
+  descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  descriptorImageInfo.imageView = texData->view;
+  descriptorImageInfo.sampler = texData->sampler;
+
+  VkWriteDescriptorSet writeDescriptorSet{};
+  writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  writeDescriptorSet.dstSet = textureTable.descriptorSet;
+  writeDescriptorSet.dstBinding = 0;
+  writeDescriptorSet.dstArrayElement = tableIndex;
+  writeDescriptorSet.descriptorCount = 1;
+  writeDescriptorSet.pImageInfo = &descriptorImageInfo;
+
+  vkUpdateDescriptorSets(renderData.rdVkbDevice.device, 1, &writeDescriptorSet,
+                         0, nullptr);
+
+  texData->tableIndex = tableIndex;
+  return true;
+}
+
+void TextureTable::unregisterTexture(VkRenderData& renderData,
+                                     VkTextureData* texData) {
+  if (texData->tableIndex >= renderData.rdTextureTable.capacity) {
+    return;
+  }
+
+  /* the entry keeps the old descriptor, no draw reads it anymore */
+  renderData.rdTextureTable.freeIndices.emplace_back(texData->tableIndex);
+  texData->tableIndex = VkTextureData{}.tableIndex;
+}
+
+void TextureTable::bind(const VkRenderData& renderData,
+                        VkCommandBuffer commandBuffer,
+                        VkPipelineLayout pipelineLayout) {
+  /* set 0 of all model pipeline layouts, stays bound across the pipelines */
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          pipelineLayout, 0, 1,
+                          &renderData.rdTextureTable.descriptorSet, 0, nullptr);
+}
+
+uint32_t TextureTable::getUsedCount(const VkRenderData& renderData) {
+  const VkTextureTableData& textureTable = renderData.rdTextureTable;
+  return textureTable.nextIndex -
+         static_cast<uint32_t>(textureTable.freeIndices.size());
+}
+
+uint32_t TextureTable::getCapacity(const VkRenderData& renderData) {
+  return renderData.rdTextureTable.capacity;
+}
+
+void TextureTable::cleanup(VkRenderData& renderData) {
+  VkTextureTableData& textureTable = renderData.rdTextureTable;
+
+  /* destroying the pool frees the set */
+  vkDestroyDescriptorPool(renderData.rdVkbDevice.device, textureTable.pool,
+                          nullptr);
+  vkDestroyDescriptorSetLayout(renderData.rdVkbDevice.device,
+                               renderData.rdAssimpTextureDescriptorLayout,
+                               nullptr);
+
+  textureTable = VkTextureTableData{};
+  renderData.rdAssimpTextureDescriptorLayout = VK_NULL_HANDLE;
+}
@@ -0,0 +1,34 @@
+/* all textures in one descriptor array, the draws select the texture by the
+ * index in their draw data instead of binding a set per texture */
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VkRenderData.h"
+
+class TextureTable {
+ public:
+  /* creates rdAssimpTextureDescriptorLayout, the pool and the set */
+  static bool init(VkRenderData& renderData);
+
+  /* writes the texture into a free entry and stores the entry in texData.
+   * the entries are update-after-bind, frames in flight are not affected */
+  static bool registerTexture(VkRenderData& renderData,
+                              VkTextureData* texData);
+  /* the GPU must be done with the texture */
+  static void unregisterTexture(VkRenderData& renderData,
+                                VkTextureData* texData);
+
+  static void bind(const VkRenderData& renderData,
+                   VkCommandBuffer commandBuffer,
+                   VkPipelineLayout pipelineLayout);
+
+  static uint32_t getUsedCount(const VkRenderData& renderData);
+  static uint32_t getCapacity(const VkRenderData& renderData);
+
+  static void cleanup(VkRenderData& renderData);
+
+ private:
+  /* upper bound, smaller if the device limits are lower */
+  static constexpr uint32_t kMaxTextures = 4096;
+};
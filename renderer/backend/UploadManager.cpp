@@ -0,0 +1,360 @@
+#include "UploadManager.h"
+
+#include <cstring>
+#include <utility>
+
+#include "CommandBuffer.h"
+#include "Logger.h"
+
+bool UploadManager::init(VkRenderData& renderData, VkDeviceSize ringSize) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  VkBufferCreateInfo bufferInfo{};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = ringSize;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  /* stays mapped for the lifetime of the renderer */
+  VmaAllocationCreateInfo bufferAllocInfo{};
+  bufferAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+  bufferAllocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo allocInfo{};
+  VkResult result =
+      vmaCreateBuffer(renderData.rdAllocator, &bufferInfo, &bufferAllocInfo,
+                      &ring.buffer, &ring.alloc, &allocInfo);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate upload ring buffer via VMA "
+                "(error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  ring.data = static_cast<char*>(allocInfo.pMappedData);
+  ring.size = ringSize;
+  ring.head = 0;
+  ring.used = 0;
+
+  Logger::log(1, "%s: created upload ring of size %i\n", __FUNCTION__,
+              ringSize);
+  return true;
+}
+
+bool UploadManager::stageData(VkRenderData& renderData, const void* data,
+                              VkDeviceSize size, VkBuffer* stagingBuffer,
+                              VkDeviceSize* stagingOffset) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  /* will never fit, even with an empty ring */
+  if (size > ring.size) {
+    if (!createOversizedBuffer(renderData, data, size, stagingBuffer)) {
+      return false;
+    }
+    *stagingOffset = 0;
+    return true;
+  }
+
+  VkDeviceSize offset = 0;
+  VkDeviceSize padding = 0;
+  while (true) {
+    if (ring.used == 0) {
+      ring.head = 0;
+    }
+
+    offset = (ring.head + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+    padding = offset - ring.head;
+
+    /* wrap around, the tail end of the ring is wasted until retired */
+    if (offset + size > ring.size) {
+      offset = 0;
+      padding = ring.size - ring.head;
+    }
+
+    if (padding + size <= ring.size - ring.used) {
+      break;
+    }
+
+    /* ring is full, submit our own copies first, then wait for the GPU */
+    if (ring.recording.ringBytes > 0) {
+      if (!flush(renderData)) {
+        return false;
+      }
+    } else if (!ring.inFlight.empty()) {
+      if (!waitForOldestBatch(renderData)) {
+        return false;
+      }
+    } else {
+      Logger::log(1, "%s error: no upload ring space left for %i bytes\n",
+                  __FUNCTION__, size);
+      return false;
+    }
+  }
+
+  if (ring.recording.commandBuffer == VK_NULL_HANDLE) {
+    if (!beginBatch(renderData)) {
+      return false;
+    }
+  }
+
+  std::memcpy(ring.data + offset, data, size);
+  vmaFlushAllocation(renderData.rdAllocator, ring.alloc, offset, size);
+
+  ring.head = offset + size;
+  ring.used += padding + size;
+  ring.recording.ringBytes += padding + size;
+  ++ring.recording.numCopies;
+
+  *stagingBuffer = ring.buffer;
+  *stagingOffset = offset;
+  return true;
+}
+
+VkCommandBuffer UploadManager::getCommandBuffer(VkRenderData& renderData) {
+  if (renderData.rdUploadRing.recording.commandBuffer == VK_NULL_HANDLE) {
+    if (!beginBatch(renderData)) {
+      return VK_NULL_HANDLE;
+    }
+  }
+  return renderData.rdUploadRing.recording.commandBuffer;
+}
+
+bool UploadManager::uploadBuffer(VkRenderData& renderData, VkBuffer dstBuffer,
+                                 const void* data, VkDeviceSize size,
+                                 VkPipelineStageFlags dstStage,
+                                 VkAccessFlags dstAccess,
+                                 VkDeviceSize dstOffset) {
+  if (size == 0) {
+    return true;
+  }
+
+  VkBuffer stagingBuffer = VK_NULL_HANDLE;
+  VkDeviceSize stagingOffset = 0;
+  if (!stageData(renderData, data, size, &stagingBuffer, &stagingOffset)) {
+    return false;
+  }
+
+  VkCommandBuffer commandBuffer = getCommandBuffer(renderData);
+  if (commandBuffer == VK_NULL_HANDLE) {
+    return false;
+  }
+
+  VkBufferCopy stagingBufferCopy{};
+  stagingBufferCopy.srcOffset = stagingOffset;
+  stagingBufferCopy.dstOffset = dstOffset;
+  stagingBufferCopy.size = size;
+
+  VkBufferMemoryBarrier bufferBarrier{};
+  bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  bufferBarrier.dstAccessMask = dstAccess;
+  bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  bufferBarrier.buffer = dstBuffer;
+  bufferBarrier.offset = dstOffset;
+  bufferBarrier.size = size;
+
+  vkCmdCopyBuffer(commandBuffer, stagingBuffer, dstBuffer, 1,
+                  &stagingBufferCopy);
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                       0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+  return true;
+}
+
+bool UploadManager::flush(VkRenderData& renderData) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+  if (ring.recording.commandBuffer == VK_NULL_HANDLE) {
+    return true;
+  }
+
+  if (!CommandBuffer::end(ring.recording.commandBuffer)) {
+    return false;
+  }
+
+  /* same queue as the draw calls, submit order makes the copies visible */
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &ring.recording.commandBuffer;
+
+  VkResult result = vkQueueSubmit(renderData.rdGraphicsQueue, 1, &submitInfo,
+                                  ring.recording.fence);
+  if (result != VK_SUCCESS) {
+    Logger::log(1, "%s error: failed to submit upload batch (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  Logger::log(2, "%s: submitted upload batch with %i copies (%i ring bytes)\n",
+              __FUNCTION__, ring.recording.numCopies, ring.recording.ringBytes);
+
+  ring.inFlight.emplace_back(std::move(ring.recording));
+  ring.recording = VkUploadBatch{};
+  return true;
+}
+
+bool UploadManager::retire(VkRenderData& renderData, bool waitForAll) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  bool fenceResult = true;
+  size_t numRetired = 0;
+  for (auto& batch : ring.inFlight) {
+    VkResult result = VK_SUCCESS;
+    if (waitForAll) {
+      result = vkWaitForFences(renderData.rdVkbDevice.device, 1, &batch.fence,
+                               VK_TRUE, UINT64_MAX);
+    } else {
+      result = vkGetFenceStatus(renderData.rdVkbDevice.device, batch.fence);
+    }
+
+    /* batches finish in submit order, stop at the first pending one */
+    if (result == VK_NOT_READY) {
+      break;
+    }
+    if (result != VK_SUCCESS) {
+      Logger::log(1, "%s error: upload fence failed (error: %i)\n",
+                  __FUNCTION__, result);
+      fenceResult = false;
+      break;
+    }
+
+    ring.used -= batch.ringBytes;
+    for (size_t i = 0; i < batch.oversizedBuffers.size(); ++i) {
+      vmaDestroyBuffer(renderData.rdAllocator, batch.oversizedBuffers.at(i),
+                       batch.oversizedAllocs.at(i));
+    }
+
+    vkResetFences(renderData.rdVkbDevice.device, 1, &batch.fence);
+    CommandBuffer::reset(batch.commandBuffer);
+
+    VkUploadBatch freeBatch{};
+    freeBatch.commandBuffer = batch.commandBuffer;
+    freeBatch.fence = batch.fence;
+    ring.freeBatches.emplace_back(freeBatch);
+    ++numRetired;
+  }
+
+  ring.inFlight.erase(ring.inFlight.begin(),
+                      ring.inFlight.begin() + numRetired);
+  return fenceResult;
+}
+
+void UploadManager::cleanup(VkRenderData& renderData) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  flush(renderData);
+  retire(renderData, true);
+
+  for (auto& batch : ring.freeBatches) {
+    vkDestroyFence(renderData.rdVkbDevice.device, batch.fence, nullptr);
+    CommandBuffer::cleanup(renderData, renderData.rdCommandPool,
+                           &batch.commandBuffer);
+  }
+
+  vmaDestroyBuffer(renderData.rdAllocator, ring.buffer, ring.alloc);
+  ring = VkUploadRingData{};
+}
+
+bool UploadManager::beginBatch(VkRenderData& renderData) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  VkUploadBatch batch{};
+  if (!ring.freeBatches.empty()) {
+    batch = ring.freeBatches.back();
+    ring.freeBatches.pop_back();
+  } else {
+    if (!CommandBuffer::init(renderData, renderData.rdCommandPool,
+                             &batch.commandBuffer)) {
+      Logger::log(1, "%s error: could not create upload command buffer\n",
+                  __FUNCTION__);
+      return false;
+    }
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VkResult result = vkCreateFence(renderData.rdVkbDevice.device, &fenceInfo,
+                                    nullptr, &batch.fence);
+    if (result != VK_SUCCESS) {
+      Logger::log(1, "%s error: could not create upload fence (error: %i)\n",
+                  __FUNCTION__, result);
+      CommandBuffer::cleanup(renderData, renderData.rdCommandPool,
+                             &batch.commandBuffer);
+      return false;
+    }
+  }
+
+  if (!CommandBuffer::beginTransient(batch.commandBuffer)) {
+    ring.freeBatches.emplace_back(batch);
+    return false;
+  }
+
+  ring.recording = batch;
+  return true;
+}
+
+bool UploadManager::waitForOldestBatch(VkRenderData& renderData) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  VkResult result = vkWaitForFences(renderData.rdVkbDevice.device, 1,
+                                    &ring.inFlight.front().fence, VK_TRUE,
+                                    UINT64_MAX);
+  if (result != VK_SUCCESS) {
+    Logger::log(1, "%s error: waiting for upload fence failed (error: %i)\n",
+                __FUNCTION__, result);
+    return false;
+  }
+
+  return retire(renderData);
+}
+
+bool UploadManager::createOversizedBuffer(VkRenderData& renderData,
+                                          const void* data, VkDeviceSize size,
+                                          VkBuffer* stagingBuffer) {
+  VkUploadRingData& ring = renderData.rdUploadRing;
+
+  if (ring.recording.commandBuffer == VK_NULL_HANDLE) {
+    if (!beginBatch(renderData)) {
+      return false;
+    }
+  }
+
+  VkBufferCreateInfo bufferInfo{};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = size;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo bufferAllocInfo{};
+  bufferAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+  bufferAllocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VmaAllocation alloc = VK_NULL_HANDLE;
+  VmaAllocationInfo allocInfo{};
+  VkResult result = vmaCreateBuffer(renderData.rdAllocator, &bufferInfo,
+                                    &bufferAllocInfo, &buffer, &alloc,
+                                    &allocInfo);
+  if (result != VK_SUCCESS) {
+    Logger::log(1,
+                "%s error: could not allocate staging buffer of %i bytes via "
+                "VMA (error: %i)\n",
+                __FUNCTION__, size, result);
+    return false;
+  }
+
+  std::memcpy(allocInfo.pMappedData, data, size);
+  vmaFlushAllocation(renderData.rdAllocator, alloc, 0, size);
+
+  /* freed together with the batch */
+  ring.recording.oversizedBuffers.emplace_back(buffer);
+  ring.recording.oversizedAllocs.emplace_back(alloc);
+  ++ring.recording.numCopies;
+
+  Logger::log(1, "%s: upload of %i bytes exceeds the ring, using a dedicated "
+              "staging buffer\n", __FUNCTION__, size);
+
+  *stagingBuffer = buffer;
+  return true;
+}
@@ -0,0 +1,42 @@
+/* batched uploads through a persistently mapped staging ring */
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VkRenderData.h"
+
+class UploadManager {
+ public:
+  static bool init(VkRenderData& renderData, VkDeviceSize ringSize);
+
+  /* copies the data into the ring and returns the source for a copy command,
+   * must be called BEFORE getCommandBuffer() as it may submit the batch */
+  static bool stageData(VkRenderData& renderData, const void* data,
+                        VkDeviceSize size, VkBuffer* stagingBuffer,
+                        VkDeviceSize* stagingOffset);
+  /* command buffer of the open batch, starts a new batch if needed */
+  static VkCommandBuffer getCommandBuffer(VkRenderData& renderData);
+
+  /* stages the data and records the copy plus a barrier for the consumer */
+  static bool uploadBuffer(VkRenderData& renderData, VkBuffer dstBuffer,
+                           const void* data, VkDeviceSize size,
+                           VkPipelineStageFlags dstStage,
+                           VkAccessFlags dstAccess,
+                           VkDeviceSize dstOffset = 0);
+
+  /* submits the open batch without waiting for it */
+  static bool flush(VkRenderData& renderData);
+  /* releases the ring memory of all finished batches */
+  static bool retire(VkRenderData& renderData, bool waitForAll = false);
+
+  static void cleanup(VkRenderData& renderData);
+
+ private:
+  static constexpr VkDeviceSize kStagingAlignment = 16;
+
+  static bool beginBatch(VkRenderData& renderData);
+  static bool waitForOldestBatch(VkRenderData& renderData);
+  static bool createOversizedBuffer(VkRenderData& renderData,
+                                    const void* data, VkDeviceSize size,
+                                    VkBuffer* stagingBuffer);
+};
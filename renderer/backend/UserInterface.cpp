@@ -14,15 +14,18 @@
 #include <limits>
 #include <string>
 
+#include "AnimBatchSampler.h"
 #include "AssimpAnimClip.h"
 #include "AssimpInstance.h"
 #include "AssimpModel.h"
 #include "AssimpSettingsContainer.h"
 #include "Camera.h"
 #include "CommandBuffer.h"
+#include "GeometryArena.h"
 #include "ImGuizmo.h"
 #include "InstanceSettings.h"
 #include "Logger.h"
+#include "TextureTable.h"
 
 bool UserInterface::init(VkRenderData& renderData) {
   IMGUI_CHECKVERSION();
@@ -223,6 +226,42 @@ void UserInterface::createFrame(VkRenderData& renderData,
 
   if (ImGui::CollapsingHeader("Info")) {
     ImGui::Text("Triangles:              %10i", renderData.rdTriangleCount);
+    ImGui::Text("Visible Instances:      %10i",
+                static_cast<int>(renderData.rdVisibleInstances));
+    ImGui::Text("Culled Instances:       %10i",
+                static_cast<int>(renderData.rdCulledInstances));
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Frustum Culling:");
+    ImGui::SameLine();
+    int cullingModeIndex = static_cast<int>(renderData.rdCullingMode);
+    if (ImGui::BeginCombo("##CullingModeCombo",
+                          mCullingModeNames.at(cullingModeIndex).c_str())) {
+      for (int i = 0; i < mCullingModeNames.size(); ++i) {
+        const bool isSelected = (cullingModeIndex == i);
+        if (ImGui::Selectable(mCullingModeNames.at(i).c_str(), isSelected)) {
+          renderData.rdCullingMode = static_cast<cullingMode>(i);
+        }
+
+        if (isSelected) {
+          ImGui::SetItemDefaultFocus();
+        }
+      }
+      ImGui::EndCombo();
+    }
+
+    if (!renderData.rdMultiDrawIndirectSupported) {
+      ImGui::BeginDisabled();
+    }
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Multi Draw Indirect:");
+    ImGui::SameLine();
+    ImGui::Checkbox("##MultiDrawIndirect", &renderData.rdUseMultiDrawIndirect);
+    if (!renderData.rdMultiDrawIndirectSupported) {
+      ImGui::EndDisabled();
+    }
+    ImGui::Text("Draw Calls:             %10i",
+                static_cast<int>(renderData.rdDrawCallCount));
 
     std::string unit = "B";
     float memoryUsage = renderData.rdMatricesSize;
@@ -237,6 +276,24 @@ void UserInterface::createFrame(VkRenderData& renderData,
 
     ImGui::Text("Instance Matrix Size:  %8.2f %2s", memoryUsage, unit.c_str());
 
+    std::string arenaUnit = "B";
+    float arenaUsage = GeometryArena::getUsedSize(renderData);
+    float arenaCapacity = GeometryArena::getCapacity(renderData);
+    if (arenaCapacity > 1024.0f * 1024.0f) {
+      arenaUsage /= 1024.0f * 1024.0f;
+      arenaCapacity /= 1024.0f * 1024.0f;
+      arenaUnit = "MB";
+    } else if (arenaCapacity > 1024.0f) {
+      arenaUsage /= 1024.0f;
+      arenaCapacity /= 1024.0f;
+      arenaUnit = "KB";
+    }
+    ImGui::Text("Geometry Arena:        %8.2f / %.2f %2s", arenaUsage,
+                arenaCapacity, arenaUnit.c_str());
+    ImGui::Text("Texture Table:          %6i / %i",
+                TextureTable::getUsedCount(renderData),
+                TextureTable::getCapacity(renderData));
+
     std::string windowDims = std::to_string(renderData.rdWidth) + "x" +
                              std::to_string(renderData.rdHeight);
     ImGui::Text("Window Dimensions:      %10s", windowDims.c_str());
@@ -317,6 +374,20 @@ void UserInterface::createFrame(VkRenderData& renderData,
       ImGui::EndTooltip();
     }
 
+    if (ImGui::TreeNode("Animation Workers")) {
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Workers:");
+      ImGui::SameLine();
+      ImGui::SliderInt("##AnimationWorkers", &renderData.rdNumAnimationWorkers,
+                       1, renderData.rdMaxAnimationWorkers);
+
+      for (size_t i = 0; i < renderData.rdAnimationWorkerTimes.size(); ++i) {
+        ImGui::Text("Worker %2i:            %10.4f ms", static_cast<int>(i),
+                    renderData.rdAnimationWorkerTimes.at(i));
+      }
+      ImGui::TreePop();
+    }
+
     float totalMatrixUploadTime =
         renderData.rdUploadToUBOTime + renderData.rdUploadToSSBOTime;
 
@@ -342,6 +413,9 @@ void UserInterface::createFrame(VkRenderData& renderData,
       ImGui::EndTooltip();
     }
 
+    ImGui::Text("Skinning Compute (GPU): %10.4f ms",
+                renderData.rdSkinningComputeTime);
+
     ImGui::Text("UI Generation Time:     %10.4f ms",
                 renderData.rdUIGenerateTime);
 
@@ -385,6 +459,24 @@ void UserInterface::createFrame(VkRenderData& renderData,
                        std::numeric_limits<float>::max(), ImVec2(0, 80));
       ImGui::EndTooltip();
     }
+
+    ImGui::Text("Model Record Time:      %10.4f ms", renderData.rdRecordTime);
+
+    if (ImGui::TreeNode("Record Workers")) {
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Parallel Recording:");
+      ImGui::SameLine();
+      ImGui::Checkbox("##ParallelRecording",
+                      &renderData.rdUseParallelRecording);
+      ImGui::Text("Record Jobs:            %10i",
+                  static_cast<int>(renderData.rdRecordJobCount));
+
+      for (size_t i = 0; i < renderData.rdRecordWorkerTimes.size(); ++i) {
+        ImGui::Text("Worker %2i:            %10.4f ms", static_cast<int>(i),
+                    renderData.rdRecordWorkerTimes.at(i));
+      }
+      ImGui::TreePop();
+    }
   }
 
   if (ImGui::CollapsingHeader("Camera")) {
@@ -473,20 +565,21 @@ void UserInterface::createFrame(VkRenderData& renderData,
          * preferres backslashes... */
         std::replace(filePathName.begin(), filePathName.end(), '\\', '/');
 
+        /* the renderer selects the model once the loading has finished */
         if (!modInstData.miModelAddCallbackFunction(filePathName)) {
           Logger::log(
               1, "%s error: unable to load model file '%s', unknown error \n",
               __FUNCTION__, filePathName.c_str());
-        } else {
-          /* select new model and new instance */
-          modInstData.miSelectedModel = modInstData.miModelList.size() - 1;
-          modInstData.miSelectedInstance =
-              modInstData.miAssimpInstances.size() - 1;
         }
       }
       ImGuiFileDialog::Instance()->Close();
     }
 
+    for (const auto& loadProgress : modInstData.miModelLoadProgress) {
+      ImGui::Text("Loading '%s'", loadProgress.modelFileName.c_str());
+      ImGui::ProgressBar(loadProgress.progress, ImVec2(300, 0));
+    }
+
     if (modelListEmtpy) {
       ImGui::BeginDisabled();
     }
@@ -556,6 +649,40 @@ void UserInterface::createFrame(VkRenderData& renderData,
     if (modelListEmtpy) {
       ImGui::EndDisabled();
     }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Packed Vertices (new models):");
+    ImGui::SameLine();
+    ImGui::Checkbox("##PackedVertices", &renderData.rdUsePackedVertices);
+
+    /* dual quaternions drop the bone scale, so only enable it per model */
+    if (!modelListEmtpy) {
+      std::shared_ptr<AssimpModel> selectedModel =
+          modInstData.miModelList.at(modInstData.miSelectedModel);
+
+      std::string vertexUnit = "B";
+      float vertexBufferSize = selectedModel->getVertexBufferSize();
+      if (vertexBufferSize > 1024.0f * 1024.0f) {
+        vertexBufferSize /= 1024.0f * 1024.0f;
+        vertexUnit = "MB";
+      } else if (vertexBufferSize > 1024.0f) {
+        vertexBufferSize /= 1024.0f;
+        vertexUnit = "KB";
+      }
+      ImGui::Text("Vertex Buffers:        %8.2f %2s (%s)", vertexBufferSize,
+                  vertexUnit.c_str(),
+                  selectedModel->usesPackedVertices() ? "packed" : "full");
+
+      if (selectedModel->hasAnimations()) {
+        bool dualQuatSkinning = selectedModel->getDualQuatSkinning();
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Dual Quaternion Skinning:");
+        ImGui::SameLine();
+        if (ImGui::Checkbox("##DualQuatSkinning", &dualQuatSkinning)) {
+          selectedModel->setDualQuatSkinning(dualQuatSkinning);
+        }
+      }
+    }
   }
 
   if (ImGui::CollapsingHeader("Instances")) {
@@ -764,6 +891,59 @@ void UserInterface::createFrame(VkRenderData& renderData,
   if (ImGui::CollapsingHeader("Animations")) {
     size_t numberOfInstances = modInstData.miAssimpInstances.size() - 1;
 
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Batch Sampling (%s):", AnimBatchSampler::getInstructionSetName());
+    ImGui::SameLine();
+    ImGui::Checkbox("##BatchAnimSampling", &renderData.rdUseBatchAnimSampling);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Fused Skinning Compute:");
+    ImGui::SameLine();
+    ImGui::Checkbox("##FusedSkinningCompute",
+                    &renderData.rdUseFusedSkinningCompute);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("GPU Keyframe Sampling:");
+    ImGui::SameLine();
+    ImGui::Checkbox("##GpuAnimSampling", &renderData.rdUseGpuAnimSampling);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Baked Animations:");
+    ImGui::SameLine();
+    ImGui::Checkbox("##BakedAnimations", &renderData.rdUseBakedAnimations);
+
+    std::string bakedUnit = "B";
+    float bakedMemoryUsage = renderData.rdBakedAnimationSize;
+    if (bakedMemoryUsage > 1024.0f * 1024.0f) {
+      bakedMemoryUsage /= 1024.0f * 1024.0f;
+      bakedUnit = "MB";
+    } else if (bakedMemoryUsage > 1024.0f) {
+      bakedMemoryUsage /= 1024.0f;
+      bakedUnit = "KB";
+    }
+    ImGui::Text("Baked Pose Size:       %8.2f %2s", bakedMemoryUsage,
+                bakedUnit.c_str());
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Animation LOD:");
+    ImGui::SameLine();
+    ImGui::Checkbox("##AnimLod", &renderData.rdEnableAnimLod);
+
+    if (ImGui::TreeNode("Animation LOD Levels")) {
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Min. Height (px):");
+      ImGui::SameLine();
+      ImGui::SliderFloat3("##AnimLodScreenSizes",
+                          renderData.rdAnimLodScreenSizes, 1.0f, 500.0f,
+                          "%.0f");
+
+      for (int i = 0; i < 4; ++i) {
+        ImGui::Text("Every %i. frame:        %10i", 1 << i,
+                    static_cast<int>(renderData.rdAnimLodInstances[i]));
+      }
+      ImGui::TreePop();
+    }
+
     InstanceSettings settings;
     size_t numberOfClips = 0;
     if (numberOfInstances > 0) {
@@ -778,7 +958,7 @@ void UserInterface::createFrame(VkRenderData& renderData,
     }
 
     if (numberOfInstances > 0 && numberOfClips > 0) {
-      std::vector<std::shared_ptr<AssimpAnimClip>> animClips =
+      const std::vector<std::shared_ptr<AssimpAnimClip>>& animClips =
           modInstData.miAssimpInstances.at(modInstData.miSelectedInstance)
               ->getModel()
               ->getAnimClips();
@@ -906,10 +1086,9 @@ void UserInterface::createFrame(VkRenderData& renderData,
   ImGui::End();
 }
 
-void UserInterface::render(VkRenderData& renderData) {
+void UserInterface::render(VkCommandBuffer commandBuffer) {
   ImGui::Render();
-  ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(),
-                                  renderData.rdCommandBuffer);
+  ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
 }
 
 void UserInterface::cleanup(VkRenderData& renderData) {
@@ -1,6 +1,9 @@
 /* Dear ImGui */
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "AssimpInstance.h"
 #include "InstanceSettings.h"
 #include "ModelAndInstanceData.h"
@@ -13,7 +16,8 @@ class UserInterface {
 
   void createFrame(VkRenderData& renderData, ModelAndInstanceData& modInstData,
                    class Camera* cam);
-  void render(VkRenderData& renderData);
+  /* records into a secondary command buffer of the render pass */
+  void render(VkCommandBuffer commandBuffer);
 
   void cleanup(VkRenderData& renderData);
 
@@ -54,6 +58,9 @@ class UserInterface {
   int mUiGenOffset = 0;
   int mUiDrawOffset = 0;
 
+  /* same order as the cullingMode enum */
+  std::vector<std::string> mCullingModeNames = {"Off", "CPU", "GPU"};
+
   int mManyInstanceCreateNum = 1;
   int mManyInstanceCloneNum = 1;
 
@@ -13,12 +13,16 @@ class VertexBuffer {
                    VkVertexBufferData* vertexBufferData,
                    VkDeviceSize bufferSize);
 
-  static bool uploadData(const VkRenderData& renderData,
+  /* the copies are submitted with the next UploadManager::flush() */
+  static bool uploadData(VkRenderData& renderData,
                          VkVertexBufferData* vertexBufferData,
                          const VkMesh& vertexData);
-  static bool uploadData(const VkRenderData& renderData,
+  static bool uploadData(VkRenderData& renderData,
                          VkVertexBufferData* vertexBufferData,
                          const std::vector<glm::vec3>& vetrexData);
+  static bool uploadData(VkRenderData& renderData,
+                         VkVertexBufferData* vertexBufferData,
+                         const std::vector<VkPackedVertex>& vertexData);
 
   static void cleanup(const VkRenderData& renderData,
                       VkVertexBufferData* vertexBufferData);
@@ -15,11 +15,9 @@
 
 #include <assimp/material.h>
 
-struct NodeTransformData {
-	glm::vec4 translation{0.f};
-	glm::vec4 scale{1.f};
-	glm::vec4 rotation{1.f, 0.f, 0.f, 0.f};
-};
+#include "DrawRecord.h"
+#include "NodeTransformData.h"
+#include "RangeAllocator.h"
 
 struct VkVertex {
 	glm::vec4 position{};
@@ -29,11 +27,29 @@ struct VkVertex {
 	glm::vec4 boneWeights{};
 };
 
+/* quantized vertex, 24 bytes instead of 80. the position is relative to the
+ * mesh bounds, the normal is octahedral encoded and the texture coordinates
+ * are half floats. the color is the same for all vertices of the mesh */
+struct VkPackedVertex {
+	int16_t position[4]{};
+	int16_t normal[2]{};
+	uint16_t texCoord[2]{};
+	uint8_t boneNum[4]{};
+	uint8_t boneWeights[4]{};
+};
+
 struct VkMesh {
 	std::vector<VkVertex> vertices{};
 	std::vector<uint32_t> indices{};
 	std::unordered_map<aiTextureType, std::string> textures{};
 	bool usesPBRColors = false;
+
+	/* empty if the mesh has vertex colors or more than 256 bones */
+	std::vector<VkPackedVertex> packedVertices{};
+	/* position = packed position * scale + offset */
+	glm::vec4 packedPositionScale{1.f};
+	glm::vec4 packedPositionOffset{0.f};
+	glm::vec4 packedColor{1.f};
 };
 
 struct VkUploadMatrices {
@@ -43,13 +59,41 @@ struct VkUploadMatrices {
 
 enum class appMode : uint8_t { edit = 0, view };
 
+/* cpu culling also skips the animation of invisible instances */
+enum class cullingMode : uint8_t { none = 0, cpu, gpu };
+
+/* graphics pipelines of the models, every full vertex pipeline is followed
+ * by its packed vertex variant. the draws are recorded in this order */
+enum class drawPipeline : uint8_t {
+	assimp = 0,
+	assimpPacked,
+	skinning,
+	skinningPacked,
+	skinningDualQuat,
+	skinningDualQuatPacked,
+	skinningBaked,
+	skinningBakedPacked,
+	NUM
+};
+
 struct VkTextureData {
 	VkImage image = VK_NULL_HANDLE;
 	VkImageView view = VK_NULL_HANDLE;
 	VkSampler sampler = VK_NULL_HANDLE;
 	VmaAllocation alloc = VK_NULL_HANDLE;
 
-	VkDescriptorSet descSet = VK_NULL_HANDLE;
+	/* entry in the texture table, the shaders select the texture by it */
+	uint32_t tableIndex = 0xffffffff;
+};
+
+/* one descriptor array for the textures of all models, bound once per
+ * frame. freed entries are reused */
+struct VkTextureTableData {
+	uint32_t capacity = 0;
+	uint32_t nextIndex = 0;
+	std::vector<uint32_t> freeIndices{};
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
 };
 
 struct VkVertexBufferData {
@@ -57,16 +101,78 @@ struct VkVertexBufferData {
 	void* data = nullptr;
 	VkBuffer buffer = VK_NULL_HANDLE;
 	VmaAllocation alloc = VK_NULL_HANDLE;
-	VkBuffer staging = VK_NULL_HANDLE;
-	VmaAllocation stagingAlloc = VK_NULL_HANDLE;
 };
 
 struct VkIndexBufferData {
 	VkDeviceSize size = 0;
 	VkBuffer buffer = VK_NULL_HANDLE;
 	VmaAllocation alloc = nullptr;
-	VkBuffer staging = VK_NULL_HANDLE;
-	VmaAllocation stagingAlloc = nullptr;
+};
+
+/* one device local buffer shared by all models, the allocator works in
+ * elements, so the offsets can be used as vertexOffset and firstIndex */
+struct VkArenaBufferData {
+	VkDeviceSize elementSize = 0;
+	uint64_t minCapacity = 0;
+	VkBufferUsageFlags usage = 0;
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VmaAllocation alloc = VK_NULL_HANDLE;
+	RangeAllocator allocator{};
+};
+
+/* full and packed vertices differ in stride, each needs its own buffer */
+struct VkGeometryArenaData {
+	VkArenaBufferData vertices{};
+	VkArenaBufferData packedVertices{};
+	VkArenaBufferData indices{};
+	/* counts the reallocations, offsets cached before a change are stale */
+	uint32_t generation = 0;
+};
+
+/* arena ranges of a mesh */
+struct VkMeshRanges {
+	bool packedVertices = false;
+	uint32_t vertexRange = RangeAllocator::kInvalidRange;
+	uint32_t indexRange = RangeAllocator::kInvalidRange;
+};
+
+/* one submit of the upload manager, recycled once the fence signals */
+struct VkUploadBatch {
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkFence fence = VK_NULL_HANDLE;
+	uint32_t numCopies = 0;
+
+	/* ring bytes freed on retire, including alignment and wrap padding */
+	VkDeviceSize ringBytes = 0;
+
+	/* dedicated staging buffers for uploads larger than the ring */
+	std::vector<VkBuffer> oversizedBuffers{};
+	std::vector<VmaAllocation> oversizedAllocs{};
+};
+
+/* secondary command buffers of one worker in one frame slot, the pool is
+ * reset as a whole when the slot comes back */
+struct VkRecordPoolData {
+	VkCommandPool pool = VK_NULL_HANDLE;
+	std::vector<VkCommandBuffer> commandBuffers{};
+	size_t usedBuffers = 0;
+};
+
+struct VkUploadRingData {
+	VkDeviceSize size = 0;
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VmaAllocation alloc = VK_NULL_HANDLE;
+	char* data = nullptr;
+
+	/* write position and number of bytes not yet retired */
+	VkDeviceSize head = 0;
+	VkDeviceSize used = 0;
+
+	/* batch recording right now, commandBuffer is null if none is open */
+	VkUploadBatch recording{};
+	/* submitted batches in submit order, retired from the front */
+	std::vector<VkUploadBatch> inFlight{};
+	std::vector<VkUploadBatch> freeBatches{};
 };
 
 struct VkUniformBufferData {
@@ -85,14 +191,102 @@ struct VkShaderStorageBufferData {
 	VkDescriptorSet descSet = VK_NULL_HANDLE;
 };
 
+/* persistently mapped buffer with one slice per frame in flight, the slice
+ * is selected with a dynamic offset when binding the descriptor set */
+struct VkFrameRingBufferData {
+	VkDeviceSize frameSize = 0;
+	VkDeviceSize alignment = 0;
+	uint32_t numFrames = 0;
+	VkBufferUsageFlags usage = 0;
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VmaAllocation alloc = VK_NULL_HANDLE;
+	char* data = nullptr;
+
+	/* slice written in the current frame */
+	uint32_t frame = 0;
+};
+
+/* host visible copy of the selection image region around the cursor */
+struct VkSelectionReadbackData {
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VmaAllocation alloc = VK_NULL_HANDLE;
+	int* data = nullptr;
+
+	/* cursor position inside the copied region */
+	glm::uvec2 regionPos{};
+	uint32_t regionWidth = 0;
+
+	/* copy recorded, valid once the fence of the frame has signaled */
+	bool pending = false;
+};
+
+/* the draw data of a multi draw starts here, gl_DrawID counts from it */
 struct VkPushConstants {
-	uint32_t pkModelStride;
-	uint32_t pkWorldPosOffset;
-	uint32_t pkSkinMatOffset;
+	uint32_t pkDrawDataOffset;
+};
+
+/* consecutive draw commands of one pipeline with the same model set,
+ * recorded as a single multi draw */
+struct VkDrawBatch {
+	uint32_t firstCommand = 0;
+	uint32_t commandCount = 0;
+	/* per model set of the baked animations, null for all other models */
+	VkDescriptorSet modelSet = VK_NULL_HANDLE;
 };
 
 struct VkComputePushConstants {
 	uint32_t pkModelOffset;
+	/* only read by the fused shader, the others use the work group count */
+	uint32_t pkBoneCount;
+	/* start of the model in the bone palette, counted in vec4 */
+	uint32_t pkPaletteOffset;
+	/* write two vec4 per bone instead of a mat4 */
+	uint32_t pkDualQuatPalette;
+};
+
+/* keyframe sampling compute shader */
+struct VkAnimSamplingPushConstants {
+	uint32_t pkModelOffset;
+	uint32_t pkBoneCount;
+	uint32_t pkInstanceOffset;
+	uint32_t pkInstanceCount;
+};
+
+/* the only per-instance animation upload if the poses are sampled on the GPU */
+struct VkAnimInstanceData {
+	uint32_t clipNr = 0;
+	float playTime = 0.0f;
+};
+
+/* baked animations, the skinning shader blends two frames of final bone
+ * matrices. the offsets count matrices in the baked buffer of the model */
+struct VkBakedInstanceData {
+	uint32_t frameOffset = 0;
+	uint32_t nextFrameOffset = 0;
+	float blend = 0.0f;
+	uint32_t padding = 0;
+};
+
+/* frustum culling compute shader, planes are normalized, facing inwards */
+struct VkCullPushConstants {
+	glm::vec4 pkFrustumPlanes[6];
+	uint32_t pkInstanceCount;
+	uint32_t pkCullingEnabled;
+};
+
+struct VkCullInstanceData {
+	/* xyz is the center in model space, w the radius */
+	glm::vec4 boundingSphere{};
+	uint32_t firstCommand = 0;
+	uint32_t commandCount = 0;
+	uint32_t worldPosOffset = 0;
+	uint32_t instanceIndex = 0;
+};
+
+/* in front of the indirect draw commands, written by the culling shader */
+struct VkIndirectDrawHeader {
+	uint32_t visibleInstances = 0;
+	uint32_t padding[3]{};
 };
 
 struct VkRenderData {
@@ -113,12 +307,62 @@ struct VkRenderData {
 	float rdUploadToUBOTime = 0.0f;
 	float rdUIGenerateTime = 0.0f;
 	float rdUIDrawTime = 0.0f;
+	/* GPU time of the skinning matrix dispatches, from timestamp queries */
+	float rdSkinningComputeTime = 0.0f;
+
+	/* sample crowds of the same model with the SIMD batch sampler */
+	bool rdUseBatchAnimSampling = true;
+
+	/* build the skinning matrices in one compute pass per model */
+	bool rdUseFusedSkinningCompute = true;
+
+	/* sample the clips in a compute shader, only clip and time are uploaded */
+	bool rdUseGpuAnimSampling = false;
+
+	/* blend pre-sampled poses in the vertex shader, no sampling or compute */
+	bool rdUseBakedAnimations = false;
+	size_t rdBakedAnimationSize = 0;
+
+	/* upload the quantized vertices of models loaded afterwards */
+	bool rdUsePackedVertices = true;
+
+	/* one indirect call per draw batch instead of one per mesh, needs the
+	 * multiDrawIndirect feature */
+	bool rdUseMultiDrawIndirect = true;
+	bool rdMultiDrawIndirectSupported = false;
+	size_t rdDrawCallCount = 0;
+
+	/* animation update job system, zero workers means one per core */
+	int rdNumAnimationWorkers = 0;
+	int rdMaxAnimationWorkers = 1;
+	std::vector<float> rdAnimationWorkerTimes{};
+
+	/* record the model draws into secondary command buffers on the workers
+	 * of the animation job system, one job per few models */
+	bool rdUseParallelRecording = true;
+	size_t rdRecordJobCount = 0;
+	float rdRecordTime = 0.0f;
+	std::vector<float> rdRecordWorkerTimes{};
+
+	/* instances tested against the view frustum */
+	cullingMode rdCullingMode = cullingMode::cpu;
+	size_t rdVisibleInstances = 0;
+	size_t rdCulledInstances = 0;
+
+	/* animation LOD, instances below these projected heights in pixels
+	 * sample a new pose only every 2nd, 4th or 8th frame */
+	bool rdEnableAnimLod = true;
+	float rdAnimLodScreenSizes[3] = {150.0f, 75.0f, 30.0f};
+	size_t rdAnimLodInstances[4] = {};
 
 	bool rdHighlightSelectedInstance = true;
 	float rdUnselectedInstanceToneDownValue = 1.0f;
 
 	appMode rdApplicationMode = appMode::edit;
 
+	/* index of the per-frame resources used in this frame */
+	uint32_t rdCurrentFrame = 0;
+
 	/* Vulkan specific stuff */
 	VmaAllocator rdAllocator = nullptr;
 
@@ -146,38 +390,56 @@ struct VkRenderData {
 	VkFormat rdSelectionFormat = VK_FORMAT_UNDEFINED;
 	VmaAllocation rdSelectionImageAlloc = VK_NULL_HANDLE;
 
-	VkImage rdLocalSelectionImage = VK_NULL_HANDLE;
-  VkImageView rdLocalSelectionImageView = VK_NULL_HANDLE;
-  VkFormat rdLocalSelectionFormat = VK_FORMAT_UNDEFINED;
-  VmaAllocation rdLocalSelectionImageAlloc = VK_NULL_HANDLE;
-
 	VkRenderPass rdRenderpass = VK_NULL_HANDLE;
 	VkRenderPass rdSelectionRenderpass = VK_NULL_HANDLE;
 
 	VkPipelineLayout rdAssimpPipelineLayout = VK_NULL_HANDLE;
 	VkPipelineLayout rdAssimpSkinningPipelineLayout = VK_NULL_HANDLE;
+	VkPipelineLayout rdAssimpSkinningBakedPipelineLayout = VK_NULL_HANDLE;
 	VkPipelineLayout rdAssimpComputeTransformaPipelineLayout = VK_NULL_HANDLE;
 	VkPipelineLayout rdAssimpComputeMatrixMultPipelineLayout = VK_NULL_HANDLE;
+	VkPipelineLayout rdAssimpComputeCullPipelineLayout = VK_NULL_HANDLE;
+	VkPipelineLayout rdAssimpComputeFusedPipelineLayout = VK_NULL_HANDLE;
+	VkPipelineLayout rdAssimpComputeAnimSamplePipelineLayout = VK_NULL_HANDLE;
 
 	VkPipeline rdAssimpPipeline = VK_NULL_HANDLE;
 	VkPipeline rdAssimpSkinningPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpSkinningBakedPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpSkinningDualQuatPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpPackedPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpSkinningPackedPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpSkinningBakedPackedPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpSkinningDualQuatPackedPipeline = VK_NULL_HANDLE;
 	VkPipeline rdAssimpComputeTransformPipeline = VK_NULL_HANDLE;
 	VkPipeline rdAssimpComputeMatrixMultPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpComputeCullPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpComputeFusedPipeline = VK_NULL_HANDLE;
+	VkPipeline rdAssimpComputeAnimSamplePipeline = VK_NULL_HANDLE;
 
 	VkCommandPool rdCommandPool = VK_NULL_HANDLE;
 	VkCommandPool rdComputeCommandPool = VK_NULL_HANDLE;
+	/* command buffers of the frame recorded right now */
 	VkCommandBuffer rdCommandBuffer = VK_NULL_HANDLE;
 	VkCommandBuffer rdComputeCommandBuffer = VK_NULL_HANDLE;
-
-	VkSemaphore rdPresentSemaphore = VK_NULL_HANDLE;
-	VkSemaphore rdRenderSemaphore = VK_NULL_HANDLE;
+	std::vector<VkCommandBuffer> rdCommandBuffers{};
+	std::vector<VkCommandBuffer> rdComputeCommandBuffers{};
+	/* per frame slot and worker, only the thread of the worker uses a pool */
+	std::vector<std::vector<VkRecordPoolData>> rdRecordPools{};
+
+	/* per frame in flight */
+	std::vector<VkSemaphore> rdPresentSemaphores{};
+	std::vector<VkFence> rdRenderFences{};
+	std::vector<VkFence> rdComputeFences{};
+	/* per swapchain image, presentation may hold it longer than one frame */
+	std::vector<VkSemaphore> rdRenderSemaphores{};
+	/* compute and graphics submits alternate, so one pair is enough */
 	VkSemaphore rdGraphicSemaphore = VK_NULL_HANDLE;
 	VkSemaphore rdComputeSemaphore = VK_NULL_HANDLE;
-	VkFence rdRenderFence = VK_NULL_HANDLE;
-	VkFence rdComputeFence = VK_NULL_HANDLE;
 
 	VkDescriptorSetLayout rdAssimpDescriptorLayout = VK_NULL_HANDLE;
 	VkDescriptorSetLayout rdAssimpSkinningDescriptorLayout = VK_NULL_HANDLE;
+	VkDescriptorSetLayout rdAssimpSkinningBakedPerModelDescriptorLayout =
+			VK_NULL_HANDLE;
 	VkDescriptorSetLayout rdAssimpTextureDescriptorLayout = VK_NULL_HANDLE;
 	VkDescriptorSetLayout rdAssimpComputeTransformDescriptorLayout =
 			VK_NULL_HANDLE;
@@ -185,12 +447,32 @@ struct VkRenderData {
 			VK_NULL_HANDLE;
 	VkDescriptorSetLayout rdAssimpComputeMatrixMultPerModelDescriptorLayout =
 			VK_NULL_HANDLE;
+	VkDescriptorSetLayout rdAssimpComputeCullDescriptorLayout = VK_NULL_HANDLE;
+	VkDescriptorSetLayout rdAssimpComputeFusedDescriptorLayout = VK_NULL_HANDLE;
+	VkDescriptorSetLayout rdAssimpComputeAnimSampleDescriptorLayout =
+			VK_NULL_HANDLE;
 
 	VkDescriptorSet rdAssimpDescriptorSet = VK_NULL_HANDLE;
 	VkDescriptorSet rdAssimpSkinningDescriptorSet = VK_NULL_HANDLE;
 	VkDescriptorSet rdAssimpComputeTransformDescriptorSet = VK_NULL_HANDLE;
 	VkDescriptorSet rdAssimpComputeMatrixMultDescriptorSet = VK_NULL_HANDLE;
+	VkDescriptorSet rdAssimpComputeCullDescriptorSet = VK_NULL_HANDLE;
+	VkDescriptorSet rdAssimpComputeFusedDescriptorSet = VK_NULL_HANDLE;
+	VkDescriptorSet rdAssimpComputeAnimSampleDescriptorSet = VK_NULL_HANDLE;
+	/* same layouts as above, reading the poses sampled on the GPU */
+	VkDescriptorSet rdAssimpComputeTransformGpuPoseDescriptorSet =
+			VK_NULL_HANDLE;
+	VkDescriptorSet rdAssimpComputeFusedGpuPoseDescriptorSet = VK_NULL_HANDLE;
 
 	VkDescriptorPool rdDescriptorPool = VK_NULL_HANDLE;
 	VkDescriptorPool rdImguiDescriptorPool = VK_NULL_HANDLE;
+
+	/* shared staging memory for buffer and texture uploads */
+	VkUploadRingData rdUploadRing{};
+
+	/* vertices and indices of all models */
+	VkGeometryArenaData rdGeometryArena{};
+
+	/* textures of all models, uses rdAssimpTextureDescriptorLayout */
+	VkTextureTableData rdTextureTable{};
 };
@@ -1,13 +1,17 @@
 #version 460 core
+#extension GL_EXT_nonuniform_qualifier : require
+
 layout (location = 0) in vec4 color;
 layout (location = 1) in vec4 normal;
 layout (location = 2) in vec2 texCoord;
 layout (location = 3) flat in int selectInfo;
+layout (location = 4) flat in uint textureIndex;
 
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out int SelectedInstance;
 
-layout (set = 0, binding = 0) uniform sampler2D tex;
+/* textures of all models, selected by the draw data */
+layout (set = 0, binding = 0) uniform sampler2D textures[];
 
 vec3 lightPos = vec3(4.0, 3.0, 6.0);
 vec3 lightColor = vec3(1.0, 1.0, 1.0);
@@ -32,7 +36,7 @@ void main() {
 	float diff = max(dot(norm, lightDir), 0.0);
 	vec3 diffuse = diff * vec3(lightColor);
 
-	FragColor = vec4(ambient + diffuse, 1.0) * texture(tex, texCoord) * color;
+	FragColor = vec4(ambient + diffuse, 1.0) * texture(textures[nonuniformEXT(textureIndex)], texCoord) * color;
 	FragColor.rgb = sRGB(FragColor.rgb);
 
 	SelectedInstance = selectInfo;
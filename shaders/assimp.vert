@@ -9,11 +9,11 @@ layout (location = 0) out vec4 color;
 layout (location = 1) out vec4 normal;
 layout (location = 2) out vec2 texCoord;
 layout (location = 3) out int selectInfo;
+layout (location = 4) flat out uint textureIndex;
 
+/* first draw data entry of the multi draw, gl_DrawID counts from here */
 layout (push_constant) uniform Constants {
-	uint modelStride;
-	uint worldPosOffset;
-	uint skinMatrixOffset;
+	uint drawDataOffset;
 };
 
 layout (std140, set = 1, binding = 0) uniform Matrices {
@@ -29,13 +29,37 @@ layout (std430, set = 1, binding = 2) readonly restrict buffer InstanceSelected
 	vec2 selected[];
 };
 
+/* compacted list of the visible instances, written by the culling shader */
+layout (std430, set = 1, binding = 3) readonly restrict buffer VisibleInstances {
+	uint visibleIndex[];
+};
+
+/* model offsets and packed vertex data of every mesh */
+struct DrawData {
+	uint modelStride;
+	uint worldPosOffset;
+	uint skinMatrixOffset;
+	uint textureIndex;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 meshColor;
+};
+
+layout (std430, set = 1, binding = 4) readonly restrict buffer DrawDatas {
+	DrawData drawData[];
+};
+
 void main() {
-	mat4 modelMat = worldPosMat[gl_InstanceIndex + worldPosOffset];
+	DrawData draw = drawData[drawDataOffset + gl_DrawID];
+
+	uint instance = visibleIndex[gl_InstanceIndex + draw.worldPosOffset];
+
+	mat4 modelMat = worldPosMat[instance + draw.worldPosOffset];
 	gl_Position = projection * view * modelMat * vec4(aPos.x, aPos.y, aPos.z, 1.0);
 
-	color = aColor * selected[gl_InstanceIndex + worldPosOffset].x;
+	color = aColor * selected[instance + draw.worldPosOffset].x;
 	/* draw the instance always on top when highlighted, helps to find it better */
-	if (0.99f < selected[gl_InstanceIndex + worldPosOffset].x) {
+	if (0.99f < selected[instance + draw.worldPosOffset].x) {
 		gl_Position.z -= 1.0f;
 	}
 
@@ -43,5 +67,8 @@ void main() {
 	texCoord = vec2(aPos.w, aNormal.w);
 
 	/* instance id */
-	selectInfo = int(selected[gl_InstanceIndex + worldPosOffset].y);
+	selectInfo = int(selected[instance + draw.worldPosOffset].y);
+
+	/* entry in the texture table */
+	textureIndex = draw.textureIndex;
 }
@@ -0,0 +1,85 @@
+#version 460 core
+layout (location = 0) in vec4 aPos; // snorm inside the mesh bounds
+layout (location = 1) in vec2 aNormal; // octahedral encoded
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in uvec4 aBoneNum; // ignored
+layout (location = 4) in vec4 aBoneWeight; // ignored
+
+layout (location = 0) out vec4 color;
+layout (location = 1) out vec4 normal;
+layout (location = 2) out vec2 texCoord;
+layout (location = 3) out int selectInfo;
+layout (location = 4) flat out uint textureIndex;
+
+/* first draw data entry of the multi draw, gl_DrawID counts from here */
+layout (push_constant) uniform Constants {
+	uint drawDataOffset;
+};
+
+layout (std140, set = 1, binding = 0) uniform Matrices {
+	mat4 view;
+	mat4 projection;
+};
+
+layout (std430, set = 1, binding = 1) readonly buffer WorldPosMatrices {
+	mat4 worldPosMat[];
+};
+
+layout (std430, set = 1, binding = 2) readonly restrict buffer InstanceSelected {
+	vec2 selected[];
+};
+
+/* compacted list of the visible instances, written by the culling shader */
+layout (std430, set = 1, binding = 3) readonly restrict buffer VisibleInstances {
+	uint visibleIndex[];
+};
+
+/* model offsets and packed vertex data of every mesh */
+struct DrawData {
+	uint modelStride;
+	uint worldPosOffset;
+	uint skinMatrixOffset;
+	uint textureIndex;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 meshColor;
+};
+
+layout (std430, set = 1, binding = 4) readonly restrict buffer DrawDatas {
+	DrawData drawData[];
+};
+
+/* reverses the octahedral mapping done on the CPU */
+vec3 decodeOctNormal(vec2 e) {
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+void main() {
+	DrawData draw = drawData[drawDataOffset + gl_DrawID];
+
+	uint instance = visibleIndex[gl_InstanceIndex + draw.worldPosOffset];
+
+	vec3 position = aPos.xyz * draw.positionScale.xyz + draw.positionOffset.xyz;
+
+	mat4 modelMat = worldPosMat[instance + draw.worldPosOffset];
+	gl_Position = projection * view * modelMat * vec4(position, 1.0);
+
+	color = draw.meshColor * selected[instance + draw.worldPosOffset].x;
+	/* draw the instance always on top when highlighted, helps to find it better */
+	if (0.99f < selected[instance + draw.worldPosOffset].x) {
+		gl_Position.z -= 1.0f;
+	}
+
+	normal = transpose(inverse(modelMat)) * vec4(decodeOctNormal(aNormal), 1.0);
+	texCoord = aTexCoord;
+
+	/* instance id */
+	selectInfo = int(selected[instance + draw.worldPosOffset].y);
+
+	/* entry in the texture table */
+	textureIndex = draw.textureIndex;
+}
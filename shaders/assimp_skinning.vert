@@ -9,11 +9,11 @@ layout (location = 0) out vec4 color;
 layout (location = 1) out vec4 normal;
 layout (location = 2) out vec2 texCoord;
 layout (location = 3) out int selectInfo;
+layout (location = 4) flat out uint textureIndex;
 
+/* first draw data entry of the multi draw, gl_DrawID counts from here */
 layout (push_constant) uniform Constants {
-	uint modelStride;
-	uint worldPosOffset;
-	uint skinMatrixOffset;
+	uint drawDataOffset;
 };
 
 layout (std140, set = 1, binding = 0) uniform Matrices {
@@ -33,8 +33,40 @@ layout (std430, set = 1, binding = 3) readonly restrict buffer InstanceSelected
 	vec2 selected[];
 };
 
+/* compacted list of the visible instances, written by the culling shader */
+layout (std430, set = 1, binding = 4) readonly restrict buffer VisibleInstances {
+	uint visibleIndex[];
+};
+
+/* model offsets and packed vertex data of every mesh */
+struct DrawData {
+	uint modelStride;
+	uint worldPosOffset;
+	uint skinMatrixOffset;
+	uint textureIndex;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 meshColor;
+};
+
+layout (std430, set = 1, binding = 6) readonly restrict buffer DrawDatas {
+	DrawData drawData[];
+};
+
+/* inverse transpose up to a positive factor, enough for normals that are
+ * normalized in the fragment shader */
+mat3 getNormalMatrix(mat3 m) {
+	vec3 cross12 = cross(m[1], m[2]);
+	mat3 cofactor = mat3(cross12, cross(m[2], m[0]), cross(m[0], m[1]));
+	return cofactor * sign(dot(m[0], cross12));
+}
+
 void main() {
-	uint skinMatOffset = gl_InstanceIndex * modelStride + skinMatrixOffset;
+	DrawData draw = drawData[drawDataOffset + gl_DrawID];
+
+	uint instance = visibleIndex[gl_InstanceIndex + draw.worldPosOffset];
+
+	uint skinMatOffset = instance * draw.modelStride + draw.skinMatrixOffset;
 
 	mat4 skinMat =
 		aBoneWeight.x * boneMat[aBoneNum.x + skinMatOffset] +
@@ -42,18 +74,21 @@ void main() {
 		aBoneWeight.z * boneMat[aBoneNum.z + skinMatOffset] +
 		aBoneWeight.w * boneMat[aBoneNum.w + skinMatOffset];
 
-	mat4 worldPosSkinMat = worldPos[gl_InstanceIndex + worldPosOffset] * skinMat;
+	mat4 worldPosSkinMat = worldPos[instance + draw.worldPosOffset] * skinMat;
 	gl_Position = projection * view * worldPosSkinMat * vec4(aPos.x, aPos.y, aPos.z, 1.0);
 
-	color = aColor * selected[gl_InstanceIndex + worldPosOffset].x;
+	color = aColor * selected[instance + draw.worldPosOffset].x;
 	/* draw the instance always on top when highlighted, helps to find it better */
-	if (0.99f < selected[gl_InstanceIndex + worldPosOffset].x) {
+	if (0.99f < selected[instance + draw.worldPosOffset].x) {
 		gl_Position.z -= 1.0f;
 	}
 
-	normal = transpose(inverse(worldPosSkinMat)) * vec4(aNormal.x, aNormal.y, aNormal.z, 1.0);
+	normal = vec4(getNormalMatrix(mat3(worldPosSkinMat)) * aNormal.xyz, 0.0);
 	texCoord = vec2(aPos.w, aNormal.w);
 
 	/* instance id */
-	selectInfo = int(selected[gl_InstanceIndex + worldPosOffset].y);
+	selectInfo = int(selected[instance + draw.worldPosOffset].y);
+
+	/* entry in the texture table */
+	textureIndex = draw.textureIndex;
 }
@@ -0,0 +1,124 @@
+#version 460 core
+layout (location = 0) in vec4 aPos; // snorm inside the mesh bounds
+layout (location = 1) in vec2 aNormal; // octahedral encoded
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in uvec4 aBoneNum;
+layout (location = 4) in vec4 aBoneWeight;
+
+layout (location = 0) out vec4 color;
+layout (location = 1) out vec4 normal;
+layout (location = 2) out vec2 texCoord;
+layout (location = 3) out int selectInfo;
+layout (location = 4) flat out uint textureIndex;
+
+/* first draw data entry of the multi draw, gl_DrawID counts from here */
+layout (push_constant) uniform Constants {
+	uint drawDataOffset;
+};
+
+layout (std140, set = 1, binding = 0) uniform Matrices {
+	mat4 view;
+	mat4 projection;
+};
+
+/* two baked frames per instance, offsets count bone matrices */
+struct BakedInstanceData {
+	uint frameOffset;
+	uint nextFrameOffset;
+	float blend;
+	uint padding;
+};
+
+layout (std430, set = 1, binding = 2) readonly restrict buffer WorldPosMatrices {
+	mat4 worldPos[];
+};
+
+layout (std430, set = 1, binding = 3) readonly restrict buffer InstanceSelected {
+	vec2 selected[];
+};
+
+/* compacted list of the visible instances, written by the culling shader */
+layout (std430, set = 1, binding = 4) readonly restrict buffer VisibleInstances {
+	uint visibleIndex[];
+};
+
+layout (std430, set = 1, binding = 5) readonly restrict buffer BakedInstances {
+	BakedInstanceData bakedInstance[];
+};
+
+/* model offsets and packed vertex data of every mesh */
+struct DrawData {
+	uint modelStride;
+	uint worldPosOffset;
+	uint skinMatrixOffset;
+	uint textureIndex;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 meshColor;
+};
+
+layout (std430, set = 1, binding = 6) readonly restrict buffer DrawDatas {
+	DrawData drawData[];
+};
+
+/* all frames of all clips of the model, pre-multiplied with the bone offsets */
+layout (std430, set = 2, binding = 0) readonly restrict buffer BakedBoneMatrices {
+	mat4 bakedMat[];
+};
+
+mat4 getBakedBoneMatrix(uint bone, BakedInstanceData baked) {
+	return (1.0 - baked.blend) * bakedMat[baked.frameOffset + bone] +
+		baked.blend * bakedMat[baked.nextFrameOffset + bone];
+}
+
+/* inverse transpose up to a positive factor, enough for normals that are
+ * normalized in the fragment shader */
+mat3 getNormalMatrix(mat3 m) {
+	vec3 cross12 = cross(m[1], m[2]);
+	mat3 cofactor = mat3(cross12, cross(m[2], m[0]), cross(m[0], m[1]));
+	return cofactor * sign(dot(m[0], cross12));
+}
+
+/* reverses the octahedral mapping done on the CPU */
+vec3 decodeOctNormal(vec2 e) {
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+void main() {
+	DrawData draw = drawData[drawDataOffset + gl_DrawID];
+
+	vec3 position = aPos.xyz * draw.positionScale.xyz + draw.positionOffset.xyz;
+	vec3 vertexNormal = decodeOctNormal(aNormal);
+
+	uint instance = visibleIndex[gl_InstanceIndex + draw.worldPosOffset];
+
+	BakedInstanceData baked = bakedInstance[instance + draw.worldPosOffset];
+
+	mat4 skinMat =
+		aBoneWeight.x * getBakedBoneMatrix(aBoneNum.x, baked) +
+		aBoneWeight.y * getBakedBoneMatrix(aBoneNum.y, baked) +
+		aBoneWeight.z * getBakedBoneMatrix(aBoneNum.z, baked) +
+		aBoneWeight.w * getBakedBoneMatrix(aBoneNum.w, baked);
+
+	mat4 worldPosSkinMat = worldPos[instance + draw.worldPosOffset] * skinMat;
+	gl_Position = projection * view * worldPosSkinMat * vec4(position, 1.0);
+
+	color = draw.meshColor * selected[instance + draw.worldPosOffset].x;
+	/* draw the instance always on top when highlighted, helps to find it better */
+	if (0.99f < selected[instance + draw.worldPosOffset].x) {
+		gl_Position.z -= 1.0f;
+	}
+
+	normal = vec4(getNormalMatrix(mat3(worldPosSkinMat)) * vertexNormal, 0.0);
+	texCoord = aTexCoord;
+
+	/* instance id */
+	selectInfo = int(selected[instance + draw.worldPosOffset].y);
+
+	/* entry in the texture table */
+	textureIndex = draw.textureIndex;
+}
@@ -0,0 +1,132 @@
+#version 460 core
+layout (location = 0) in vec4 aPos; // last float is uv.x :)
+layout (location = 1) in vec4 aColor;
+layout (location = 2) in vec4 aNormal; // last float is uv.y
+layout (location = 3) in uvec4 aBoneNum;
+layout (location = 4) in vec4 aBoneWeight;
+
+layout (location = 0) out vec4 color;
+layout (location = 1) out vec4 normal;
+layout (location = 2) out vec2 texCoord;
+layout (location = 3) out int selectInfo;
+layout (location = 4) flat out uint textureIndex;
+
+/* first draw data entry of the multi draw, gl_DrawID counts from here */
+layout (push_constant) uniform Constants {
+	uint drawDataOffset;
+};
+
+layout (std140, set = 1, binding = 0) uniform Matrices {
+	mat4 view;
+	mat4 projection;
+};
+
+/* real and dual part of every bone, two vec4 per bone */
+layout (std430, set = 1, binding = 1) readonly restrict buffer BoneDualQuats {
+	vec4 boneDualQuat[];
+};
+
+layout (std430, set = 1, binding = 2) readonly restrict buffer WorldPosMatrices {
+	mat4 worldPos[];
+};
+
+layout (std430, set = 1, binding = 3) readonly restrict buffer InstanceSelected {
+	vec2 selected[];
+};
+
+/* compacted list of the visible instances, written by the culling shader */
+layout (std430, set = 1, binding = 4) readonly restrict buffer VisibleInstances {
+	uint visibleIndex[];
+};
+
+/* model offsets and packed vertex data of every mesh */
+struct DrawData {
+	uint modelStride;
+	uint worldPosOffset;
+	uint skinMatrixOffset;
+	uint textureIndex;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 meshColor;
+};
+
+layout (std430, set = 1, binding = 6) readonly restrict buffer DrawDatas {
+	DrawData drawData[];
+};
+
+/* inverse transpose up to a positive factor, enough for normals that are
+ * normalized in the fragment shader */
+mat3 getNormalMatrix(mat3 m) {
+	vec3 cross12 = cross(m[1], m[2]);
+	mat3 cofactor = mat3(cross12, cross(m[2], m[0]), cross(m[0], m[1]));
+	return cofactor * sign(dot(m[0], cross12));
+}
+
+vec3 rotateVector(vec4 q, vec3 v) {
+	return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+/* 2 * dual * conjugate(real) */
+vec3 getTranslation(vec4 real, vec4 dual) {
+	return 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+}
+
+void main() {
+	DrawData draw = drawData[drawDataOffset + gl_DrawID];
+
+	uint instance = visibleIndex[gl_InstanceIndex + draw.worldPosOffset];
+
+	/* for dual quaternion models the skin offset counts vec4, not mat4 */
+	uint dualQuatOffset = 2 * instance * draw.modelStride + draw.skinMatrixOffset;
+
+	vec4 real0 = boneDualQuat[dualQuatOffset + 2 * aBoneNum.x];
+	vec4 real1 = boneDualQuat[dualQuatOffset + 2 * aBoneNum.y];
+	vec4 real2 = boneDualQuat[dualQuatOffset + 2 * aBoneNum.z];
+	vec4 real3 = boneDualQuat[dualQuatOffset + 2 * aBoneNum.w];
+
+	/* q and -q are the same rotation, blend along the shorter way */
+	vec4 weights = aBoneWeight;
+	if (dot(real0, real1) < 0.0) {
+		weights.y = -weights.y;
+	}
+	if (dot(real0, real2) < 0.0) {
+		weights.z = -weights.z;
+	}
+	if (dot(real0, real3) < 0.0) {
+		weights.w = -weights.w;
+	}
+
+	vec4 real = weights.x * real0 + weights.y * real1 + weights.z * real2 +
+		weights.w * real3;
+	vec4 dual =
+		weights.x * boneDualQuat[dualQuatOffset + 2 * aBoneNum.x + 1] +
+		weights.y * boneDualQuat[dualQuatOffset + 2 * aBoneNum.y + 1] +
+		weights.z * boneDualQuat[dualQuatOffset + 2 * aBoneNum.z + 1] +
+		weights.w * boneDualQuat[dualQuatOffset + 2 * aBoneNum.w + 1];
+
+	float realLength = length(real);
+	real /= realLength;
+	dual /= realLength;
+
+	vec3 skinnedPos = rotateVector(real, aPos.xyz) + getTranslation(real, dual);
+
+	mat4 worldPosMat = worldPos[instance + draw.worldPosOffset];
+	gl_Position = projection * view * worldPosMat * vec4(skinnedPos, 1.0);
+
+	color = aColor * selected[instance + draw.worldPosOffset].x;
+	/* draw the instance always on top when highlighted, helps to find it better */
+	if (0.99f < selected[instance + draw.worldPosOffset].x) {
+		gl_Position.z -= 1.0f;
+	}
+
+	/* the skinning is rigid, rotating the normal is enough */
+	normal = vec4(getNormalMatrix(mat3(worldPosMat)) *
+		rotateVector(real, aNormal.xyz), 0.0);
+	texCoord = vec2(aPos.w, aNormal.w);
+
+	/* instance id */
+	selectInfo = int(selected[instance + draw.worldPosOffset].y);
+
+	/* entry in the texture table */
+	textureIndex = draw.textureIndex;
+}
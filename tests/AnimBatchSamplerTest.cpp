@@ -0,0 +1,146 @@
+// AnimBatchSamplerTest.cpp
+// Checks the SIMD batch pose sampler against the scalar clip sampling
+#include <assimp/anim.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AnimBatchSampler.h"
+#include "AssimpAnimClip.h"
+#include "AssimpBone.h"
+#include "Logger.h"
+#include "Timer.h"
+
+int main() {
+  constexpr unsigned int NUM_CHANNELS = 67;   // not a multiple of the lanes
+  constexpr unsigned int NUM_KEYS = 600;
+  constexpr unsigned int NUM_INSTANCES = 5000;
+  constexpr unsigned int NUM_FRAMES = 20;
+  constexpr float TICKS_PER_FRAME = 0.5f;
+  constexpr float TOLERANCE = 1.0e-3f;
+
+  Logger::setLogLevel(0);
+
+  // ===== Synthetic clip, all channels share the key times =====
+  aiAnimation animation;
+  animation.mName = aiString("batch_test");
+  animation.mDuration = NUM_KEYS - 1;
+  animation.mTicksPerSecond = 30.0;
+  animation.mNumChannels = NUM_CHANNELS;
+  animation.mChannels = new aiNodeAnim*[NUM_CHANNELS];
+
+  std::vector<std::shared_ptr<AssimpBone>> boneList;
+  for (unsigned int c = 0; c < NUM_CHANNELS; ++c) {
+    aiNodeAnim* nodeAnim = new aiNodeAnim();
+    std::string nodeName = "bone_" + std::to_string(c);
+    nodeAnim->mNodeName = aiString(nodeName);
+    nodeAnim->mNumPositionKeys = NUM_KEYS;
+    nodeAnim->mNumRotationKeys = NUM_KEYS;
+    nodeAnim->mNumScalingKeys = NUM_KEYS;
+    nodeAnim->mPositionKeys = new aiVectorKey[NUM_KEYS];
+    nodeAnim->mRotationKeys = new aiQuatKey[NUM_KEYS];
+    nodeAnim->mScalingKeys = new aiVectorKey[NUM_KEYS];
+
+    for (unsigned int k = 0; k < NUM_KEYS; ++k) {
+      const double t = static_cast<double>(k);
+      const float angle = static_cast<float>(k) * 0.07f + c;
+      nodeAnim->mPositionKeys[k] = aiVectorKey(
+          t, aiVector3D(std::sin(angle), 0.5f * c, std::cos(angle)));
+      // quaternion with a moving axis, sign flips every few keys
+      aiVector3D axis(std::sin(angle * 0.3f), std::cos(angle * 0.3f), 0.3f);
+      float len = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+      float halfAngle = 0.5f * angle;
+      float sign = (k / 7) % 2 ? -1.0f : 1.0f;
+      nodeAnim->mRotationKeys[k] = aiQuatKey(
+          t, aiQuaternion(sign * std::cos(halfAngle),
+                          sign * std::sin(halfAngle) * axis.x / len,
+                          sign * std::sin(halfAngle) * axis.y / len,
+                          sign * std::sin(halfAngle) * axis.z / len));
+      nodeAnim->mScalingKeys[k] =
+          aiVectorKey(t, aiVector3D(1.0f + 0.2f * std::sin(angle)));
+    }
+    animation.mChannels[c] = nodeAnim;
+
+    // reverse the bone order to exercise the scatter
+    boneList.emplace_back(std::make_shared<AssimpBone>(
+        NUM_CHANNELS - 1 - c, nodeName, glm::mat4(1.0f)));
+  }
+
+  AssimpAnimClip clip;
+  clip.addChannels(&animation, boneList);
+  if (!clip.hasPackedKeys()) {
+    std::cout << "FAILED: clip was not packed\n";
+    return 1;
+  }
+
+  // ===== Instances, scalar and batch results kept separately =====
+  std::vector<float> times(NUM_INSTANCES);
+  std::vector<AnimClipCursor> scalarCursors(NUM_INSTANCES);
+  std::vector<AnimClipCursor> batchCursors(NUM_INSTANCES);
+  std::vector<std::vector<NodeTransformData>> scalarPoses(
+      NUM_INSTANCES, std::vector<NodeTransformData>(NUM_CHANNELS));
+  std::vector<std::vector<NodeTransformData>> batchPoses(
+      NUM_INSTANCES, std::vector<NodeTransformData>(NUM_CHANNELS));
+
+  std::vector<AnimClipCursor*> cursorPtrs(NUM_INSTANCES);
+  std::vector<std::vector<NodeTransformData>*> posePtrs(NUM_INSTANCES);
+  for (unsigned int i = 0; i < NUM_INSTANCES; ++i) {
+    // include times before the first and exactly at the last key
+    times[i] = std::fmod(i * 13.37f, NUM_KEYS + 2.0f) - 1.0f;
+    cursorPtrs[i] = &batchCursors[i];
+    posePtrs[i] = &batchPoses[i];
+  }
+
+  float maxError = 0.0f;
+  float scalarTime = 0.0f;
+  float batchTime = 0.0f;
+  Timer timer;
+
+  auto compare = [&maxError](const glm::vec4& a, const glm::vec4& b) {
+    for (int i = 0; i < 4; ++i) {
+      maxError = std::max(maxError, std::fabs(a[i] - b[i]));
+    }
+  };
+
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    timer.start();
+    for (unsigned int i = 0; i < NUM_INSTANCES; ++i) {
+      clip.samplePose(times[i], scalarCursors[i], scalarPoses[i]);
+    }
+    scalarTime += timer.stop();
+
+    timer.start();
+    clip.samplePoses(times, cursorPtrs, posePtrs);
+    batchTime += timer.stop();
+
+    for (unsigned int i = 0; i < NUM_INSTANCES; ++i) {
+      for (unsigned int b = 0; b < NUM_CHANNELS; ++b) {
+        compare(scalarPoses[i][b].translation, batchPoses[i][b].translation);
+        compare(scalarPoses[i][b].scale, batchPoses[i][b].scale);
+        compare(scalarPoses[i][b].rotation, batchPoses[i][b].rotation);
+      }
+      times[i] = std::fmod(times[i] + TICKS_PER_FRAME, NUM_KEYS - 1.0f);
+    }
+  }
+
+  const bool passed = maxError <= TOLERANCE;
+
+  std::cout << "===== SIMD batch pose sampler test =====\n";
+  std::cout << "Instruction set: " << AnimBatchSampler::getInstructionSetName()
+            << " (" << AnimBatchSampler::getLaneCount() << " lanes)\n";
+  std::cout << "Channels: " << NUM_CHANNELS << ", keys: " << NUM_KEYS
+            << ", instances: " << NUM_INSTANCES << ", frames: " << NUM_FRAMES
+            << "\n\n";
+  std::cout << "Scalar sampling: " << scalarTime << " ms\n";
+  std::cout << "Batch sampling:  " << batchTime << " ms\n";
+  std::cout << "Speedup:         " << scalarTime / batchTime << "x\n";
+  std::cout << "Max abs error:   " << maxError << " (tolerance " << TOLERANCE
+            << ")\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "========================================\n";
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// AnimChannelCursorBenchmark.cpp
+// Compares keyframe lookups via binary search against the cached cursor
+#include <assimp/anim.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "AssimpAnimChannel.h"
+#include "Logger.h"
+#include "Timer.h"
+
+int main() {
+  constexpr unsigned int NUM_KEYS = 6000;    // ~200 seconds of 30 FPS mocap
+  constexpr unsigned int NUM_INSTANCES = 2000;
+  constexpr unsigned int NUM_FRAMES = 300;   // 5 seconds at 60 FPS
+  constexpr float TICKS_PER_FRAME = 30.0f / 60.0f;
+
+  Logger::setLogLevel(0);
+
+  // ===== Synthetic channel, keys for every type at the same times =====
+  aiNodeAnim nodeAnim;
+  nodeAnim.mNodeName = aiString("benchmark_bone");
+  nodeAnim.mNumPositionKeys = NUM_KEYS;
+  nodeAnim.mNumRotationKeys = NUM_KEYS;
+  nodeAnim.mNumScalingKeys = NUM_KEYS;
+  nodeAnim.mPositionKeys = new aiVectorKey[NUM_KEYS];
+  nodeAnim.mRotationKeys = new aiQuatKey[NUM_KEYS];
+  nodeAnim.mScalingKeys = new aiVectorKey[NUM_KEYS];
+  nodeAnim.mPreState = aiAnimBehaviour_CONSTANT;
+  nodeAnim.mPostState = aiAnimBehaviour_CONSTANT;
+
+  for (unsigned int i = 0; i < NUM_KEYS; ++i) {
+    const double t = static_cast<double>(i);
+    const float angle = static_cast<float>(i) * 0.05f;
+    nodeAnim.mPositionKeys[i] =
+        aiVectorKey(t, aiVector3D(std::sin(angle), std::cos(angle), 0.1f * angle));
+    nodeAnim.mRotationKeys[i] =
+        aiQuatKey(t, aiQuaternion(std::cos(angle * 0.5f), 0.0f,
+                                  std::sin(angle * 0.5f), 0.0f));
+    nodeAnim.mScalingKeys[i] = aiVectorKey(t, aiVector3D(1.0f));
+  }
+
+  AssimpAnimChannel channel;
+  channel.loadChannelData(&nodeAnim);
+  const float duration = channel.getMaxTime();
+
+  // ===== Every instance starts at a different play position =====
+  std::vector<float> startTimes(NUM_INSTANCES);
+  for (unsigned int i = 0; i < NUM_INSTANCES; ++i) {
+    startTimes[i] = std::fmod(i * 97.31f, duration);
+  }
+
+  auto run = [&](bool useCursor, double& checksum) {
+    std::vector<AnimChannelCursor> cursors(NUM_INSTANCES);
+    std::vector<float> times = startTimes;
+    checksum = 0.0;
+
+    Timer timer;
+    timer.start();
+    for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+      for (unsigned int i = 0; i < NUM_INSTANCES; ++i) {
+        times[i] = std::fmod(times[i] + TICKS_PER_FRAME, duration);
+        AnimChannelCursor* cursor = useCursor ? &cursors[i] : nullptr;
+        glm::vec4 t = channel.getTranslation(times[i], cursor);
+        glm::vec4 r = channel.getRotation(times[i], cursor);
+        glm::vec4 s = channel.getScaling(times[i], cursor);
+        checksum += t.x + t.y + t.z + r.x + r.y + r.z + r.w + s.x;
+      }
+    }
+    return timer.stop();
+  };
+
+  double searchChecksum = 0.0;
+  double cursorChecksum = 0.0;
+  // warm up caches once, then measure
+  run(false, searchChecksum);
+  const float searchTime = run(false, searchChecksum);
+  const float cursorTime = run(true, cursorChecksum);
+
+  const unsigned long long samples =
+      static_cast<unsigned long long>(NUM_FRAMES) * NUM_INSTANCES * 3;
+
+  std::cout << "===== AnimChannel keyframe lookup benchmark =====\n";
+  std::cout << "Keys: " << NUM_KEYS << ", instances: " << NUM_INSTANCES
+            << ", frames: " << NUM_FRAMES << " (" << samples
+            << " samples per run)\n\n";
+  std::cout << "Binary search: " << searchTime << " ms ("
+            << searchTime * 1.0e6 / samples << " ns/sample)\n";
+  std::cout << "Cursor:        " << cursorTime << " ms ("
+            << cursorTime * 1.0e6 / samples << " ns/sample)\n";
+  std::cout << "Speedup:       " << searchTime / cursorTime << "x\n";
+  std::cout << "Checksums:     " << searchChecksum << " / " << cursorChecksum
+            << (searchChecksum == cursorChecksum ? " (match)" : " (MISMATCH)")
+            << "\n";
+  std::cout << "=================================================\n";
+
+  return searchChecksum == cursorChecksum ? 0 : 1;
+}
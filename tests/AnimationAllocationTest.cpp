@@ -0,0 +1,216 @@
+// AnimationAllocationTest.cpp
+// Counts heap allocations in the per-frame animation update path, runs the
+// AnimPlayback::update step AssimpInstance::updateAnimation() uses
+#include <assimp/anim.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "AnimPlayback.h"
+#include "AssimpAnimClip.h"
+#include "AssimpBone.h"
+#include "AssimpNode.h"
+#include "Logger.h"
+
+// ===== Global allocation counter =====
+static std::atomic<unsigned long long> gAllocations{0};
+
+void* operator new(std::size_t size) {
+  ++gAllocations;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+static void* alignedAlloc(std::size_t size, std::size_t alignment) {
+#if defined(_WIN32)
+  return _aligned_malloc(size ? size : 1, alignment);
+#else
+  std::size_t alignedSize = (size + alignment - 1) / alignment * alignment;
+  return std::aligned_alloc(alignment, alignedSize ? alignedSize : alignment);
+#endif
+}
+
+static void alignedFree(void* p) {
+#if defined(_WIN32)
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  ++gAllocations;
+  if (void* p = alignedAlloc(size, static_cast<std::size_t>(align))) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return operator new(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  alignedFree(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+  alignedFree(p);
+}
+
+// ===== Synthetic clip, optionally with different key times per channel =====
+static std::shared_ptr<AssimpAnimClip> createClip(
+    const std::vector<std::shared_ptr<AssimpBone>>& boneList, unsigned int numKeys,
+    bool sharedKeyTimes) {
+  aiAnimation animation;
+  animation.mName = aiString(std::string(sharedKeyTimes ? "packed" : "channels"));
+  animation.mDuration = numKeys - 1;
+  animation.mTicksPerSecond = 30.0;
+  animation.mNumChannels = static_cast<unsigned int>(boneList.size());
+  animation.mChannels = new aiNodeAnim*[boneList.size()];
+
+  for (unsigned int c = 0; c < boneList.size(); ++c) {
+    // odd channels get half the rotation keys if key times differ
+    unsigned int numRotationKeys =
+        (!sharedKeyTimes && c % 2) ? numKeys / 2 + 1 : numKeys;
+    float rotationStep = static_cast<float>(numKeys - 1) / (numRotationKeys - 1);
+
+    aiNodeAnim* nodeAnim = new aiNodeAnim();
+    nodeAnim->mNodeName = aiString(boneList.at(c)->getBoneName());
+    nodeAnim->mNumPositionKeys = numKeys;
+    nodeAnim->mNumRotationKeys = numRotationKeys;
+    nodeAnim->mNumScalingKeys = numKeys;
+    nodeAnim->mPositionKeys = new aiVectorKey[numKeys];
+    nodeAnim->mRotationKeys = new aiQuatKey[numRotationKeys];
+    nodeAnim->mScalingKeys = new aiVectorKey[numKeys];
+
+    for (unsigned int k = 0; k < numKeys; ++k) {
+      float angle = k * 0.1f + c;
+      nodeAnim->mPositionKeys[k] =
+          aiVectorKey(k, aiVector3D(std::sin(angle), 0.0f, std::cos(angle)));
+      nodeAnim->mScalingKeys[k] = aiVectorKey(k, aiVector3D(1.0f));
+    }
+    for (unsigned int k = 0; k < numRotationKeys; ++k) {
+      float halfAngle = k * 0.05f + c;
+      nodeAnim->mRotationKeys[k] = aiQuatKey(
+          k * rotationStep,
+          aiQuaternion(std::cos(halfAngle), 0.0f, std::sin(halfAngle), 0.0f));
+    }
+    animation.mChannels[c] = nodeAnim;
+  }
+
+  std::shared_ptr<AssimpAnimClip> clip = std::make_shared<AssimpAnimClip>();
+  clip->addChannels(&animation, boneList);
+  return clip;
+}
+
+int main() {
+  constexpr unsigned int NUM_BONES = 60;
+  constexpr unsigned int NUM_KEYS = 240;
+  constexpr unsigned int NUM_INSTANCES = 200;
+  constexpr unsigned int NUM_FRAMES = 100;
+  constexpr float DELTA_TIME = 1.0f / 60.0f;
+
+  Logger::setLogLevel(0);
+
+  std::vector<std::shared_ptr<AssimpBone>> boneList;
+  std::shared_ptr<AssimpNode> rootNode = AssimpNode::createNode("root");
+  for (unsigned int i = 0; i < NUM_BONES; ++i) {
+    std::string boneName = "bone_" + std::to_string(i);
+    boneList.emplace_back(
+        std::make_shared<AssimpBone>(i, boneName, glm::mat4(1.0f)));
+    rootNode->addChild(boneName);
+  }
+
+  std::vector<std::shared_ptr<AssimpAnimClip>> animClips;
+  animClips.emplace_back(createClip(boneList, NUM_KEYS, true));
+  animClips.emplace_back(createClip(boneList, NUM_KEYS, false));
+
+  // ===== Animation members of AssimpInstance =====
+  struct InstanceState {
+    InstanceSettings settings{};
+    AnimPlaybackData playback{};
+    std::vector<NodeTransformData> nodeTransforms{};
+  };
+  std::vector<InstanceState> instances(NUM_INSTANCES);
+  for (unsigned int i = 0; i < NUM_INSTANCES; ++i) {
+    instances[i].settings.animClipNr = i % animClips.size();
+    instances[i].settings.animPlayTimePos = static_cast<float>(i % NUM_KEYS);
+    instances[i].nodeTransforms.resize(NUM_BONES);
+  }
+
+  auto updateAnimation = [&animClips](InstanceState& instance, float deltaTime) {
+    AnimPlayback::update(*animClips.at(instance.settings.animClipNr),
+                         instance.settings, instance.playback,
+                         instance.nodeTransforms, deltaTime);
+  };
+
+  // first frame may create the per-channel cursors
+  for (auto& instance : instances) {
+    updateAnimation(instance, DELTA_TIME);
+  }
+
+  unsigned long long before = gAllocations.load();
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    for (auto& instance : instances) {
+      updateAnimation(instance, DELTA_TIME);
+    }
+  }
+  unsigned long long updateAllocations = gAllocations.load() - before;
+
+  // accessors used while walking clips and the node tree
+  before = gAllocations.load();
+  size_t checksum = 0;
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    for (const auto& clip : animClips) {
+      for (const auto& channel : clip->getChannels()) {
+        checksum += channel->getTargetNodeName().size();
+      }
+      checksum += clip->getClipName().size();
+    }
+    for (const auto& child : rootNode->getChilds()) {
+      checksum += child->getNodeName().size();
+    }
+    for (const auto& bone : boneList) {
+      checksum += bone->getBoneName().size();
+    }
+  }
+  unsigned long long accessorAllocations = gAllocations.load() - before;
+
+  const unsigned long long numCalls =
+      static_cast<unsigned long long>(NUM_FRAMES) * NUM_INSTANCES;
+  const bool passed = updateAllocations == 0 && accessorAllocations == 0;
+
+  std::cout << "===== Animation update allocation test =====\n";
+  std::cout << "Packed clip: " << (animClips.at(0)->hasPackedKeys() ? "yes" : "no")
+            << ", channel clip: "
+            << (animClips.at(1)->hasPackedKeys() ? "yes" : "no") << "\n";
+  std::cout << "updateAnimation calls: " << numCalls
+            << ", allocations: " << updateAllocations << " ("
+            << static_cast<double>(updateAllocations) / numCalls
+            << " per call)\n";
+  std::cout << "Accessor allocations: " << accessorAllocations
+            << " (checksum " << checksum << ")\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "============================================\n";
+
+  return passed ? 0 : 1;
+}
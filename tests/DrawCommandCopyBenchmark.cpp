@@ -0,0 +1,242 @@
+// DrawCommandCopyBenchmark.cpp
+// Per frame CPU cost of filling the indirect commands and draw data of 500
+// meshes. The baseline mirrors the removed AssimpModel::writeDrawCommands
+// loop (texture index resolved on upload, arena offsets and mesh fields
+// read per frame), the other path copies the draw records. No vkCmd*
+// recording is involved, the renderer shows that as "Model Record Time"
+#include <assimp/material.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DrawRecord.h"
+#include "RangeAllocator.h"
+#include "Timer.h"
+
+// the parts of VkMesh the old draw loop read every frame
+struct LookupMesh {
+  std::unordered_map<aiTextureType, std::string> textures{};
+  std::vector<uint32_t> indices{};
+  bool usesPBRColors = false;
+  glm::vec4 packedPositionScale{1.0f};
+  glm::vec4 packedPositionOffset{0.0f};
+  glm::vec4 packedColor{1.0f};
+};
+
+// VkMeshRanges of the old model
+struct LookupRanges {
+  uint32_t vertexRange = RangeAllocator::kInvalidRange;
+  uint32_t indexRange = RangeAllocator::kInvalidRange;
+  bool packedVertices = false;
+};
+
+struct LookupArena {
+  RangeAllocator vertices{};
+  RangeAllocator packedVertices{};
+  RangeAllocator indices{};
+};
+
+struct LookupModel {
+  std::vector<LookupMesh> meshes{};
+  std::vector<LookupRanges> meshRanges{};
+  std::unordered_map<std::string, uint32_t> textureIndices{};
+  uint32_t whiteTextureIndex = 0;
+  uint32_t placeholderTextureIndex = 0;
+  // old mMeshTextureIndices, resolved on upload
+  std::vector<uint32_t> meshTextureIndices{};
+  std::vector<VkMeshDrawRecord> records{};
+};
+
+// old GeometryArena::getVertexOffset and getFirstIndex
+int32_t getVertexOffset(const LookupArena& arena, const LookupRanges& ranges) {
+  const RangeAllocator& vertexArena =
+      ranges.packedVertices ? arena.packedVertices : arena.vertices;
+  return static_cast<int32_t>(vertexArena.getOffset(ranges.vertexRange));
+}
+
+uint32_t getFirstIndex(const LookupArena& arena, const LookupRanges& ranges) {
+  return static_cast<uint32_t>(arena.indices.getOffset(ranges.indexRange));
+}
+
+uint32_t resolveTextureIndex(const LookupModel& model, const LookupMesh& mesh) {
+  uint32_t textureIndex = mesh.usesPBRColors ? model.whiteTextureIndex
+                                             : model.placeholderTextureIndex;
+  auto diffuseTexName = mesh.textures.find(aiTextureType_DIFFUSE);
+  if (diffuseTexName != mesh.textures.end()) {
+    auto diffuseTexture = model.textureIndices.find(diffuseTexName->second);
+    if (diffuseTexture != model.textureIndices.end()) {
+      textureIndex = diffuseTexture->second;
+    }
+  }
+  return textureIndex;
+}
+
+int main() {
+  constexpr unsigned int NUM_MODELS = 50;
+  constexpr unsigned int MESHES_PER_MODEL = 10;
+  constexpr unsigned int NUM_MESHES = NUM_MODELS * MESHES_PER_MODEL;
+  constexpr unsigned int NUM_FRAMES = 20000;
+
+  LookupArena arena;
+  arena.vertices.init(1 << 24);
+  arena.packedVertices.init(1 << 24);
+  arena.indices.init(1 << 26);
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<uint32_t> meshSize(100, 20000);
+  std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+
+  // ===== Models with named textures, meshes spread over the arena =====
+  uint32_t nextTableIndex = 0;
+  std::vector<LookupModel> models(NUM_MODELS);
+  for (unsigned int m = 0; m < NUM_MODELS; ++m) {
+    LookupModel& model = models[m];
+    model.whiteTextureIndex = nextTableIndex++;
+    model.placeholderTextureIndex = nextTableIndex++;
+
+    for (unsigned int i = 0; i < MESHES_PER_MODEL; ++i) {
+      LookupMesh mesh{};
+      std::string texName = "textures/model_" + std::to_string(m) +
+                            "_diffuse_" + std::to_string(i) + ".png";
+      // every fourth mesh has no texture of its own
+      if (i % 4 != 3) {
+        mesh.textures.insert({aiTextureType_DIFFUSE, texName});
+        mesh.textures.insert({aiTextureType_NORMALS, texName + ".normal"});
+        model.textureIndices.insert({texName, nextTableIndex++});
+      }
+      mesh.usesPBRColors = i % 2 == 0;
+      mesh.indices.resize(meshSize(rng) * 3);
+      mesh.packedPositionScale =
+          glm::vec4(value(rng), value(rng), value(rng), 1.0f);
+      mesh.packedPositionOffset =
+          glm::vec4(value(rng), value(rng), value(rng), 0.0f);
+      mesh.packedColor = glm::vec4(value(rng), value(rng), value(rng), 1.0f);
+      LookupRanges ranges{};
+      ranges.packedVertices = i % 3 == 0;
+      ranges.vertexRange =
+          (ranges.packedVertices ? arena.packedVertices : arena.vertices)
+              .allocate(meshSize(rng));
+      ranges.indexRange = arena.indices.allocate(mesh.indices.size());
+      model.meshes.emplace_back(mesh);
+      model.meshRanges.emplace_back(ranges);
+      model.meshTextureIndices.emplace_back(resolveTextureIndex(model, mesh));
+    }
+  }
+
+  // ===== Resolve the records once, as done on upload =====
+  Timer timer;
+  timer.start();
+  for (auto& model : models) {
+    for (unsigned int i = 0; i < model.meshes.size(); ++i) {
+      const LookupMesh& mesh = model.meshes[i];
+      VkMeshDrawRecord record{};
+      record.command.indexCount = static_cast<uint32_t>(mesh.indices.size());
+      record.command.firstIndex = getFirstIndex(arena, model.meshRanges[i]);
+      record.command.vertexOffset = getVertexOffset(arena, model.meshRanges[i]);
+      record.drawData.positionScale = mesh.packedPositionScale;
+      record.drawData.positionOffset = mesh.packedPositionOffset;
+      record.drawData.meshColor = mesh.packedColor;
+      record.drawData.textureIndex = resolveTextureIndex(model, mesh);
+      model.records.emplace_back(record);
+    }
+  }
+  float buildTime = timer.stop();
+
+  std::vector<VkDrawIndexedIndirectCommand> lookupCommands(NUM_MESHES);
+  std::vector<VkDrawData> lookupDrawData(NUM_MESHES);
+  std::vector<VkDrawIndexedIndirectCommand> recordCommands(NUM_MESHES);
+  std::vector<VkDrawData> recordDrawData(NUM_MESHES);
+
+  auto modelDrawData = [](unsigned int frame, unsigned int m) {
+    VkDrawData drawData{};
+    drawData.modelStride = m % 3 == 0 ? 0 : 60;
+    drawData.worldPosOffset = m * 20 + frame % 7;
+    drawData.skinMatOffset = m * 1200;
+    return drawData;
+  };
+
+  // ===== Old writeDrawCommands loop every frame =====
+  timer.start();
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    uint32_t firstCommand = 0;
+    for (unsigned int m = 0; m < NUM_MODELS; ++m) {
+      const LookupModel& model = models[m];
+      VkDrawData drawData = modelDrawData(frame, m);
+      for (unsigned int i = 0; i < model.meshes.size(); ++i) {
+        const LookupMesh& mesh = model.meshes.at(i);
+        VkDrawIndexedIndirectCommand& command =
+            lookupCommands.at(firstCommand + i);
+        command.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        command.instanceCount = 0;
+        command.firstIndex = getFirstIndex(arena, model.meshRanges.at(i));
+        command.vertexOffset = getVertexOffset(arena, model.meshRanges.at(i));
+        command.firstInstance = 0;
+
+        VkDrawData& meshDrawData = lookupDrawData.at(firstCommand + i);
+        meshDrawData = drawData;
+        meshDrawData.positionScale = mesh.packedPositionScale;
+        meshDrawData.positionOffset = mesh.packedPositionOffset;
+        meshDrawData.meshColor = mesh.packedColor;
+        meshDrawData.textureIndex = model.meshTextureIndices.at(i);
+      }
+      firstCommand += static_cast<uint32_t>(model.meshes.size());
+    }
+  }
+  float lookupTime = timer.stop();
+
+  // ===== Flat copy of the records every frame =====
+  timer.start();
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    uint32_t firstCommand = 0;
+    for (unsigned int m = 0; m < NUM_MODELS; ++m) {
+      DrawRecord::writeDrawCommands(models[m].records, modelDrawData(frame, m),
+                                    firstCommand, recordCommands,
+                                    recordDrawData);
+      firstCommand += static_cast<uint32_t>(models[m].records.size());
+    }
+  }
+  float recordTime = timer.stop();
+
+  // ===== Both paths must write the same commands and draw data =====
+  bool sameCommands = true;
+  bool sameDrawData = true;
+  for (unsigned int i = 0; i < NUM_MESHES; ++i) {
+    const VkDrawIndexedIndirectCommand& a = lookupCommands[i];
+    const VkDrawIndexedIndirectCommand& b = recordCommands[i];
+    if (a.indexCount != b.indexCount || a.instanceCount != b.instanceCount ||
+        a.firstIndex != b.firstIndex || a.vertexOffset != b.vertexOffset ||
+        a.firstInstance != b.firstInstance) {
+      sameCommands = false;
+    }
+    if (std::memcmp(&lookupDrawData[i], &recordDrawData[i],
+                    sizeof(VkDrawData)) != 0) {
+      sameDrawData = false;
+    }
+  }
+
+  const bool passed = sameCommands && sameDrawData;
+
+  std::cout << "===== Draw command copy benchmark =====\n";
+  std::cout << "Models: " << NUM_MODELS << ", meshes: " << NUM_MESHES
+            << ", frames: " << NUM_FRAMES << "\n\n";
+  std::cout << "Record build time:    " << buildTime << " ms (once)\n";
+  std::cout << "Old mesh loop:        " << lookupTime << " ms, "
+            << lookupTime * 1000.0f / NUM_FRAMES << " us per frame\n";
+  std::cout << "Record copy:          " << recordTime << " ms, "
+            << recordTime * 1000.0f / NUM_FRAMES << " us per frame\n";
+  std::cout << "Speedup:              "
+            << (recordTime > 0.0f ? lookupTime / recordTime : 0.0f) << "x\n";
+  std::cout << "Same commands:        " << (sameCommands ? "yes" : "no")
+            << "\n";
+  std::cout << "Same draw data:       " << (sameDrawData ? "yes" : "no")
+            << "\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "=======================================\n";
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// DualQuatSkinningTest.cpp
+// Compares dual quaternion skinning against the bone matrix palette
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "DualQuaternion.h"
+#include "Timer.h"
+
+int main() {
+  constexpr size_t NUM_BONES = 64;
+  constexpr size_t NUM_VERTICES = 200000;
+  constexpr unsigned int NUM_FRAMES = 20;
+
+  // ===== Rigid bone palette, rotation and translation only =====
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+  std::uniform_int_distribution<unsigned int> boneNr(0, NUM_BONES - 1);
+
+  std::vector<glm::mat4> boneMatrices(NUM_BONES);
+  std::vector<DualQuat> boneDualQuats(NUM_BONES);
+  for (size_t i = 0; i < NUM_BONES; ++i) {
+    glm::vec3 axis = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) +
+                                    glm::vec3(0.0f, 0.0f, 2.0f));
+    glm::vec3 translation = glm::vec3(unit(rng), unit(rng), unit(rng)) * 5.0f;
+    boneMatrices[i] = glm::rotate(glm::translate(glm::mat4(1.0f), translation),
+                                  angle(rng), axis);
+    boneDualQuats[i] = DualQuaternion::fromMatrix(boneMatrices[i]);
+  }
+
+  // ===== Vertices, a single bone each, both methods must agree =====
+  std::vector<glm::vec3> positions(NUM_VERTICES);
+  std::vector<glm::uvec4> boneNums(NUM_VERTICES);
+  std::vector<glm::vec4> boneWeights(NUM_VERTICES);
+  for (size_t i = 0; i < NUM_VERTICES; ++i) {
+    positions[i] = glm::vec3(unit(rng), unit(rng), unit(rng)) * 2.0f;
+    boneNums[i] = glm::uvec4(boneNr(rng), boneNr(rng), boneNr(rng),
+                             boneNr(rng));
+    boneWeights[i] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+  }
+
+  // ===== Matrix palette skinning =====
+  std::vector<glm::vec3> matrixResult(NUM_VERTICES);
+  float matrixTime = 0.0f;
+  Timer timer;
+
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    timer.start();
+    for (size_t i = 0; i < NUM_VERTICES; ++i) {
+      glm::mat4 skinMat =
+          boneWeights[i].x * boneMatrices[boneNums[i].x] +
+          boneWeights[i].y * boneMatrices[boneNums[i].y] +
+          boneWeights[i].z * boneMatrices[boneNums[i].z] +
+          boneWeights[i].w * boneMatrices[boneNums[i].w];
+      matrixResult[i] = glm::vec3(skinMat * glm::vec4(positions[i], 1.0f));
+    }
+    matrixTime += timer.stop();
+  }
+
+  // ===== Dual quaternion skinning =====
+  std::vector<glm::vec3> dualQuatResult(NUM_VERTICES);
+  float dualQuatTime = 0.0f;
+
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    timer.start();
+    for (size_t i = 0; i < NUM_VERTICES; ++i) {
+      DualQuat bones[4] = {boneDualQuats[boneNums[i].x],
+                           boneDualQuats[boneNums[i].y],
+                           boneDualQuats[boneNums[i].z],
+                           boneDualQuats[boneNums[i].w]};
+      DualQuat skinDq = DualQuaternion::blend(bones, boneWeights[i]);
+      dualQuatResult[i] = DualQuaternion::transformPoint(skinDq, positions[i]);
+    }
+    dualQuatTime += timer.stop();
+  }
+
+  float maxError = 0.0f;
+  for (size_t i = 0; i < NUM_VERTICES; ++i) {
+    maxError = std::max(maxError,
+                        glm::length(matrixResult[i] - dualQuatResult[i]));
+  }
+
+  // ===== Twist by 180 degrees, the matrix blend collapses the vertex =====
+  glm::vec3 twistPoint = glm::vec3(0.0f, 1.0f, 0.0f);
+  glm::vec4 twistWeights = glm::vec4(0.5f, 0.5f, 0.0f, 0.0f);
+  glm::mat4 twistMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(179.0f),
+                                      glm::vec3(1.0f, 0.0f, 0.0f));
+
+  glm::vec3 matrixTwist =
+      glm::vec3((twistWeights.x * glm::mat4(1.0f) +
+                 twistWeights.y * twistMatrix) * glm::vec4(twistPoint, 1.0f));
+
+  DualQuat twistBones[4] = {DualQuaternion::fromMatrix(glm::mat4(1.0f)),
+                            DualQuaternion::fromMatrix(twistMatrix),
+                            DualQuat(), DualQuat()};
+  glm::vec3 dualQuatTwist = DualQuaternion::transformPoint(
+      DualQuaternion::blend(twistBones, twistWeights), twistPoint);
+
+  float matrixTwistRadius = glm::length(matrixTwist);
+  float dualQuatTwistRadius = glm::length(dualQuatTwist);
+
+  const bool passed = maxError < 1e-3f &&
+                      std::abs(dualQuatTwistRadius - 1.0f) < 1e-3f &&
+                      matrixTwistRadius < 0.1f;
+
+  std::cout << "===== Dual quaternion skinning test =====\n";
+  std::cout << "Bones: " << NUM_BONES << ", vertices: " << NUM_VERTICES
+            << ", frames: " << NUM_FRAMES << "\n\n";
+  std::cout << "Palette size, matrix:          "
+            << NUM_BONES * sizeof(glm::mat4) << " bytes\n";
+  std::cout << "Palette size, dual quaternion: "
+            << NUM_BONES * 2 * sizeof(glm::vec4) << " bytes\n";
+  std::cout << "Max rigid error:               " << maxError << "\n";
+  std::cout << "Twist radius, matrix:          " << matrixTwistRadius << "\n";
+  std::cout << "Twist radius, dual quaternion: " << dualQuatTwistRadius
+            << "\n";
+  std::cout << "Skinning time, matrix:         " << matrixTime / NUM_FRAMES
+            << " ms per frame\n";
+  std::cout << "Skinning time, dual quaternion: " << dualQuatTime / NUM_FRAMES
+            << " ms per frame\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "=========================================\n";
+
+  return passed ? 0 : 1;
+}
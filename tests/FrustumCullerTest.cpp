@@ -0,0 +1,103 @@
+// FrustumCullerTest.cpp
+// Checks the SIMD sphere culling against a plain per-sphere plane test
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "FrustumCuller.h"
+#include "Timer.h"
+
+int main() {
+  constexpr size_t NUM_SPHERES = 100003;  // not a multiple of the lanes
+  constexpr unsigned int NUM_FRAMES = 50;
+
+  // ===== Camera looking down -z, depth range 0..1 =====
+  glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f,
+                                    500.0f);
+  glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 20.0f),
+                               glm::vec3(0.0f, 0.0f, 0.0f),
+                               glm::vec3(0.0f, 1.0f, 0.0f));
+
+  glm::vec4 planes[6];
+  FrustumCuller::extractPlanes(proj * view, planes);
+
+  // ===== Spheres scattered around and behind the camera =====
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> position(-600.0f, 600.0f);
+  std::uniform_real_distribution<float> size(0.1f, 10.0f);
+
+  std::vector<float> centerX(NUM_SPHERES);
+  std::vector<float> centerY(NUM_SPHERES);
+  std::vector<float> centerZ(NUM_SPHERES);
+  std::vector<float> radius(NUM_SPHERES);
+  for (size_t i = 0; i < NUM_SPHERES; ++i) {
+    centerX[i] = position(rng);
+    centerY[i] = position(rng) * 0.1f;
+    centerZ[i] = position(rng);
+    radius[i] = size(rng);
+  }
+
+  // ===== Reference result =====
+  std::vector<uint8_t> expected(NUM_SPHERES);
+  size_t expectedCount = 0;
+  for (size_t i = 0; i < NUM_SPHERES; ++i) {
+    glm::vec3 center(centerX[i], centerY[i], centerZ[i]);
+    bool inside = true;
+    for (const auto& plane : planes) {
+      if (glm::dot(glm::vec3(plane), center) + plane.w < -radius[i]) {
+        inside = false;
+      }
+    }
+    expected[i] = inside ? 1 : 0;
+    expectedCount += expected[i];
+  }
+
+  // ===== SIMD culling =====
+  std::vector<uint8_t> visible(NUM_SPHERES);
+  size_t visibleCount = 0;
+  float cullTime = 0.0f;
+  Timer timer;
+
+  for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+    timer.start();
+    visibleCount = FrustumCuller::cullSpheres(
+        planes, centerX.data(), centerY.data(), centerZ.data(), radius.data(),
+        visible.data(), NUM_SPHERES);
+    cullTime += timer.stop();
+  }
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < NUM_SPHERES; ++i) {
+    if (visible[i] != expected[i]) {
+      ++mismatches;
+    }
+  }
+
+  // a sphere at the camera target must always be visible
+  float targetX = 0.0f, targetY = 0.0f, targetZ = 0.0f, targetRadius = 1.0f;
+  uint8_t targetVisible = 0;
+  FrustumCuller::cullSpheres(planes, &targetX, &targetY, &targetZ,
+                             &targetRadius, &targetVisible, 1);
+
+  const bool passed = mismatches == 0 && visibleCount == expectedCount &&
+                      targetVisible == 1;
+
+  std::cout << "===== SIMD frustum culling test =====\n";
+  std::cout << "Instruction set: " << FrustumCuller::getInstructionSetName()
+            << "\n";
+  std::cout << "Spheres: " << NUM_SPHERES << ", frames: " << NUM_FRAMES
+            << "\n\n";
+  std::cout << "Visible:         " << visibleCount << " (expected "
+            << expectedCount << ")\n";
+  std::cout << "Mismatches:      " << mismatches << "\n";
+  std::cout << "Culling time:    " << cullTime / NUM_FRAMES
+            << " ms per frame\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "=====================================\n";
+
+  return passed ? 0 : 1;
+}
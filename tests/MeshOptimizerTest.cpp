@@ -0,0 +1,139 @@
+// MeshOptimizerTest.cpp
+// Welds and reorders a shuffled grid, checks the triangles and the ACMR
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "Timer.h"
+
+struct TestVertex {
+  float x;
+  float y;
+  float z;
+};
+
+int main() {
+  constexpr uint32_t GRID_SIZE = 200;
+  constexpr size_t NUM_GRID_VERTICES = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+
+  // ===== Unindexed grid, three own vertices per triangle =====
+  std::vector<std::array<uint32_t, 3>> gridTriangles{};
+  for (uint32_t y = 0; y < GRID_SIZE; ++y) {
+    for (uint32_t x = 0; x < GRID_SIZE; ++x) {
+      uint32_t corner = y * (GRID_SIZE + 1) + x;
+      gridTriangles.push_back({corner, corner + 1, corner + GRID_SIZE + 1});
+      gridTriangles.push_back(
+          {corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1});
+    }
+  }
+
+  // a shuffled triangle order is the worst case for the vertex cache
+  std::mt19937 rng(42);
+  std::shuffle(gridTriangles.begin(), gridTriangles.end(), rng);
+
+  std::vector<TestVertex> vertices{};
+  std::vector<uint32_t> indices{};
+  for (const auto& triangle : gridTriangles) {
+    for (const auto corner : triangle) {
+      indices.emplace_back(static_cast<uint32_t>(vertices.size()));
+      vertices.push_back({static_cast<float>(corner % (GRID_SIZE + 1)),
+                          static_cast<float>(corner / (GRID_SIZE + 1)), 0.0f});
+    }
+  }
+
+  Timer timer;
+  timer.start();
+
+  // ===== Welding =====
+  std::vector<uint32_t> remap{};
+  size_t weldedCount = MeshOptimizer::weldVertices(
+      vertices.data(), vertices.size(), sizeof(TestVertex), remap);
+
+  std::vector<TestVertex> weldedVertices(weldedCount);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    weldedVertices[remap[i]] = vertices[i];
+  }
+  for (auto& index : indices) {
+    index = remap[index];
+  }
+  float weldTime = timer.stop();
+
+  float acmrBefore = MeshOptimizer::calculateACMR(indices, weldedCount);
+
+  // ===== Triangle and vertex order =====
+  timer.start();
+  std::vector<uint32_t> optimizedIndices = indices;
+  MeshOptimizer::optimizeVertexCache(optimizedIndices, weldedCount);
+  float cacheTime = timer.stop();
+
+  float acmrAfter = MeshOptimizer::calculateACMR(optimizedIndices, weldedCount);
+
+  size_t usedCount = MeshOptimizer::optimizeVertexFetch(optimizedIndices,
+                                                        weldedCount, remap);
+  std::vector<TestVertex> fetchVertices(usedCount);
+  for (size_t i = 0; i < weldedCount; ++i) {
+    if (remap[i] != MeshOptimizer::kUnusedVertex) {
+      fetchVertices[remap[i]] = weldedVertices[i];
+    }
+  }
+  std::vector<uint32_t> fetchIndices = optimizedIndices;
+  for (auto& index : fetchIndices) {
+    index = remap[index];
+  }
+
+  // the vertices must appear in the order of first use
+  bool fetchOrdered = true;
+  uint32_t nextNewVertex = 0;
+  for (const auto index : fetchIndices) {
+    if (index > nextNewVertex) {
+      fetchOrdered = false;
+    } else if (index == nextNewVertex) {
+      ++nextNewVertex;
+    }
+  }
+
+  // ===== Same triangles, by position, in any order =====
+  auto sortedTriangles = [](const std::vector<TestVertex>& triangleVertices,
+                            const std::vector<uint32_t>& triangleIndices) {
+    std::vector<std::array<float, 9>> triangles{};
+    for (size_t i = 0; i < triangleIndices.size(); i += 3) {
+      std::array<float, 9> triangle{};
+      for (size_t corner = 0; corner < 3; ++corner) {
+        const TestVertex& vertex = triangleVertices[triangleIndices[i + corner]];
+        triangle[corner * 3] = vertex.x;
+        triangle[corner * 3 + 1] = vertex.y;
+        triangle[corner * 3 + 2] = vertex.z;
+      }
+      triangles.emplace_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  };
+  bool sameTriangles = sortedTriangles(weldedVertices, indices) ==
+                       sortedTriangles(fetchVertices, fetchIndices);
+
+  const bool passed = weldedCount == NUM_GRID_VERTICES &&
+                      usedCount == NUM_GRID_VERTICES && sameTriangles &&
+                      fetchOrdered && acmrAfter < acmrBefore * 0.5f &&
+                      acmrAfter < 1.0f;
+
+  std::cout << "===== Mesh optimizer test =====\n";
+  std::cout << "Triangles: " << gridTriangles.size() << ", cache size: "
+            << MeshOptimizer::kCacheSize << "\n\n";
+  std::cout << "Vertices:        " << vertices.size() << " -> " << weldedCount
+            << " (expected " << NUM_GRID_VERTICES << ")\n";
+  std::cout << "ACMR:            " << acmrBefore << " -> " << acmrAfter
+            << "\n";
+  std::cout << "Same triangles:  " << (sameTriangles ? "yes" : "no") << "\n";
+  std::cout << "Fetch ordered:   " << (fetchOrdered ? "yes" : "no") << "\n";
+  std::cout << "Weld time:       " << weldTime << " ms\n";
+  std::cout << "Reorder time:    " << cacheTime << " ms\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "===============================\n";
+
+  return passed ? 0 : 1;
+}
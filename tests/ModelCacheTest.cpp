@@ -0,0 +1,172 @@
+// ModelCacheTest.cpp
+// Writes an animation clip to a cache file, maps it back and compares the poses
+#include <assimp/anim.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssimpAnimClip.h"
+#include "AssimpBone.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "ModelCache.h"
+
+int main() {
+  constexpr unsigned int NUM_CHANNELS = 23;
+  constexpr unsigned int NUM_KEYS = 120;
+  const std::string CACHE_FILE = "ModelCacheTest.vkcache";
+
+  Logger::setLogLevel(0);
+
+  // ===== Synthetic clip, the last channel has its own key times =====
+  aiAnimation animation;
+  animation.mName = aiString("cache_test");
+  animation.mDuration = NUM_KEYS - 1;
+  animation.mTicksPerSecond = 24.0;
+  animation.mNumChannels = NUM_CHANNELS;
+  animation.mChannels = new aiNodeAnim*[NUM_CHANNELS];
+
+  std::vector<std::shared_ptr<AssimpBone>> boneList;
+  for (unsigned int c = 0; c < NUM_CHANNELS; ++c) {
+    const unsigned int numKeys = c == NUM_CHANNELS - 1 ? NUM_KEYS / 3 : NUM_KEYS;
+    const double keyStep = static_cast<double>(NUM_KEYS - 1) / (numKeys - 1);
+
+    aiNodeAnim* nodeAnim = new aiNodeAnim();
+    std::string nodeName = "bone_" + std::to_string(c);
+    nodeAnim->mNodeName = aiString(nodeName);
+    nodeAnim->mNumPositionKeys = numKeys;
+    nodeAnim->mNumRotationKeys = numKeys;
+    nodeAnim->mNumScalingKeys = numKeys;
+    nodeAnim->mPositionKeys = new aiVectorKey[numKeys];
+    nodeAnim->mRotationKeys = new aiQuatKey[numKeys];
+    nodeAnim->mScalingKeys = new aiVectorKey[numKeys];
+
+    for (unsigned int k = 0; k < numKeys; ++k) {
+      const double t = k * keyStep;
+      const float angle = static_cast<float>(t) * 0.11f + c;
+      nodeAnim->mPositionKeys[k] =
+          aiVectorKey(t, aiVector3D(std::sin(angle), 0.25f * c, std::cos(angle)));
+      nodeAnim->mRotationKeys[k] = aiQuatKey(
+          t, aiQuaternion(std::cos(angle * 0.5f), 0.0f, std::sin(angle * 0.5f), 0.0f));
+      nodeAnim->mScalingKeys[k] = aiVectorKey(t, aiVector3D(1.0f + 0.1f * std::sin(angle)));
+    }
+    animation.mChannels[c] = nodeAnim;
+
+    boneList.emplace_back(std::make_shared<AssimpBone>(c, nodeName, glm::mat4(1.0f)));
+  }
+
+  AssimpAnimClip clip;
+  clip.addChannels(&animation, boneList);
+
+  // ===== Write the clip behind a small header =====
+  ModelCacheWriter writer;
+  writer.write(ModelCache::kMagic);
+  writer.write(ModelCache::kVersion);
+  clip.saveToCache(writer);
+  if (!writer.saveToFile(CACHE_FILE)) {
+    std::cout << "FAILED: could not write " << CACHE_FILE << "\n";
+    return 1;
+  }
+
+  // ===== Map the file and read it back =====
+  MappedFile cacheFile;
+  if (!cacheFile.open(CACHE_FILE)) {
+    std::cout << "FAILED: could not map " << CACHE_FILE << "\n";
+    return 1;
+  }
+
+  ModelCacheReader reader(cacheFile.getData(), cacheFile.getSize());
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  AssimpAnimClip cachedClip;
+  if (!reader.read(magic) || !reader.read(version) ||
+      magic != ModelCache::kMagic || version != ModelCache::kVersion ||
+      !cachedClip.loadFromCache(reader)) {
+    std::cout << "FAILED: could not read the cached clip\n";
+    return 1;
+  }
+
+  bool passed = true;
+  if (cachedClip.getClipName() != clip.getClipName() ||
+      cachedClip.getClipDuration() != clip.getClipDuration() ||
+      cachedClip.getClipTicksPerSecond() != clip.getClipTicksPerSecond() ||
+      cachedClip.getChannels().size() != clip.getChannels().size() ||
+      cachedClip.hasPackedKeys() != clip.hasPackedKeys()) {
+    std::cout << "FAILED: clip properties differ\n";
+    passed = false;
+  }
+
+  // ===== Poses must be bit-identical =====
+  AnimClipCursor cursor;
+  AnimClipCursor cachedCursor;
+  std::vector<NodeTransformData> pose(NUM_CHANNELS);
+  std::vector<NodeTransformData> cachedPose(NUM_CHANNELS);
+  for (float time = 0.0f; time < clip.getClipDuration() && passed; time += 0.37f) {
+    clip.samplePose(time, cursor, pose);
+    cachedClip.samplePose(time, cachedCursor, cachedPose);
+    if (std::memcmp(pose.data(), cachedPose.data(),
+                    pose.size() * sizeof(NodeTransformData)) != 0) {
+      std::cout << "FAILED: poses differ at time " << time << "\n";
+      passed = false;
+    }
+  }
+
+  // ===== Truncated data must be rejected, not read out of bounds =====
+  for (size_t size = 0; size < cacheFile.getSize() && passed; size += 97) {
+    ModelCacheReader truncatedReader(cacheFile.getData(), size);
+    AssimpAnimClip truncatedClip;
+    if (truncatedReader.read(magic) && truncatedReader.read(version) &&
+        truncatedClip.loadFromCache(truncatedReader)) {
+      std::cout << "FAILED: truncated cache of " << size << " bytes was accepted\n";
+      passed = false;
+    }
+  }
+
+  // ===== Source info without reading the file =====
+  ModelSourceInfo sourceInfo;
+  if (passed && (!ModelCache::getSourceInfo(CACHE_FILE, sourceInfo) ||
+                 sourceInfo.size != cacheFile.getSize() || sourceInfo.hashed)) {
+    std::cout << "FAILED: wrong source info for " << CACHE_FILE << "\n";
+    passed = false;
+  }
+
+  cacheFile.close();
+  std::remove(CACHE_FILE.c_str());
+
+  // ===== Every byte of the words and the tail changes the hash =====
+  const std::string HASH_FILE = "ModelCacheTest.bin";
+  std::string hashData(8 * 5 + 3, 'a');
+  auto hashOf = [&HASH_FILE](const std::string& data, uint64_t& hash) {
+    std::ofstream(HASH_FILE, std::ios::binary) << data;
+    return ModelCache::hashFile(HASH_FILE, hash);
+  };
+  uint64_t baseHash = 0;
+  if (passed && !hashOf(hashData, baseHash)) {
+    std::cout << "FAILED: could not hash " << HASH_FILE << "\n";
+    passed = false;
+  }
+  for (size_t i = 0; i < hashData.size() && passed; ++i) {
+    std::string changedData = hashData;
+    changedData[i] = 'b';
+    uint64_t changedHash = 0;
+    if (!hashOf(changedData, changedHash) || changedHash == baseHash) {
+      std::cout << "FAILED: change of byte " << i << " kept the hash\n";
+      passed = false;
+    }
+  }
+  std::remove(HASH_FILE.c_str());
+
+  std::cout << "===== Model cache test =====\n";
+  std::cout << "Channels: " << NUM_CHANNELS << ", keys: " << NUM_KEYS
+            << ", packed: " << (clip.hasPackedKeys() ? "yes" : "no") << "\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "============================\n";
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// RangeAllocatorTest.cpp
+// Random allocations and frees, checks overlaps, merging and defragment()
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "RangeAllocator.h"
+#include "Timer.h"
+
+int main() {
+  constexpr uint64_t CAPACITY = 1 << 24;
+  constexpr unsigned int NUM_ROUNDS = 200000;
+  constexpr unsigned int NUM_INITIAL_RANGES = 6000;
+
+  RangeAllocator allocator;
+  allocator.init(CAPACITY);
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<uint64_t> rangeSize(0, 4096);
+  std::uniform_int_distribution<int> action(0, 1);
+
+  std::vector<uint32_t> handles{};
+  unsigned int failedAllocations = 0;
+
+  Timer timer;
+  timer.start();
+
+  // ===== Fill about three quarters, then random allocations and frees =====
+  for (unsigned int round = 0; round < NUM_INITIAL_RANGES + NUM_ROUNDS;
+       ++round) {
+    if (round < NUM_INITIAL_RANGES || action(rng) > 0 || handles.empty()) {
+      uint32_t handle = allocator.allocate(rangeSize(rng));
+      if (handle == RangeAllocator::kInvalidRange) {
+        ++failedAllocations;
+      } else {
+        handles.emplace_back(handle);
+      }
+    } else {
+      size_t index =
+          std::uniform_int_distribution<size_t>(0, handles.size() - 1)(rng);
+      allocator.free(handles.at(index));
+      handles.at(index) = handles.back();
+      handles.pop_back();
+    }
+  }
+  float allocTime = timer.stop();
+
+  // ===== No two ranges may overlap =====
+  auto rangesOverlap = [&]() {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges{};
+    for (const auto handle : handles) {
+      if (allocator.getSize(handle) > 0) {
+        ranges.push_back(
+            {allocator.getOffset(handle), allocator.getSize(handle)});
+      }
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); ++i) {
+      if (ranges[i - 1].first + ranges[i - 1].second > ranges[i].first) {
+        return true;
+      }
+    }
+    return !ranges.empty() &&
+           ranges.back().first + ranges.back().second > CAPACITY;
+  };
+  bool overlapBefore = rangesOverlap();
+
+  uint64_t usedSize = 0;
+  for (const auto handle : handles) {
+    usedSize += allocator.getSize(handle);
+  }
+  bool usedSizeMatches = usedSize == allocator.getUsedSize();
+  size_t freeBlocksBefore = allocator.getFreeBlockCount();
+
+  // ===== Defragment, every range keeps its contents =====
+  std::vector<uint32_t> memory(CAPACITY, RangeAllocator::kInvalidRange);
+  for (const auto handle : handles) {
+    std::fill_n(memory.begin() + allocator.getOffset(handle),
+                allocator.getSize(handle), handle);
+  }
+
+  timer.start();
+  std::vector<RangeMove> moves = allocator.defragment();
+  float defragTime = timer.stop();
+
+  std::vector<uint32_t> newMemory(CAPACITY, RangeAllocator::kInvalidRange);
+  for (const auto& move : moves) {
+    std::copy_n(memory.begin() + move.srcOffset, move.size,
+                newMemory.begin() + move.dstOffset);
+  }
+
+  bool contentsKept = true;
+  for (const auto handle : handles) {
+    uint64_t offset = allocator.getOffset(handle);
+    for (uint64_t i = 0; i < allocator.getSize(handle); ++i) {
+      if (newMemory[offset + i] != handle) {
+        contentsKept = false;
+      }
+    }
+  }
+
+  bool overlapAfter = rangesOverlap();
+  bool compacted = allocator.getFreeBlockCount() <= 1 &&
+                   allocator.getUsedEnd() == allocator.getUsedSize();
+
+  // ===== Shrink to the used size and grow again =====
+  bool shrinkBelowFails = !allocator.resize(allocator.getUsedSize() - 1);
+  bool resized = allocator.resize(allocator.getUsedSize()) &&
+                 allocator.getFreeBlockCount() == 0 &&
+                 allocator.resize(CAPACITY) &&
+                 allocator.getLargestFreeBlock() ==
+                     CAPACITY - allocator.getUsedSize();
+
+  // ===== Freeing everything merges back to a single block =====
+  for (const auto handle : handles) {
+    allocator.free(handle);
+  }
+  bool merged = allocator.getFreeBlockCount() == 1 &&
+                allocator.getLargestFreeBlock() == CAPACITY &&
+                allocator.getUsedSize() == 0;
+
+  const bool passed = !overlapBefore && !overlapAfter && usedSizeMatches &&
+                      contentsKept && compacted && shrinkBelowFails &&
+                      resized && merged;
+
+  std::cout << "===== Range allocator test =====\n";
+  std::cout << "Capacity: " << CAPACITY << ", rounds: " << NUM_ROUNDS
+            << "\n\n";
+  std::cout << "Live ranges:          " << handles.size() << "\n";
+  std::cout << "Failed allocations:   " << failedAllocations << "\n";
+  std::cout << "Used size:            " << usedSize << "\n";
+  std::cout << "Free blocks:          " << freeBlocksBefore << " -> "
+            << (compacted ? 1 : freeBlocksBefore) << "\n";
+  std::cout << "Overlaps:             " << (overlapBefore || overlapAfter ?
+                                            "yes" : "no") << "\n";
+  std::cout << "Contents kept:        " << (contentsKept ? "yes" : "no")
+            << "\n";
+  std::cout << "Resize:               " << (resized && shrinkBelowFails ?
+                                            "ok" : "failed") << "\n";
+  std::cout << "Merged after free:    " << (merged ? "yes" : "no") << "\n";
+  std::cout << "Alloc/free time:      " << allocTime << " ms\n";
+  std::cout << "Defragment time:      " << defragTime << " ms\n";
+  std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+  std::cout << "================================\n";
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#include "DrawRecord.h"
+
+void DrawRecord::writeDrawCommands(
+    const std::vector<VkMeshDrawRecord>& records,
+    const VkDrawData& modelDrawData, uint32_t firstCommand,
+    std::vector<VkDrawIndexedIndirectCommand>& commands,
+    std::vector<VkDrawData>& drawData) {
+  VkDrawIndexedIndirectCommand* command = commands.data() + firstCommand;
+  VkDrawData* meshDrawData = drawData.data() + firstCommand;
+
+  for (const auto& record : records) {
+    *command = record.command;
+    *meshDrawData = record.drawData;
+    meshDrawData->modelStride = modelDrawData.modelStride;
+    meshDrawData->worldPosOffset = modelDrawData.worldPosOffset;
+    meshDrawData->skinMatOffset = modelDrawData.skinMatOffset;
+    ++command;
+    ++meshDrawData;
+  }
+}
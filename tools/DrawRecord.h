@@ -0,0 +1,39 @@
+/* per mesh draw state resolved once on upload, the frame loop only copies
+ * the records into the indirect commands and the draw data */
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+/* one per indirect draw command, model offsets plus the mesh data */
+struct VkDrawData {
+  uint32_t modelStride = 0;
+  uint32_t worldPosOffset = 0;
+  uint32_t skinMatOffset = 0;
+  /* entry of the diffuse texture in the texture table */
+  uint32_t textureIndex = 0;
+  /* only read by the shaders for packed vertices */
+  glm::vec4 positionScale{1.0f};
+  glm::vec4 positionOffset{0.0f};
+  glm::vec4 meshColor{1.0f};
+};
+
+/* POD, the model fields of drawData and the instance count stay empty */
+struct VkMeshDrawRecord {
+  VkDrawIndexedIndirectCommand command{};
+  VkDrawData drawData{};
+};
+
+class DrawRecord {
+ public:
+  /* copies the records from firstCommand on and adds the model part of
+   * modelDrawData, the culling shader fills in the instance counts */
+  static void writeDrawCommands(
+      const std::vector<VkMeshDrawRecord>& records,
+      const VkDrawData& modelDrawData, uint32_t firstCommand,
+      std::vector<VkDrawIndexedIndirectCommand>& commands,
+      std::vector<VkDrawData>& drawData);
+};
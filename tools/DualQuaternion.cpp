@@ -0,0 +1,48 @@
+#include "DualQuaternion.h"
+
+DualQuat DualQuaternion::fromMatrix(const glm::mat4& matrix) {
+  glm::mat3 rotation = glm::mat3(glm::normalize(glm::vec3(matrix[0])),
+                                 glm::normalize(glm::vec3(matrix[1])),
+                                 glm::normalize(glm::vec3(matrix[2])));
+  glm::vec3 translation = glm::vec3(matrix[3]);
+
+  DualQuat dq;
+  dq.real = glm::normalize(glm::quat_cast(rotation));
+  /* dual = 0.5 * t * real, with t as pure quaternion */
+  dq.dual = 0.5f * glm::quat(0.0f, translation) * dq.real;
+  return dq;
+}
+
+DualQuat DualQuaternion::blend(const DualQuat bones[4],
+                               const glm::vec4& weights) {
+  DualQuat result;
+  result.real = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
+
+  for (int i = 0; i < 4; ++i) {
+    /* q and -q are the same rotation, blend along the shorter way */
+    float weight = weights[i];
+    if (glm::dot(bones[0].real, bones[i].real) < 0.0f) {
+      weight = -weight;
+    }
+    result.real += weight * bones[i].real;
+    result.dual += weight * bones[i].dual;
+  }
+
+  float realLength = glm::length(result.real);
+  result.real /= realLength;
+  result.dual /= realLength;
+  return result;
+}
+
+glm::vec3 DualQuaternion::transformPoint(const DualQuat& dq,
+                                         const glm::vec3& point) {
+  /* translation is 2 * dual * conjugate(real) */
+  glm::quat translation = 2.0f * dq.dual * glm::conjugate(dq.real);
+  return rotateVector(dq, point) +
+         glm::vec3(translation.x, translation.y, translation.z);
+}
+
+glm::vec3 DualQuaternion::rotateVector(const DualQuat& dq,
+                                       const glm::vec3& vector) {
+  return dq.real * vector;
+}
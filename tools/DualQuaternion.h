@@ -0,0 +1,22 @@
+/* rigid bone transforms as dual quaternions, CPU side of the skinning shader */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+struct DualQuat {
+  glm::quat real = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  glm::quat dual = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
+};
+
+class DualQuaternion {
+  public:
+    /* scale and shear of the matrix are dropped */
+    static DualQuat fromMatrix(const glm::mat4& matrix);
+
+    /* blends up to four bones, same as the vertex shader */
+    static DualQuat blend(const DualQuat bones[4], const glm::vec4& weights);
+
+    static glm::vec3 transformPoint(const DualQuat& dq, const glm::vec3& point);
+    static glm::vec3 rotateVector(const DualQuat& dq, const glm::vec3& vector);
+};
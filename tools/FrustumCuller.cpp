@@ -0,0 +1,133 @@
+#include "FrustumCuller.h"
+
+#include <bit>
+#include <glm/gtc/matrix_access.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CULL_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULL_SIMD_SSE2
+#endif
+
+namespace {
+  /* scalar version, also used for the remaining spheres */
+  size_t cullSpheresScalar(const glm::vec4 planes[6], const float* centerX,
+                           const float* centerY, const float* centerZ,
+                           const float* radius, uint8_t* visible,
+                           size_t start, size_t count) {
+    size_t visibleCount = 0;
+    for (size_t i = start; i < count; ++i) {
+      uint8_t inside = 1;
+      for (int p = 0; p < 6; ++p) {
+        float distance = planes[p].x * centerX[i] + planes[p].y * centerY[i] +
+                         planes[p].z * centerZ[i] + planes[p].w;
+        if (distance < -radius[i]) {
+          inside = 0;
+          break;
+        }
+      }
+      visible[i] = inside;
+      visibleCount += inside;
+    }
+    return visibleCount;
+  }
+}
+
+void FrustumCuller::extractPlanes(const glm::mat4& viewProj,
+                                  glm::vec4 planes[6]) {
+  /* Gribb/Hartmann, built from the rows of the view projection matrix */
+  glm::vec4 row0 = glm::row(viewProj, 0);
+  glm::vec4 row1 = glm::row(viewProj, 1);
+  glm::vec4 row2 = glm::row(viewProj, 2);
+  glm::vec4 row3 = glm::row(viewProj, 3);
+
+  planes[0] = row3 + row0; /* left */
+  planes[1] = row3 - row0; /* right */
+  planes[2] = row3 + row1; /* bottom */
+  planes[3] = row3 - row1; /* top */
+  planes[4] = row2;        /* near */
+  planes[5] = row3 - row2; /* far */
+
+  /* normalize to get real distances for the sphere test */
+  for (int i = 0; i < 6; ++i) {
+    planes[i] /= glm::length(glm::vec3(planes[i]));
+  }
+}
+
+size_t FrustumCuller::cullSpheres(const glm::vec4 planes[6],
+                                  const float* centerX, const float* centerY,
+                                  const float* centerZ, const float* radius,
+                                  uint8_t* visible, size_t count) {
+  size_t i = 0;
+  size_t visibleCount = 0;
+
+#if defined(CULL_SIMD_AVX2)
+  for (; i + 8 <= count; i += 8) {
+    __m256 cx = _mm256_loadu_ps(centerX + i);
+    __m256 cy = _mm256_loadu_ps(centerY + i);
+    __m256 cz = _mm256_loadu_ps(centerZ + i);
+    __m256 r = _mm256_loadu_ps(radius + i);
+
+    /* a sphere is visible if it is not completely behind any plane */
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int p = 0; p < 6; ++p) {
+      __m256 distance = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes[p].x), cx),
+                        _mm256_mul_ps(_mm256_set1_ps(planes[p].y), cy)),
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes[p].z), cz),
+                        _mm256_set1_ps(planes[p].w)));
+      inside = _mm256_and_ps(
+          inside, _mm256_cmp_ps(_mm256_add_ps(distance, r),
+                                _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+
+    unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(inside));
+    for (int lane = 0; lane < 8; ++lane) {
+      visible[i + lane] = (mask >> lane) & 1;
+    }
+    visibleCount += std::popcount(mask);
+  }
+#elif defined(CULL_SIMD_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    __m128 cx = _mm_loadu_ps(centerX + i);
+    __m128 cy = _mm_loadu_ps(centerY + i);
+    __m128 cz = _mm_loadu_ps(centerZ + i);
+    __m128 r = _mm_loadu_ps(radius + i);
+
+    /* a sphere is visible if it is not completely behind any plane */
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; ++p) {
+      __m128 distance = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), cx),
+                     _mm_mul_ps(_mm_set1_ps(planes[p].y), cy)),
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].z), cz),
+                     _mm_set1_ps(planes[p].w)));
+      inside = _mm_and_ps(
+          inside, _mm_cmpge_ps(_mm_add_ps(distance, r), _mm_setzero_ps()));
+    }
+
+    unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(inside));
+    for (int lane = 0; lane < 4; ++lane) {
+      visible[i + lane] = (mask >> lane) & 1;
+    }
+    visibleCount += std::popcount(mask);
+  }
+#endif
+
+  visibleCount += cullSpheresScalar(planes, centerX, centerY, centerZ, radius,
+                                    visible, i, count);
+  return visibleCount;
+}
+
+const char* FrustumCuller::getInstructionSetName() {
+#if defined(CULL_SIMD_AVX2)
+  return "AVX2";
+#elif defined(CULL_SIMD_SSE2)
+  return "SSE2";
+#else
+  return "Scalar";
+#endif
+}
@@ -0,0 +1,22 @@
+/* SIMD frustum tests for the bounding spheres of many instances */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class FrustumCuller {
+  public:
+    /* planes of a projection with 0..1 depth, normalized and facing inwards,
+     * order is left, right, bottom, top, near, far */
+    static void extractPlanes(const glm::mat4& viewProj, glm::vec4 planes[6]);
+
+    /* spheres are stored as four streams, visible[i] is set to 0 or 1,
+     * returns the number of visible spheres */
+    static size_t cullSpheres(const glm::vec4 planes[6], const float* centerX,
+                              const float* centerY, const float* centerZ,
+                              const float* radius, uint8_t* visible,
+                              size_t count);
+
+    static const char* getInstructionSetName();
+};
@@ -0,0 +1,166 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "Timer.h"
+
+JobSystem::~JobSystem() {
+  cleanup();
+}
+
+bool JobSystem::init(unsigned int numWorkers) {
+  cleanup();
+
+  if (numWorkers == 0) {
+    numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  mNumWorkers = numWorkers;
+  mWorkerTimes.assign(mNumWorkers, 0.0f);
+  for (unsigned int i = 0; i < mNumWorkers; ++i) {
+    mQueues.emplace_back(std::make_unique<WorkQueue>());
+  }
+
+  mShutdown = false;
+  for (unsigned int i = 1; i < mNumWorkers; ++i) {
+    mThreads.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+
+  Logger::log(1, "%s: job system started with %i workers\n", __FUNCTION__,
+              mNumWorkers);
+  return true;
+}
+
+void JobSystem::cleanup() {
+  if (mNumWorkers == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mWakeMutex);
+    mShutdown = true;
+  }
+  mWakeCondition.notify_all();
+
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+
+  mThreads.clear();
+  mQueues.clear();
+  mWorkerTimes.clear();
+  mNumWorkers = 0;
+}
+
+unsigned int JobSystem::getNumWorkers() {
+  return mNumWorkers;
+}
+
+const std::vector<float>& JobSystem::getWorkerTimes() {
+  return mWorkerTimes;
+}
+
+void JobSystem::parallelFor(size_t count, size_t chunkSize,
+                            const RangeFunc& func) {
+  std::fill(mWorkerTimes.begin(), mWorkerTimes.end(), 0.0f);
+  if (count == 0) {
+    return;
+  }
+
+  chunkSize = std::max(chunkSize, static_cast<size_t>(1));
+
+  /* no workers or a single chunk, skip the queues */
+  if (mNumWorkers < 2 || count <= chunkSize) {
+    Timer timer;
+    timer.start();
+    func(0, count, 0);
+    if (!mWorkerTimes.empty()) {
+      mWorkerTimes.at(0) = timer.stop();
+    }
+    return;
+  }
+
+  /* spread the chunks round-robin, the workers steal if they run dry */
+  size_t numChunks = (count + chunkSize - 1) / chunkSize;
+  mPendingJobs.store(numChunks, std::memory_order_release);
+
+  for (size_t i = 0; i < numChunks; ++i) {
+    Job job;
+    job.func = &func;
+    job.begin = i * chunkSize;
+    job.end = std::min(job.begin + chunkSize, count);
+
+    WorkQueue& queue = *mQueues.at(i % mNumWorkers);
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(job);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mWakeMutex);
+    ++mJobGeneration;
+  }
+  mWakeCondition.notify_all();
+
+  /* help out, then wait for the chunks still running on other workers */
+  runJobs(0);
+  while (mPendingJobs.load(std::memory_order_acquire) > 0) {
+    std::this_thread::yield();
+  }
+}
+
+void JobSystem::workerLoop(unsigned int workerIndex) {
+  uint64_t seenGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mWakeMutex);
+      mWakeCondition.wait(lock, [&]() {
+        return mShutdown || mJobGeneration != seenGeneration;
+      });
+      if (mShutdown) {
+        return;
+      }
+      seenGeneration = mJobGeneration;
+    }
+
+    runJobs(workerIndex);
+  }
+}
+
+void JobSystem::runJobs(unsigned int workerIndex) {
+  Timer timer;
+  Job job;
+  while (mPendingJobs.load(std::memory_order_acquire) > 0 &&
+         popJob(workerIndex, job)) {
+    timer.start();
+    (*job.func)(job.begin, job.end, workerIndex);
+    mWorkerTimes.at(workerIndex) += timer.stop();
+
+    mPendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+bool JobSystem::popJob(unsigned int workerIndex, Job& job) {
+  {
+    WorkQueue& ownQueue = *mQueues.at(workerIndex);
+    std::lock_guard<std::mutex> lock(ownQueue.mutex);
+    if (!ownQueue.jobs.empty()) {
+      job = ownQueue.jobs.back();
+      ownQueue.jobs.pop_back();
+      return true;
+    }
+  }
+
+  /* steal the oldest job of another worker */
+  for (unsigned int i = 1; i < mNumWorkers; ++i) {
+    WorkQueue& victim = *mQueues.at((workerIndex + i) % mNumWorkers);
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = victim.jobs.front();
+      victim.jobs.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
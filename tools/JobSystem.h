@@ -0,0 +1,62 @@
+/* small job system with work-stealing queues, one worker per core */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+  public:
+    /* called with the range [begin, end) and the index of the worker */
+    using RangeFunc = std::function<void(size_t, size_t, unsigned int)>;
+
+    ~JobSystem();
+
+    /* the calling thread is worker 0, so 'numWorkers - 1' threads are started,
+     * zero uses one worker per core */
+    bool init(unsigned int numWorkers = 0);
+    void cleanup();
+
+    unsigned int getNumWorkers();
+
+    /* splits [0, count) into chunks and blocks until all chunks are done */
+    void parallelFor(size_t count, size_t chunkSize, const RangeFunc& func);
+
+    /* milliseconds every worker spent running jobs of the last parallelFor */
+    const std::vector<float>& getWorkerTimes();
+
+  private:
+    struct Job {
+      const RangeFunc* func = nullptr;
+      size_t begin = 0;
+      size_t end = 0;
+    };
+
+    /* owner takes jobs from the back, thieves from the front */
+    struct WorkQueue {
+      std::mutex mutex;
+      std::deque<Job> jobs;
+    };
+
+    void workerLoop(unsigned int workerIndex);
+    void runJobs(unsigned int workerIndex);
+    bool popJob(unsigned int workerIndex, Job& job);
+
+    unsigned int mNumWorkers = 0;
+    std::vector<std::thread> mThreads{};
+    std::vector<std::unique_ptr<WorkQueue>> mQueues{};
+    std::vector<float> mWorkerTimes{};
+
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    uint64_t mJobGeneration = 0;
+    bool mShutdown = false;
+
+    std::atomic<size_t> mPendingJobs = 0;
+};
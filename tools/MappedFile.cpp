@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+#include "Logger.h"
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string& fileName) {
+  close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    Logger::log(1, "%s error: could not create mapping for file '%s'\n",
+                __FUNCTION__, fileName.c_str());
+    CloseHandle(file);
+    return false;
+  }
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!data) {
+    Logger::log(1, "%s error: could not map file '%s'\n", __FUNCTION__,
+                fileName.c_str());
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  mFileHandle = file;
+  mMappingHandle = mapping;
+  mData = static_cast<const char*>(data);
+  mSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    Logger::log(1, "%s error: could not map file '%s' (%s)\n", __FUNCTION__,
+                fileName.c_str(), strerror(errno));
+    ::close(fd);
+    return false;
+  }
+
+  /* we read the file front to back exactly once */
+  madvise(data, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+
+  mFileDescriptor = fd;
+  mData = static_cast<const char*>(data);
+  mSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+  return true;
+}
+
+void MappedFile::close() {
+  if (!mData) {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(mData);
+  CloseHandle(mMappingHandle);
+  CloseHandle(mFileHandle);
+  mMappingHandle = nullptr;
+  mFileHandle = nullptr;
+#else
+  munmap(const_cast<char*>(mData), mSize);
+  ::close(mFileDescriptor);
+  mFileDescriptor = -1;
+#endif
+
+  mData = nullptr;
+  mSize = 0;
+}
+
+bool MappedFile::isOpen() { return mData != nullptr; }
+
+const char* MappedFile::getData() { return mData; }
+
+size_t MappedFile::getSize() { return mSize; }
@@ -0,0 +1,28 @@
+/* read-only memory mapped file */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+  public:
+    ~MappedFile();
+
+    bool open(const std::string& fileName);
+    void close();
+
+    bool isOpen();
+    const char* getData();
+    size_t getSize();
+
+  private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+
+#ifdef _WIN32
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+#else
+    int mFileDescriptor = -1;
+#endif
+};
@@ -0,0 +1,185 @@
+#include "RangeAllocator.h"
+
+#include <algorithm>
+#include <iterator>
+
+void RangeAllocator::init(uint64_t capacity) {
+  mCapacity = capacity;
+  mUsedSize = 0;
+  mRanges.clear();
+  mFreeHandles.clear();
+  mFreeBlocks.clear();
+  mFreeBlocksBySize.clear();
+
+  if (capacity > 0) {
+    addFreeBlock(0, capacity);
+  }
+}
+
+uint32_t RangeAllocator::allocate(uint64_t size) {
+  Range range{};
+  range.size = size;
+  range.used = true;
+
+  /* empty ranges need no space, but still get a handle */
+  if (size > 0) {
+    /* smallest block that fits, keeps the large blocks for large meshes */
+    auto bySize = mFreeBlocksBySize.lower_bound({size, 0});
+    if (bySize == mFreeBlocksBySize.end()) {
+      return kInvalidRange;
+    }
+
+    range.offset = bySize->second;
+    uint64_t remaining = bySize->first - size;
+    removeFreeBlock(mFreeBlocks.find(range.offset));
+    if (remaining > 0) {
+      addFreeBlock(range.offset + size, remaining);
+    }
+    mUsedSize += size;
+  }
+
+  if (!mFreeHandles.empty()) {
+    uint32_t handle = mFreeHandles.back();
+    mFreeHandles.pop_back();
+    mRanges.at(handle) = range;
+    return handle;
+  }
+
+  mRanges.emplace_back(range);
+  return static_cast<uint32_t>(mRanges.size() - 1);
+}
+
+void RangeAllocator::free(uint32_t handle) {
+  if (handle >= mRanges.size() || !mRanges.at(handle).used) {
+    return;
+  }
+
+  Range& range = mRanges.at(handle);
+  uint64_t offset = range.offset;
+  uint64_t size = range.size;
+  range = Range{};
+  mFreeHandles.emplace_back(handle);
+
+  if (size == 0) {
+    return;
+  }
+  mUsedSize -= size;
+
+  /* merge with the free blocks right after and right before the range */
+  auto next = mFreeBlocks.lower_bound(offset);
+  if (next != mFreeBlocks.end() && next->first == offset + size) {
+    size += next->second;
+    next = removeFreeBlock(next);
+  }
+  if (next != mFreeBlocks.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      size += prev->second;
+      removeFreeBlock(prev);
+    }
+  }
+  addFreeBlock(offset, size);
+}
+
+uint64_t RangeAllocator::getOffset(uint32_t handle) const {
+  return mRanges.at(handle).offset;
+}
+
+uint64_t RangeAllocator::getSize(uint32_t handle) const {
+  return mRanges.at(handle).size;
+}
+
+std::vector<RangeMove> RangeAllocator::defragment() {
+  std::vector<uint32_t> handles{};
+  for (uint32_t i = 0; i < mRanges.size(); ++i) {
+    if (mRanges.at(i).used && mRanges.at(i).size > 0) {
+      handles.emplace_back(i);
+    }
+  }
+
+  /* keep the order, so a range only ever moves towards the front */
+  std::sort(handles.begin(), handles.end(), [this](uint32_t a, uint32_t b) {
+    return mRanges.at(a).offset < mRanges.at(b).offset;
+  });
+
+  std::vector<RangeMove> moves{};
+  uint64_t nextOffset = 0;
+  for (const auto handle : handles) {
+    Range& range = mRanges.at(handle);
+    RangeMove move{};
+    move.srcOffset = range.offset;
+    move.dstOffset = nextOffset;
+    move.size = range.size;
+    moves.emplace_back(move);
+
+    range.offset = nextOffset;
+    nextOffset += range.size;
+  }
+
+  mFreeBlocks.clear();
+  mFreeBlocksBySize.clear();
+  if (nextOffset < mCapacity) {
+    addFreeBlock(nextOffset, mCapacity - nextOffset);
+  }
+  return moves;
+}
+
+bool RangeAllocator::resize(uint64_t capacity) {
+  uint64_t usedEnd = getUsedEnd();
+  if (capacity < usedEnd) {
+    return false;
+  }
+
+  /* the block at the end is free if it reaches the old capacity */
+  uint64_t freeStart = mCapacity;
+  if (!mFreeBlocks.empty()) {
+    auto last = std::prev(mFreeBlocks.end());
+    if (last->first + last->second == mCapacity) {
+      freeStart = last->first;
+      removeFreeBlock(last);
+    }
+  }
+
+  if (capacity > freeStart) {
+    addFreeBlock(freeStart, capacity - freeStart);
+  }
+  mCapacity = capacity;
+  return true;
+}
+
+uint64_t RangeAllocator::getCapacity() const { return mCapacity; }
+
+uint64_t RangeAllocator::getUsedSize() const { return mUsedSize; }
+
+uint64_t RangeAllocator::getUsedEnd() const {
+  if (mFreeBlocks.empty()) {
+    return mUsedSize > 0 ? mCapacity : 0;
+  }
+
+  auto last = std::prev(mFreeBlocks.end());
+  if (last->first + last->second == mCapacity) {
+    return last->first;
+  }
+  return mCapacity;
+}
+
+size_t RangeAllocator::getFreeBlockCount() const { return mFreeBlocks.size(); }
+
+uint64_t RangeAllocator::getLargestFreeBlock() const {
+  if (mFreeBlocksBySize.empty()) {
+    return 0;
+  }
+  return mFreeBlocksBySize.rbegin()->first;
+}
+
+void RangeAllocator::addFreeBlock(uint64_t offset, uint64_t size) {
+  mFreeBlocks.insert({offset, size});
+  mFreeBlocksBySize.insert({size, offset});
+}
+
+std::map<uint64_t, uint64_t>::iterator RangeAllocator::removeFreeBlock(
+    std::map<uint64_t, uint64_t>::iterator block) {
+  mFreeBlocksBySize.erase({block->second, block->first});
+  return mFreeBlocks.erase(block);
+}
@@ -0,0 +1,69 @@
+/* best fit free list sub-allocator, hands out ranges of a larger buffer */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+/* the copy to make for a range that moved during defragment() */
+struct RangeMove {
+  uint64_t srcOffset = 0;
+  uint64_t dstOffset = 0;
+  uint64_t size = 0;
+};
+
+class RangeAllocator {
+ public:
+  static constexpr uint32_t kInvalidRange = 0xffffffff;
+
+  void init(uint64_t capacity);
+
+  /* returns the handle of the range, or kInvalidRange if no free block is
+   * large enough. the handle stays valid until free() */
+  uint32_t allocate(uint64_t size);
+  /* neighbouring free blocks are merged */
+  void free(uint32_t handle);
+
+  /* the offset changes with defragment(), read it again afterwards */
+  uint64_t getOffset(uint32_t handle) const;
+  uint64_t getSize(uint32_t handle) const;
+
+  /* moves all ranges to the front, in offset order. the returned moves
+   * never overlap their source if copied into a new buffer */
+  std::vector<RangeMove> defragment();
+  /* changes the free space at the end, fails if a range would be cut */
+  bool resize(uint64_t capacity);
+
+  uint64_t getCapacity() const;
+  uint64_t getUsedSize() const;
+  /* end of the last range, the minimum capacity for resize() */
+  uint64_t getUsedEnd() const;
+  size_t getFreeBlockCount() const;
+  uint64_t getLargestFreeBlock() const;
+
+ private:
+  struct Range {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    bool used = false;
+  };
+
+  uint64_t mCapacity = 0;
+  uint64_t mUsedSize = 0;
+
+  /* indexed by handle, unused entries are recycled */
+  std::vector<Range> mRanges{};
+  std::vector<uint32_t> mFreeHandles{};
+
+  /* offset to size of every free block, for merging neighbours */
+  std::map<uint64_t, uint64_t> mFreeBlocks{};
+  /* the same blocks as size and offset, for the allocation search */
+  std::set<std::pair<uint64_t, uint64_t>> mFreeBlocksBySize{};
+
+  void addFreeBlock(uint64_t offset, uint64_t size);
+  std::map<uint64_t, uint64_t>::iterator removeFreeBlock(
+      std::map<uint64_t, uint64_t>::iterator block);
+};